@@ -450,6 +450,28 @@ class Rime :
         @JvmStatic
         external fun simulateRimeKeySequence(keySequence: String): Boolean
 
+        // independent sessions, which may be driven from other threads
+        @JvmStatic
+        external fun createRimeSession(): Long
+
+        @JvmStatic
+        external fun destroyRimeSession(sessionId: Long): Boolean
+
+        @JvmStatic
+        external fun selectRimeSessionSchema(
+            sessionId: Long,
+            schemaId: String,
+        ): Boolean
+
+        @JvmStatic
+        external fun simulateRimeSessionKeySequence(
+            sessionId: Long,
+            keySequence: String,
+        ): Boolean
+
+        @JvmStatic
+        external fun getRimeSessionContext(sessionId: Long): ContextProto
+
         @JvmStatic
         external fun getRimeRawInput(): String
 
@@ -486,6 +508,16 @@ class Rime :
         @JvmStatic
         external fun getRimeBulkCandidates(): Array<Any>
 
+        // profiling of the engine stages, for all sessions
+        @JvmStatic
+        external fun setRimeTracing(
+            enabled: Boolean,
+            traceEventFile: String?,
+        ): Boolean
+
+        @JvmStatic
+        external fun getRimeTraceCounters(reset: Boolean): Array<TraceCounter>
+
         @JvmStatic
         fun handleRimeMessage(
             type: Int,
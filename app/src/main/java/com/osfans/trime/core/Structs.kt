@@ -9,6 +9,15 @@ data class SchemaItem(
     val name: String = "",
 )
 
+data class TraceCounter(
+    val name: String,
+    val count: Long,
+    val hits: Long,
+    val totalMicros: Double,
+    val selfMicros: Double,
+    val maxMicros: Double,
+)
+
 data class CandidateItem(
     val text: String,
     val comment: String = "",
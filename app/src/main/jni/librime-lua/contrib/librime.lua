@@ -15,15 +15,28 @@
 ---@field regex_match fun(input: string, pattern: string): boolean
 ---@field regex_search fun(input: string, pattern: string): string[] | nil
 ---@field regex_replace fun(input: string, pattern: string, fmt: string): string
+---@field get_gc_stats fun(engine: Engine): GcStats | nil
 rime_api = {}
 
+--- 会话中 Lua 垃圾回收的统计
+---@class GcStats
+---@field steps integer
+---@field completed_cycles integer
+---@field step_micros number
+---@field max_step_micros number
+---@field idle_collections integer
+---@field idle_micros number
+---@field full_collections integer
+---@field full_collection_micros number
+
 ---@class Log
 ---@field info fun(string)
 ---@field warning fun(string)
 ---@field error fun(string)
 log = {}
 
----@param cand Candidate
+--- 交出一个候选，或者一批候选（CandidateBatch 或候选数组）
+---@param cand Candidate | CandidateBatch | Candidate[]
 function yield(cand) end
 
 --- 常量
@@ -469,6 +482,8 @@ function Opencc(filename) end
 
 ---@class ReverseDb
 ---@field lookup fun(self: self, key: string): string
+---resolves a list of texts at once; texts not found map to ""
+---@field lookup_batch fun(self: self, keys: string[]): string[]
 
 ---@param file_name string
 ---@return ReverseDb
@@ -476,6 +491,7 @@ function ReverseDb(file_name) end
 
 ---@class ReverseLookup
 ---@field lookup fun(self: self, key: string): string
+---@field lookup_batch fun(self: self, keys: string[]): string[]
 ---@field lookup_stems fun(self: self, key: string): string
 
 ---@param dict_name string
@@ -510,9 +526,28 @@ function Code() end
 ---@class Translation
 ---@field exhausted boolean
 ---@field iter fun(self: self): fun(): Candidate|nil
+---@field pull fun(self: self, n: integer): CandidateBatch|nil
+---@field batches fun(self: self, n?: integer): fun(): CandidateBatch|nil
 
 function Translation() end
 
+--- 一批候选，按下标（从 1 开始）读取各候选的字段而不必逐个取出候选
+---@class CandidateBatch
+---@field size integer
+---@field get fun(self: self, i: integer): Candidate|nil
+---@field text fun(self: self, i: integer): string|nil
+---@field comment fun(self: self, i: integer): string|nil
+---@field preedit fun(self: self, i: integer): string|nil
+---@field type fun(self: self, i: integer): string|nil
+---@field quality fun(self: self, i: integer): number|nil
+---@field start fun(self: self, i: integer): integer|nil
+---@field _end fun(self: self, i: integer): integer|nil
+---@field drop fun(self: self, i: integer) 交出这批候选时略去第 i 个
+---@field push fun(self: self, cand: Candidate)
+
+---@return CandidateBatch
+function CandidateBatch() end
+
 ---@class Memory
 ---@field lang_name string
 ---@field dict Dictionary
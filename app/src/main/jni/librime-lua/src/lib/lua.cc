@@ -1,5 +1,11 @@
 #include "lua.h"
 #include "lua_templates.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <sys/stat.h>
 
 namespace LuaImpl {
   int wrap_common(lua_State *L, int (*cfunc)(lua_State *)) {
@@ -194,6 +200,53 @@ namespace LuaImpl {
     return lua_yield(L, lua_gettop(L));
   }
 
+  static bool file_readable(const char *path) {
+    FILE *fp = fopen(path, "r");
+    if (!fp)
+      return false;
+    fclose(fp);
+    return true;
+  }
+
+  // goes before the stock searcher of lua modules, and does the same but
+  // loads modules through the bytecode cache.
+  static int search_cached(lua_State *L) {
+    luaL_checkstring(L, 1);
+    lua_getglobal(L, "package");
+    lua_getfield(L, -1, "path");
+    const char *path = lua_tostring(L, -1);
+    if (!path)
+      return 0;
+    const char *name = luaL_gsub(L, lua_tostring(L, 1), ".", LUA_DIRSEP);
+    for (const char *p = path; *p; ) {
+      const char *e = strchr(p, ';');
+      if (!e)
+        e = p + strlen(p);
+      if (e > p) {
+        lua_pushlstring(L, p, e - p);
+        const char *filename = luaL_gsub(L, lua_tostring(L, -1), "?", name);
+        lua_remove(L, -2);
+        if (file_readable(filename)) {
+          if (Lua::loadfile(L, filename) != LUA_OK) {
+            return luaL_error(L, "error loading module '%s' from file '%s':"
+                              "\n\t%s", lua_tostring(L, 1), filename,
+                              lua_tostring(L, -1));
+          }
+          lua_insert(L, -2);
+          return 2;
+        }
+        lua_pop(L, 1);
+      }
+      p = *e ? e + 1 : e;
+    }
+    return 0;
+  }
+
+  static int write_chunk(lua_State *L, const void *p, size_t size, void *ud) {
+    static_cast<std::string *>(ud)->append((const char *) p, size);
+    return 0;
+  }
+
   static const char makeclosurekey = 'k';
   static const char luakey = 'k';
 
@@ -224,6 +277,7 @@ Lua::Lua() {
 
     lua_pushcfunction(L_, &LuaImpl::pmain);
     lua_call(L_, 0, 0);
+    set_gc_policy(gc_policy_);
   }
 }
 
@@ -266,6 +320,176 @@ std::shared_ptr<LuaObj> Lua::getglobal(const std::string &v) {
 
 void Lua::gc() {
   lua_gc(L_, LUA_GCCOLLECT, 0);
+  gc_kbytes_ = lua_gc(L_, LUA_GCCOUNT, 0);
+  gc_pending_ = false;
+}
+
+void Lua::set_gc_policy(const LuaGcPolicy &policy) {
+  gc_policy_ = policy;
+#if LUA_VERSION_NUM >= 504
+  if (policy.generational)
+    lua_gc(L_, LUA_GCGEN, 0, 0);
+  else
+    lua_gc(L_, LUA_GCINC, 0, 0, 0);
+#endif
+  gc_kbytes_ = lua_gc(L_, LUA_GCCOUNT, 0);
+}
+
+using Clock = std::chrono::steady_clock;
+
+static double micros_since(Clock::time_point start) {
+  return std::chrono::duration<double, std::micro>(Clock::now() - start)
+      .count();
+}
+
+void Lua::gc_step(LuaGcStats *stats) {
+  auto start = Clock::now();
+  if (gc_policy_.full_collection_per_translation) {
+    gc();
+    if (stats) {
+      ++stats->full_collections;
+      stats->full_collection_micros += micros_since(start);
+    }
+    return;
+  }
+  int kbytes = lua_gc(L_, LUA_GCCOUNT, 0);
+  int debt = (std::min)(kbytes - gc_kbytes_, gc_policy_.step_kbytes);
+  if (debt <= 0)
+    return;
+  bool completed = false;
+#if LUA_VERSION_NUM >= 504
+  if (gc_policy_.generational) {
+    // a minor collection, which only visits young objects.
+    lua_gc(L_, LUA_GCSTEP, 0);
+  } else
+#endif
+  {
+    // a step of n KB does as much work as allocating n KB would.
+    const auto deadline =
+        start + std::chrono::microseconds(gc_policy_.step_micros);
+    const int kStepKbytes = 16;
+    for (int done = 0; done < debt && !completed && Clock::now() < deadline;
+         done += kStepKbytes) {
+      completed = lua_gc(L_, LUA_GCSTEP, kStepKbytes) != 0;
+    }
+  }
+  gc_kbytes_ = lua_gc(L_, LUA_GCCOUNT, 0);
+  gc_pending_ = !completed;
+  if (stats) {
+    double elapsed = micros_since(start);
+    ++stats->steps;
+    stats->completed_cycles += completed;
+    stats->step_micros += elapsed;
+    stats->max_step_micros = (std::max)(stats->max_step_micros, elapsed);
+  }
+}
+
+void Lua::gc_idle(LuaGcStats *stats) {
+  if (gc_policy_.idle_micros <= 0 || !gc_pending_)
+    return;
+  auto start = Clock::now();
+  bool completed = false;
+#if LUA_VERSION_NUM >= 504
+  if (gc_policy_.generational) {
+    // major collections are left to the collector's own pace.
+    lua_gc(L_, LUA_GCSTEP, 0);
+    completed = true;
+  } else
+#endif
+  {
+    const auto deadline =
+        start + std::chrono::microseconds(gc_policy_.idle_micros);
+    const int kStepKbytes = 64;
+    while (!completed && Clock::now() < deadline) {
+      completed = lua_gc(L_, LUA_GCSTEP, kStepKbytes) != 0;
+    }
+  }
+  gc_kbytes_ = lua_gc(L_, LUA_GCCOUNT, 0);
+  gc_pending_ = !completed;
+  if (stats) {
+    ++stats->idle_collections;
+    stats->completed_cycles += completed;
+    stats->idle_micros += micros_since(start);
+  }
+}
+
+void Lua::set_bytecode_cache(const std::string &dir) {
+  const bool installed = !bytecode_cache_.empty();
+  bytecode_cache_ = dir;
+  if (installed || dir.empty())
+    return;
+  lua_getglobal(L_, "package");
+#if LUA_VERSION_NUM >= 502
+  lua_getfield(L_, -1, "searchers");
+#else
+  lua_getfield(L_, -1, "loaders");
+#endif
+  // the stock searcher of lua modules is the second one.
+  for (int i = lua_rawlen(L_, -1); i >= 2; --i) {
+    lua_rawgeti(L_, -1, i);
+    lua_rawseti(L_, -2, i + 1);
+  }
+  lua_pushcfunction(L_, LuaImpl::search_cached);
+  lua_rawseti(L_, -2, 2);
+  lua_pop(L_, 2);
+}
+
+int Lua::loadfile(lua_State *L, const std::string &path) {
+  Lua *lua = from_state(L);
+  struct stat st;
+  if (!lua || lua->bytecode_cache_.empty() || stat(path.c_str(), &st) != 0)
+    return luaL_loadfile(L, path.c_str());
+
+  // a cached chunk is valid for the same script, modification time and size,
+  // compiled by the same version of lua.
+  std::ostringstream key;
+  key << "rime-lua " << LUA_VERSION_NUM << ' ' << (long long) st.st_mtime
+      << ' ' << (long long) st.st_size << ' ' << path << '\n';
+  const std::string header = key.str();
+  std::ostringstream name;
+  name << lua->bytecode_cache_ << LUA_DIRSEP << "lua-" << std::hex
+       << std::hash<std::string>()(path) << ".luac";
+  const std::string cache_file = name.str();
+  const std::string chunkname = "@" + path;
+
+  std::ifstream in(cache_file, std::ios::binary | std::ios::ate);
+  if (in) {
+    std::string cached(size_t(in.tellg()), '\0');
+    in.seekg(0);
+    in.read(&cached[0], cached.size());
+    if (in && cached.compare(0, header.size(), header) == 0) {
+      if (luaL_loadbuffer(L, cached.data() + header.size(),
+                          cached.size() - header.size(),
+                          chunkname.c_str()) == LUA_OK)
+        return LUA_OK;
+      lua_pop(L, 1);  // a broken cache file; compile it again.
+    }
+  }
+
+  int status = luaL_loadfile(L, path.c_str());
+  if (status != LUA_OK)
+    return status;
+  std::string chunk = header;
+#if LUA_VERSION_NUM >= 503
+  lua_dump(L, LuaImpl::write_chunk, &chunk, 0);
+#else
+  lua_dump(L, LuaImpl::write_chunk, &chunk);
+#endif
+  // written aside and moved in place, so that other processes never load a
+  // partial file.
+  const std::string temp_file = cache_file + ".tmp";
+  bool written = false;
+  {
+    std::ofstream out(temp_file, std::ios::binary | std::ios::trunc);
+    written = out && out.write(chunk.data(), chunk.size());
+  }
+  if (written) {
+    std::remove(cache_file.c_str());
+    written = std::rename(temp_file.c_str(), cache_file.c_str()) == 0;
+  }
+  if (!written)
+    std::remove(temp_file.c_str());
+  return LUA_OK;
 }
 
 LuaObj::LuaObj(lua_State *L, int i) : L_(L) {
@@ -22,6 +22,34 @@ private:
 };
 
 struct LuaErr { int status; std::string e; };
+
+// how garbage is collected while translations come and go. set for the
+// shared lua state in default.yaml under lua/gc_policy, with the same field
+// names.
+struct LuaGcPolicy {
+  // switch to the generational collector where available (Lua 5.4).
+  bool generational = true;
+  // after each translation, run collector steps worth the memory allocated
+  // since the last step, capped at this many KB and microseconds.
+  int step_kbytes = 256;
+  int step_micros = 500;
+  // carry on with the collection once the composition is done, for up to
+  // this many microseconds; 0 disables.
+  int idle_micros = 10000;
+  // the former policy: a full collection after each translation.
+  bool full_collection_per_translation = false;
+};
+
+struct LuaGcStats {
+  size_t steps = 0;
+  size_t completed_cycles = 0;
+  double step_micros = 0;
+  double max_step_micros = 0;
+  size_t idle_collections = 0;
+  double idle_micros = 0;
+  size_t full_collections = 0;
+  double full_collection_micros = 0;
+};
 template <typename T>
 using LuaResult = Result<T, LuaErr>;
 
@@ -34,7 +62,22 @@ public:
 
   std::shared_ptr<LuaObj> newthreadx(lua_State *L, int nargs);
 
+  // a full collection.
   void gc();
+  // budgeted collection after a translation is done; see LuaGcPolicy.
+  void gc_step(LuaGcStats *stats = nullptr);
+  // continues the collection deferred by gc_step().
+  void gc_idle(LuaGcStats *stats = nullptr);
+
+  const LuaGcPolicy &gc_policy() const { return gc_policy_; }
+  void set_gc_policy(const LuaGcPolicy &policy);
+
+  // keeps the compiled chunks of scripts loaded by loadfile() or `require`
+  // in dir, and reuses them until the scripts change; empty disables it.
+  void set_bytecode_cache(const std::string &dir);
+  const std::string &bytecode_cache() const { return bytecode_cache_; }
+  // like luaL_loadfile(), through the bytecode cache of the state.
+  static int loadfile(lua_State *L, const std::string &path);
 
   template <typename ... I>
   std::shared_ptr<LuaObj> newthread(I ... input);
@@ -53,6 +96,11 @@ public:
   static Lua *from_state(lua_State *L);
 private:
   lua_State *L_;
+  LuaGcPolicy gc_policy_;
+  // memory in use (KB) when the collector last ran.
+  int gc_kbytes_ = 0;
+  bool gc_pending_ = false;
+  std::string bytecode_cache_;
 };
 
 namespace LuaImpl {
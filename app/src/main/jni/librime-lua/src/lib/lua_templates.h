@@ -387,7 +387,8 @@ struct LuaType<std::vector<T>> {
     int n = lua_rawlen(L, j);
     for (int i = 0; i < n; i++) {
       lua_rawgeti(L, j, i + 1);
-      o.push_back(LuaType<T>::todata(L, -1, C));
+      // an absolute index, as userdata look up their metatables on the stack.
+      o.push_back(LuaType<T>::todata(L, lua_gettop(L), C));
       lua_pop(L, 1);
     }
     return o;
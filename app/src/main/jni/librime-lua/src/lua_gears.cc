@@ -1,30 +1,152 @@
 #include "lib/lua_templates.h"
 #include "lua_gears.h"
+#include <rime/config.h>
+#include <rime/context.h>
+#include <rime/engine.h>
+#include <rime/schema.h>
+#include <map>
+#include <mutex>
 #include <vector>
 #include <sstream>
 
 namespace rime {
 
+// a translation coroutine yields either a candidate, a CandidateBatch or an
+// array of candidates.
+struct LuaYield {
+  an<Candidate> candidate;
+  an<CandidateBatch> batch;
+};
+
+}  // namespace rime
+
+template<>
+struct LuaType<rime::LuaYield> {
+  static bool is_batch(lua_State *L, int i) {
+    bool r = false;
+    if (lua_getmetatable(L, i)) {
+      lua_getfield(L, -1, "type");
+      auto ttype = (const LuaTypeInfo *) lua_touserdata(L, -1);
+      r = ttype && *ttype == *LuaType<rime::an<rime::CandidateBatch>>::type();
+      lua_pop(L, 2);
+    }
+    return r;
+  }
+
+  static rime::LuaYield todata(lua_State *L, int i, C_State *C) {
+    rime::LuaYield y;
+    if (lua_istable(L, i)) {
+      y.batch = rime::New<rime::CandidateBatch>(std::move(
+          LuaType<rime::vector<rime::an<rime::Candidate>>>::todata(L, i, C)));
+    } else if (is_batch(L, i)) {
+      y.batch = LuaType<rime::an<rime::CandidateBatch>>::todata(L, i, C);
+    } else {
+      y.candidate = LuaType<rime::an<rime::Candidate>>::todata(L, i, C);
+    }
+    return y;
+  }
+};
+
+namespace rime {
+
 //--- LuaTranslation
 bool LuaTranslation::Next() {
   if (exhausted()) {
     return false;
   }
-  auto r = lua_->resume<an<Candidate>>(f_);
-  if (!r.ok()) {
-    LuaErr e = r.get_err();
-    if (e.e != "")
-      LOG(ERROR) << "LuaTranslation::Next error(" << e.status << "): " << e.e;
-    set_exhausted(true);
-    return false;
-  } else {
-    c_ = r.get();
-    return true;
+  while (true) {
+    if (batch_) {
+      auto &items = batch_->items();
+      while (batch_pos_ < items.size()) {
+        if (auto c = items[batch_pos_++]) {
+          c_ = c;
+          return true;
+        }
+      }
+      batch_.reset();
+      batch_pos_ = 0;
+    }
+    auto r = lua_->resume<LuaYield>(f_);
+    if (!r.ok()) {
+      LuaErr e = r.get_err();
+      if (e.e != "")
+        LOG(ERROR) << "LuaTranslation::Next error(" << e.status << "): " << e.e;
+      set_exhausted(true);
+      return false;
+    }
+    auto y = r.get();
+    if (!y.batch) {
+      c_ = y.candidate;
+      return true;
+    }
+    batch_ = y.batch;
   }
 }
 
 LuaTranslation::~LuaTranslation() {
-  lua_->gc();
+  lua_->gc_step(gc_ ? gc_->stats() : nullptr);
+}
+
+//--- LuaGcScheduler
+// engines on different threads create and look up their schedulers.
+static std::mutex gc_schedulers_mutex;
+static std::map<Engine *, weak<LuaGcScheduler>> gc_schedulers;
+
+// lua/gc_policy of default.yaml; the lua state is shared by all sessions,
+// so is the policy, whichever schema they use. fields left out keep their
+// defaults.
+static LuaGcPolicy global_gc_policy() {
+  LuaGcPolicy policy;
+  auto *component = Config::Require("config");
+  the<Config> config(component ? component->Create("default") : nullptr);
+  if (!config)
+    return policy;
+  config->GetBool("lua/gc_policy/generational", &policy.generational);
+  config->GetInt("lua/gc_policy/step_kbytes", &policy.step_kbytes);
+  config->GetInt("lua/gc_policy/step_micros", &policy.step_micros);
+  config->GetInt("lua/gc_policy/idle_micros", &policy.idle_micros);
+  config->GetBool("lua/gc_policy/full_collection_per_translation",
+                  &policy.full_collection_per_translation);
+  return policy;
+}
+
+an<LuaGcScheduler> LuaGcScheduler::Require(const Ticket &ticket, Lua *lua) {
+  // read again as components are created, to pick up a redeployed config.
+  lua->set_gc_policy(global_gc_policy());
+  std::lock_guard<std::mutex> lock(gc_schedulers_mutex);
+  for (auto it = gc_schedulers.begin(); it != gc_schedulers.end(); ) {
+    if (it->second.expired())
+      it = gc_schedulers.erase(it);
+    else
+      ++it;
+  }
+  auto &weak = gc_schedulers[ticket.engine];
+  auto scheduler = weak.lock();
+  if (!scheduler) {
+    scheduler = New<LuaGcScheduler>(ticket.engine, lua);
+    weak = scheduler;
+  }
+  return scheduler;
+}
+
+an<LuaGcScheduler> LuaGcScheduler::Find(Engine *engine) {
+  std::lock_guard<std::mutex> lock(gc_schedulers_mutex);
+  auto found = gc_schedulers.find(engine);
+  return found != gc_schedulers.end() ? found->second.lock() : nullptr;
+}
+
+LuaGcScheduler::LuaGcScheduler(Engine *engine, Lua *lua) {
+  if (!engine)
+    return;
+  idle_connection_ = engine->context()->update_notifier().connect(
+      [this, lua](Context *ctx) {
+        if (!ctx->IsComposing())
+          lua->gc_idle(&stats_);
+      });
+}
+
+LuaGcScheduler::~LuaGcScheduler() {
+  idle_connection_.disconnect();
 }
 
 static std::vector<std::string> split_string(const std::string& str, const std::string& delimiter) {
@@ -140,7 +262,7 @@ static void raw_init(lua_State *L, const Ticket &t,
 
 //--- LuaFilter
 LuaFilter::LuaFilter(const Ticket& ticket, Lua* lua)
-  : Filter(ticket), TagMatching(ticket), lua_(lua) {
+  : Filter(ticket), TagMatching(ticket), lua_(lua), gc_(LuaGcScheduler::Require(ticket, lua)) {
   lua->to_state([&](lua_State *L) {raw_init(L, ticket, &env_, &func_, &fini_, &tags_match_);});
 }
 
@@ -148,7 +270,7 @@ an<Translation> LuaFilter::Apply(
   an<Translation> translation, CandidateList* candidates) {
   auto f = lua_->newthread<an<LuaObj>, an<Translation>,
                            an<LuaObj>, CandidateList *>(func_, translation, env_, candidates);
-  return New<LuaTranslation>(lua_, f);
+  return New<LuaTranslation>(lua_, f, gc_);
 }
 
 LuaFilter::~LuaFilter() {
@@ -163,7 +285,7 @@ LuaFilter::~LuaFilter() {
 
 //--- LuaTranslator
 LuaTranslator::LuaTranslator(const Ticket& ticket, Lua* lua)
-  : Translator(ticket), lua_(lua) {
+  : Translator(ticket), lua_(lua), gc_(LuaGcScheduler::Require(ticket, lua)) {
   lua->to_state([&](lua_State *L) {raw_init(L, ticket, &env_, &func_, &fini_);});
 }
 
@@ -171,7 +293,7 @@ an<Translation> LuaTranslator::Query(const string& input,
                                      const Segment& segment) {
   auto f = lua_->newthread<an<LuaObj>, const string &, const Segment &,
                            an<LuaObj>>(func_, input, segment, env_);
-  an<Translation> t = New<LuaTranslation>(lua_, f);
+  an<Translation> t = New<LuaTranslation>(lua_, f, gc_);
   if (t->exhausted())
     return an<Translation>();
   else
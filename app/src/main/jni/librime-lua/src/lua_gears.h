@@ -11,10 +11,53 @@
 
 namespace rime {
 
+// shared by the lua components of an engine; carries on with garbage
+// collection when its compositions are done, and keeps count.
+class LuaGcScheduler {
+public:
+  // also applies lua/gc_policy of default.yaml to the lua state.
+  static an<LuaGcScheduler> Require(const Ticket &ticket, Lua *lua);
+  static an<LuaGcScheduler> Find(Engine *engine);
+
+  LuaGcScheduler(Engine *engine, Lua *lua);
+  ~LuaGcScheduler();
+
+  LuaGcStats *stats() { return &stats_; }
+
+private:
+  LuaGcStats stats_;
+  connection idle_connection_;
+};
+
+// candidates passed between c++ and a lua script in one piece. scripts read
+// the fields of its items by index, which spares boxing every candidate.
+class CandidateBatch {
+public:
+  CandidateBatch() = default;
+  explicit CandidateBatch(vector<an<Candidate>> &&items)
+    : items_(std::move(items)) {}
+
+  // index starts from 1 as in lua; returns null for dropped items.
+  an<Candidate> at(int i) const {
+    return i >= 1 && size_t(i) <= items_.size() ? items_[i - 1] : nullptr;
+  }
+  void push_back(an<Candidate> c) { items_.push_back(c); }
+  // leaves the item out when the batch is yielded.
+  void drop(int i) {
+    if (i >= 1 && size_t(i) <= items_.size())
+      items_[i - 1].reset();
+  }
+  int size() const { return items_.size(); }
+  vector<an<Candidate>> &items() { return items_; }
+
+private:
+  vector<an<Candidate>> items_;
+};
+
 class LuaTranslation : public Translation {
 public:
-  LuaTranslation(Lua *lua, an<LuaObj> f)
-    : lua_(lua), f_(f) {
+  LuaTranslation(Lua *lua, an<LuaObj> f, an<LuaGcScheduler> gc = nullptr)
+    : lua_(lua), f_(f), gc_(gc) {
     Next();
   }
 
@@ -30,6 +73,10 @@ private:
   Lua *lua_;
   an<Candidate> c_;
   an<LuaObj> f_;
+  an<LuaGcScheduler> gc_;
+  // the rest of a batch yielded by the script.
+  an<CandidateBatch> batch_;
+  size_t batch_pos_ = 0;
 };
 
 class LuaFilter : public Filter, TagMatching {
@@ -60,6 +107,7 @@ private:
   an<LuaObj> func_;
   an<LuaObj> fini_;
   an<LuaObj> tags_match_;
+  an<LuaGcScheduler> gc_;
 };
 
 class LuaTranslator : public Translator {
@@ -75,6 +123,7 @@ private:
   an<LuaObj> env_;
   an<LuaObj> func_;
   an<LuaObj> fini_;
+  an<LuaGcScheduler> gc_;
 };
 
 class LuaSegmentor : public Segmentor {
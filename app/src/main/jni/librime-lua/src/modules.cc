@@ -29,6 +29,10 @@ struct COMPAT {
   static std::string get_user_data_dir() {
     return std::string(rime_get_api()->get_user_data_dir());
   }
+
+  static std::string get_staging_dir() {
+    return std::string(rime_get_api()->get_staging_dir());
+  }
 };
 
 template<typename T>
@@ -43,6 +47,11 @@ struct COMPAT<T, void_t<decltype(std::declval<T>().user_data_dir.string())>> {
     T &deployer = rime::Service::instance().deployer();
     return deployer.user_data_dir.string();
   }
+
+  static std::string get_staging_dir() {
+    T &deployer = rime::Service::instance().deployer();
+    return deployer.staging_dir.string();
+  }
 };
 }
 
@@ -66,19 +75,23 @@ static void lua_init(lua_State *L) {
   lua_setfield(L, -2, "path");
   lua_pop(L, 1);
 
+  // compiled scripts are kept next to the other build results.
+  Lua::from_state(L)->set_bytecode_cache(
+      COMPAT<rime::Deployer>::get_staging_dir());
+
   const auto user_file = user_dir + LUA_DIRSEP "rime.lua";
   const auto shared_file = shared_dir + LUA_DIRSEP "rime.lua";
 
   // use the user_file first
   // use the shared_file if the user_file doesn't exist
   if (file_exists(user_file.c_str())) {
-    if (luaL_dofile(L, user_file.c_str())) {
+    if (Lua::loadfile(L, user_file) || lua_pcall(L, 0, LUA_MULTRET, 0)) {
       const char *e = lua_tostring(L, -1);
       LOG(ERROR) << "rime.lua error: " << e;
       lua_pop(L, 1);
     }
   } else if (file_exists(shared_file.c_str())) {
-    if (luaL_dofile(L, shared_file.c_str())) {
+    if (Lua::loadfile(L, shared_file) || lua_pcall(L, 0, LUA_MULTRET, 0)) {
       const char *e = lua_tostring(L, -1);
       LOG(ERROR) << "rime.lua error: " << e;
       lua_pop(L, 1);
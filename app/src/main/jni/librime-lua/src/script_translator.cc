@@ -103,6 +103,7 @@ namespace ScriptTranslatorReg {
 
   bool T::update_entry(const DictEntry& entry,
       int commits, const string& new_entory_prefix) {
+    LoadDictionaries();
     if (user_dict_ && user_dict_->loaded())
       return user_dict_->UpdateEntry(entry, commits, new_entory_prefix);
 
@@ -112,6 +112,18 @@ namespace SegmentReg {
       t.status = T::kConfirmed;
   }
 
+  bool has_tag(T &t, const string &tag) {
+    return t.HasTag(tag);
+  }
+
+  set<string> get_tags(T &t) {
+    return set<string>(t.tags.begin(), t.tags.end());
+  }
+
+  void set_tags(T &t, set<string> tags) {
+    t.tags = TagSet(tags.begin(), tags.end());
+  }
+
   string active_text(T &t, const string &r) {
     return r.substr(t.start, t.end - t.start);
   }
@@ -135,7 +147,7 @@ namespace SegmentReg {
     { "clear", WRAPMEM(T::Clear) },
     { "close", WRAPMEM(T::Close) },
     { "reopen", WRAPMEM(T::Reopen) },
-    { "has_tag", WRAPMEM(T::HasTag) },
+    { "has_tag", WRAP(has_tag) },
     { "get_candidate_at", WRAPMEM(T::GetCandidateAt) },
     { "get_selected_candidate", WRAPMEM(T::GetSelectedCandidate) },
     { "active_text", WRAP(active_text) },
@@ -149,7 +161,7 @@ namespace SegmentReg {
     { "_start", WRAPMEM_GET(T::start) },
     { "_end", WRAPMEM_GET(T::end) }, // end is keyword in Lua...
     { "length", WRAPMEM_GET(T::length) },
-    { "tags", WRAPMEM_GET(T::tags) },
+    { "tags", WRAP(get_tags) },
     { "menu", WRAPMEM_GET(T::menu) },
     { "selected_index", WRAPMEM_GET(T::selected_index) },
     { "prompt", WRAPMEM_GET(T::prompt) },
@@ -162,7 +174,7 @@ namespace SegmentReg {
     { "_start", WRAPMEM_SET(T::start) },
     { "_end", WRAPMEM_SET(T::end) }, // end is keyword in Lua...
     { "length", WRAPMEM_SET(T::length) },
-    { "tags", WRAPMEM_SET(T::tags) },
+    { "tags", WRAP(set_tags) },
     { "menu", WRAPMEM_SET(T::menu) },
     { "selected_index", WRAPMEM_SET(T::selected_index) },
     { "prompt", WRAPMEM_SET(T::prompt) },
@@ -335,6 +347,86 @@ namespace CandidateReg {
   };
 }
 
+//--- wrappers for an<CandidateBatch>
+// read-only views of the candidates in a batch, indexed from 1.
+namespace CandidateBatchReg {
+  using T = CandidateBatch;
+
+  an<T> make() {
+    return New<T>();
+  }
+
+  optional<string> text(T &t, int i) {
+    if (auto c = t.at(i))
+      return c->text();
+    return {};
+  }
+
+  optional<string> comment(T &t, int i) {
+    if (auto c = t.at(i))
+      return c->comment();
+    return {};
+  }
+
+  optional<string> preedit(T &t, int i) {
+    if (auto c = t.at(i))
+      return c->preedit();
+    return {};
+  }
+
+  optional<string> type(T &t, int i) {
+    if (auto c = t.at(i))
+      return c->type();
+    return {};
+  }
+
+  optional<double> quality(T &t, int i) {
+    if (auto c = t.at(i))
+      return c->quality();
+    return {};
+  }
+
+  optional<int> start(T &t, int i) {
+    if (auto c = t.at(i))
+      return (int) c->start();
+    return {};
+  }
+
+  optional<int> end(T &t, int i) {
+    if (auto c = t.at(i))
+      return (int) c->end();
+    return {};
+  }
+
+  static const luaL_Reg funcs[] = {
+    { "CandidateBatch", WRAP(make) },
+    { NULL, NULL },
+  };
+
+  static const luaL_Reg methods[] = {
+    { "get", WRAPMEM(T, at) },
+    { "text", WRAP(text) },
+    { "comment", WRAP(comment) },
+    { "preedit", WRAP(preedit) },
+    { "type", WRAP(type) },
+    { "quality", WRAP(quality) },
+    { "start", WRAP(start) },
+    { "_end", WRAP(end) },
+    { "drop", WRAPMEM(T, drop) },
+    { "push", WRAPMEM(T, push_back) },
+    { NULL, NULL },
+  };
+
+  static const luaL_Reg vars_get[] = {
+    { "size", WRAPMEM(T, size) },
+    { NULL, NULL },
+  };
+
+  static const luaL_Reg vars_set[] = {
+    { NULL, NULL },
+  };
+}
+
 //--- wrappers for an<Translation>
 namespace TranslationReg {
   using T = Translation;
@@ -367,6 +459,34 @@ namespace TranslationReg {
     return 2;
   }
 
+  // takes up to n candidates off the translation in one call.
+  an<CandidateBatch> pull(T &t, int n) {
+    if (t.exhausted())
+      return {};
+
+    auto batch = New<CandidateBatch>();
+    for (int i = 0; i < n && !t.exhausted(); ++i) {
+      batch->push_back(t.Peek());
+      t.Next();
+    }
+    return batch;
+  }
+
+  int raw_batches_next(lua_State *L) {
+    lua_pushcfunction(L, WRAP(pull));
+    lua_pushvalue(L, 1);
+    lua_pushvalue(L, lua_upvalueindex(1));
+    lua_call(L, 2, 1);
+    return 1;
+  }
+
+  int raw_batches(lua_State *L) {
+    lua_pushinteger(L, luaL_optinteger(L, 2, 64));
+    lua_pushcclosure(L, raw_batches_next, 1);
+    lua_pushvalue(L, 1);
+    return 2;
+  }
+
   static const luaL_Reg funcs[] = {
     { "Translation", raw_make },
     { NULL, NULL },
@@ -374,6 +494,8 @@ namespace TranslationReg {
 
   static const luaL_Reg methods[] = {
     { "iter", raw_iter },
+    { "pull", WRAP(pull) },
+    { "batches", raw_batches },
     { NULL, NULL },
   };
 
@@ -404,6 +526,13 @@ namespace ReverseDbReg {
       return string("");
   }
 
+  // resolves a list of texts in one call; missing texts map to "".
+  vector<string> lookup_batch(T &db, const vector<string> &keys) {
+    vector<string> res;
+    db.Lookup(keys, &res);
+    return res;
+  }
+
   static const luaL_Reg funcs[] = {
     { "ReverseDb", WRAP(make) },
     { NULL, NULL },
@@ -411,6 +540,7 @@ namespace ReverseDbReg {
 
   static const luaL_Reg methods[] = {
     { "lookup", WRAP(lookup) },
+    { "lookup_batch", WRAP(lookup_batch) },
     { NULL, NULL },
   };
 
@@ -763,6 +893,14 @@ namespace ContextReg {
     return t.commit_history();
   }
 
+  void set_option(T &t, const string &name, bool value) {
+    t.set_option(name, value);
+  }
+
+  bool get_option(T &t, const string &name) {
+    return t.get_option(name);
+  }
+
   static const luaL_Reg funcs[] = {
     { NULL, NULL },
   };
@@ -790,8 +928,8 @@ namespace ContextReg {
     { "reopen_previous_segment", WRAPMEM(T::ReopenPreviousSegment) },
     { "clear_non_confirmed_composition", WRAPMEM(T::ClearNonConfirmedComposition) },
     { "refresh_non_confirmed_composition", WRAPMEM(T::RefreshNonConfirmedComposition) },
-    { "set_option", WRAPMEM(T::set_option) },
-    { "get_option", WRAPMEM(T::get_option) },
+    { "set_option", WRAP(set_option) },
+    { "get_option", WRAP(get_option) },
     { "set_property", WRAPMEM(T::set_property) },
     { "get_property", WRAPMEM(T::get_property) },
     { "clear_transient_options", WRAPMEM(T::ClearTransientOptions) },
@@ -1941,6 +2079,7 @@ namespace MemoryReg {
   bool LuaMemory::dictLookup(const string& input, const bool isExpand, size_t limit) {
     iter = New<DictEntryIterator>();// t= New<DictEntryIterator>();
     limit = limit == 0 ? 0xffffffffffffffff : limit;
+    LoadDictionaries();
     if (dict_ && dict_->loaded()) {
       return dict_->LookupWords(iter.get(), input, isExpand, limit) > 0;
     }
@@ -1949,6 +2088,7 @@ namespace MemoryReg {
 
   bool  LuaMemory::userLookup(const string& input, const bool isExpand) {
     uter = New<UserDictEntryIterator>();
+    LoadDictionaries();
     if (user_dict_ && user_dict_->loaded()) {
       return user_dict_->LookupWords(uter.get(), input, isExpand) > 0;
     }
@@ -1968,6 +2108,7 @@ namespace MemoryReg {
 
   bool LuaMemory::update_userdict(const DictEntry& entry, const int commits,
       const string& new_entry_prefix) {
+    LoadDictionaries();
     if (user_dict_ && user_dict_->loaded())
       return user_dict_->UpdateEntry(entry, commits, new_entry_prefix);
 
@@ -1977,6 +2118,7 @@ namespace MemoryReg {
   bool LuaMemory::update_entry(const DictEntry& entry, const int commits,
       const string& new_entry_prefix, const string& lang_name)
   {
+    LoadDictionaries();
     if (user_dict_ && user_dict_->loaded() && lang_name == language_->name())
       return user_dict_->UpdateEntry(entry, commits, new_entry_prefix);
 
@@ -1984,6 +2126,7 @@ namespace MemoryReg {
   }
 
   bool LuaMemory::update_candidate(const an<Candidate> cand, const int commits) {
+    LoadDictionaries();
     if (!user_dict_ || !user_dict_->loaded())
       return false;
 
@@ -2384,6 +2527,33 @@ namespace RimeApiReg {
     return boost::regex_replace(target, reg, fmt);
   }
 
+  // rime_api.get_gc_stats(env.engine): collector statistics of the session
+  int raw_get_gc_stats(lua_State *L) {
+    Engine *engine = LuaType<Engine *>::todata(L, 1);
+    auto gc = LuaGcScheduler::Find(engine);
+    if (!gc)
+      return 0;
+    const LuaGcStats *stats = gc->stats();
+    lua_createtable(L, 0, 8);
+    lua_pushinteger(L, stats->steps);
+    lua_setfield(L, -2, "steps");
+    lua_pushinteger(L, stats->completed_cycles);
+    lua_setfield(L, -2, "completed_cycles");
+    lua_pushnumber(L, stats->step_micros);
+    lua_setfield(L, -2, "step_micros");
+    lua_pushnumber(L, stats->max_step_micros);
+    lua_setfield(L, -2, "max_step_micros");
+    lua_pushinteger(L, stats->idle_collections);
+    lua_setfield(L, -2, "idle_collections");
+    lua_pushnumber(L, stats->idle_micros);
+    lua_setfield(L, -2, "idle_micros");
+    lua_pushinteger(L, stats->full_collections);
+    lua_setfield(L, -2, "full_collections");
+    lua_pushnumber(L, stats->full_collection_micros);
+    lua_setfield(L, -2, "full_collection_micros");
+    return 1;
+  }
+
   static const luaL_Reg funcs[]= {
     { "get_rime_version", WRAP(get_rime_version) },
     { "get_shared_data_dir", WRAP(COMPAT<Deployer>::get_shared_data_dir) },
@@ -2396,6 +2566,7 @@ namespace RimeApiReg {
     { "regex_match", WRAP(regex_match) },
     { "regex_search", WRAP(regex_search) },
     { "regex_replace", WRAP(regex_replace) },
+    { "get_gc_stats", raw_get_gc_stats },
     { NULL, NULL },
   };
 
@@ -2449,6 +2620,7 @@ void opencc_init(lua_State *L);
 void types_init(lua_State *L) {
   EXPORT(SegmentReg, L);
   EXPORT(CandidateReg, L);
+  EXPORT(CandidateBatchReg, L);
   EXPORT(TranslationReg, L);
   EXPORT(ReverseDbReg, L);
   EXPORT(SegmentationReg, L);
@@ -170,6 +170,12 @@ namespace ReverseLookupDictionaryReg {
     return ( db.ReverseLookup(key, &res) ) ? res : string("") ;
   }
 
+  vector<string> lookup_batch(T& db, const vector<string> &keys){
+    vector<string> res;
+    db.ReverseLookup(keys, &res);
+    return res;
+  }
+
   string lookup_stems(T& db, const string &key){
     string res;
     return ( db.LookupStems(key, &res) ) ? res : string("") ;
@@ -182,6 +188,7 @@ namespace ReverseLookupDictionaryReg {
 
   static const luaL_Reg methods[] = {
     {"lookup",WRAP(lookup)},
+    {"lookup_batch",WRAP(lookup_batch)},
     {"lookup_stems",WRAP(lookup_stems)},
     { NULL, NULL },
   };
@@ -0,0 +1,117 @@
+//
+// benchmarks garbage collection policies with a chain of lua filters.
+//
+// usage: bench_gc [keystrokes] [filters]
+//
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <rime/candidate.h>
+#include <rime/context.h>
+#include <rime/engine.h>
+#include <rime/schema.h>
+#include <rime/setup.h>
+#include <rime/translation.h>
+#include "lib/lua_templates.h"
+#include "lua_gears.h"
+
+void types_init(lua_State *L);
+
+using namespace rime;
+using std::chrono::duration;
+using std::chrono::steady_clock;
+
+// keeps a sizable heap alive, as scripts loading their own tables do,
+// and leaves some garbage behind for each candidate.
+static const char kFilterScript[] =
+    "dict = {}\n"
+    "for i = 1, 200000 do dict['k' .. i] = { i, tostring(i) } end\n"
+    "function bench_filter(input, env)\n"
+    "  for cand in input:iter() do\n"
+    "    local parts = {}\n"
+    "    for i = 1, 8 do parts[i] = cand.text .. i end\n"
+    "    cand.comment = table.concat(parts, ' ')\n"
+    "    yield(cand)\n"
+    "  end\n"
+    "end\n";
+
+static void run(const char *title, const LuaGcPolicy &policy,
+                int keystrokes, int num_filters) {
+  the<Engine> engine(Engine::Create());
+  Lua lua;
+  lua.to_state(types_init);
+  lua.to_state([](lua_State *L) {
+    if (luaL_dostring(L, kFilterScript))
+      std::cerr << lua_tostring(L, -1) << std::endl;
+  });
+  // the policy is set through the schema, as users do.
+  Schema schema("bench_gc", new Config);
+  Config *config = schema.config();
+  config->SetBool("lua/gc_policy/generational", policy.generational);
+  config->SetBool("lua/gc_policy/full_collection_per_translation",
+                  policy.full_collection_per_translation);
+
+  vector<the<LuaFilter>> filters;
+  for (int i = 0; i < num_filters; ++i) {
+    Ticket ticket(engine.get(), "bench_filter", "bench_filter");
+    ticket.schema = &schema;
+    filters.emplace_back(new LuaFilter(ticket, &lua));
+  }
+
+  vector<double> latencies;
+  for (int k = 0; k < keystrokes; ++k) {
+    auto start = steady_clock::now();
+    {
+      auto fifo = New<FifoTranslation>();
+      for (int i = 0; i < 30; ++i) {
+        fifo->Append(New<SimpleCandidate>("bench", 0, 1,
+                                          std::to_string(k * 31 + i)));
+      }
+      an<Translation> translation = fifo;
+      CandidateList candidates;
+      for (auto &filter : filters) {
+        translation = filter->Apply(translation, &candidates);
+      }
+      for (int i = 0; i < 10 && !translation->exhausted(); ++i) {
+        translation->Next();
+      }
+    }
+    latencies.push_back(
+        duration<double, std::micro>(steady_clock::now() - start).count());
+    // a commit every few keystrokes leaves the session idle.
+    if (k % 8 == 7) {
+      engine->context()->set_input("a");
+      engine->context()->Clear();
+    }
+  }
+  std::sort(latencies.begin(), latencies.end());
+  auto percentile = [&](double p) {
+    return latencies[size_t(p * (latencies.size() - 1))];
+  };
+  auto stats = LuaGcScheduler::Find(engine.get())->stats();
+  std::cout << title << ": p50 " << percentile(0.5) << " us, p95 "
+            << percentile(0.95) << " us, p99 " << percentile(0.99)
+            << " us; steps: " << stats->steps
+            << ", idle: " << stats->idle_collections << " ("
+            << stats->idle_micros << " us), full: "
+            << stats->full_collections << " ("
+            << stats->full_collection_micros << " us)" << std::endl;
+}
+
+int main(int argc, char *argv[]) {
+  const int keystrokes = argc > 1 ? std::stoi(argv[1]) : 1000;
+  const int num_filters = argc > 2 ? std::stoi(argv[2]) : 3;
+  LoadModules(kDefaultModules);
+
+  LuaGcPolicy full;
+  full.full_collection_per_translation = true;
+  run("full collection per translation", full, keystrokes, num_filters);
+
+  LuaGcPolicy incremental;
+  incremental.generational = false;
+  run("budgeted incremental", incremental, keystrokes, num_filters);
+
+  LuaGcPolicy generational;
+  run("generational", generational, keystrokes, num_filters);
+  return 0;
+}
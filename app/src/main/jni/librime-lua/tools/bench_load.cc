@@ -0,0 +1,82 @@
+//
+// measures loading a script with a big table of data, without the bytecode
+// cache, with a cache to fill and with a filled cache.
+//
+// usage: bench_load [entries] [rounds]
+//
+#include <chrono>
+#include <dirent.h>
+#include <stdlib.h>
+#include <dirent.h>
+#include <stdlib.h>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include "lib/lua_templates.h"
+
+using std::chrono::duration;
+using std::chrono::steady_clock;
+
+static double load(const std::string &dir, const std::string &cache) {
+  auto start = steady_clock::now();
+  {
+    Lua lua;
+    lua.to_state([&](lua_State *L) {
+      lua_getglobal(L, "package");
+      lua_pushstring(L, (dir + "/?.lua").c_str());
+      lua_setfield(L, -2, "path");
+      lua_pop(L, 1);
+    });
+    lua.set_bytecode_cache(cache);
+    lua.to_state([](lua_State *L) {
+      if (luaL_dostring(L, "assert(require('bench_dict').k1)"))
+        std::cerr << lua_tostring(L, -1) << std::endl;
+    });
+  }
+  return duration<double, std::milli>(steady_clock::now() - start).count();
+}
+
+int main(int argc, char *argv[]) {
+  const int entries = argc > 1 ? std::stoi(argv[1]) : 100000;
+  const int rounds = argc > 2 ? std::stoi(argv[2]) : 5;
+
+  char dir_template[] = "/tmp/bench_load.XXXXXX";
+  const char *dir = mkdtemp(dir_template);
+  if (!dir) {
+    std::cerr << "failed to create a temporary directory" << std::endl;
+    return 1;
+  }
+  const std::string script = std::string(dir) + "/bench_dict.lua";
+  {
+    std::ofstream out(script);
+    out << "return {\n";
+    for (int i = 1; i <= entries; ++i) {
+      out << "  k" << i << " = { " << i << ", 'v" << i << "', 0." << i
+          << " },\n";
+    }
+    out << "}\n";
+  }
+
+  double without_cache = 0, warm_cache = 0;
+  for (int i = 0; i < rounds; ++i) {
+    without_cache += load(dir, "");
+  }
+  const double cold_cache = load(dir, dir);
+  for (int i = 0; i < rounds; ++i) {
+    warm_cache += load(dir, dir);
+  }
+  std::cout << "without cache: " << without_cache / rounds << " ms"
+            << std::endl
+            << "filling the cache: " << cold_cache << " ms" << std::endl
+            << "with cache: " << warm_cache / rounds << " ms" << std::endl;
+
+  if (DIR *d = opendir(dir)) {
+    while (dirent *entry = readdir(d)) {
+      std::remove((std::string(dir) + "/" + entry->d_name).c_str());
+    }
+    closedir(d);
+  }
+  std::remove(dir);
+  return 0;
+}
@@ -0,0 +1,109 @@
+//
+// benchmarks the resume path of LuaTranslation with filters that take
+// candidates one at a time, and with filters that take them in batches.
+//
+// usage: bench_translation [keystrokes] [candidates] [filters]
+//
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <rime/candidate.h>
+#include <rime/engine.h>
+#include <rime/setup.h>
+#include <rime/translation.h>
+#include "lib/lua_templates.h"
+#include "lua_gears.h"
+
+void types_init(lua_State *L);
+
+using namespace rime;
+using std::chrono::duration;
+using std::chrono::steady_clock;
+
+// both filters drop candidates with long text and pass on the others.
+static const char kFilterScript[] =
+    "function single_filter(input, env)\n"
+    "  for cand in input:iter() do\n"
+    "    if #cand.text < 6 then yield(cand) end\n"
+    "  end\n"
+    "end\n"
+    "function batch_filter(input, env)\n"
+    "  for batch in input:batches(64) do\n"
+    "    for i = 1, batch.size do\n"
+    "      if #batch:text(i) >= 6 then batch:drop(i) end\n"
+    "    end\n"
+    "    yield(batch)\n"
+    "  end\n"
+    "end\n"
+    "function array_filter(input, env)\n"
+    "  for batch in input:batches(64) do\n"
+    "    local kept = {}\n"
+    "    for i = 1, batch.size do\n"
+    "      if #batch:text(i) < 6 then kept[#kept + 1] = batch:get(i) end\n"
+    "    end\n"
+    "    yield(kept)\n"
+    "  end\n"
+    "end\n";
+
+static void run(const char *title, const char *func, int keystrokes,
+                int num_candidates, int num_filters) {
+  the<Engine> engine(Engine::Create());
+  Lua lua;
+  lua.to_state(types_init);
+  lua.to_state([](lua_State *L) {
+    if (luaL_dostring(L, kFilterScript))
+      std::cerr << lua_tostring(L, -1) << std::endl;
+  });
+
+  vector<the<LuaFilter>> filters;
+  for (int i = 0; i < num_filters; ++i) {
+    Ticket ticket(engine.get(), func, func);
+    filters.emplace_back(new LuaFilter(ticket, &lua));
+  }
+
+  vector<double> latencies;
+  size_t passed = 0;
+  for (int k = 0; k < keystrokes; ++k) {
+    auto start = steady_clock::now();
+    {
+      auto fifo = New<FifoTranslation>();
+      for (int i = 0; i < num_candidates; ++i) {
+        fifo->Append(New<SimpleCandidate>("bench", 0, 1,
+                                          std::to_string(k * 131 + i)));
+      }
+      an<Translation> translation = fifo;
+      CandidateList candidates;
+      for (auto &filter : filters) {
+        translation = filter->Apply(translation, &candidates);
+      }
+      // filters scan every candidate, as one that sorts or dedups would.
+      for (; !translation->exhausted(); translation->Next()) {
+        ++passed;
+      }
+    }
+    latencies.push_back(
+        duration<double, std::micro>(steady_clock::now() - start).count());
+  }
+  std::sort(latencies.begin(), latencies.end());
+  auto percentile = [&](double p) {
+    return latencies[size_t(p * (latencies.size() - 1))];
+  };
+  std::cout << title << ": p50 " << percentile(0.5) << " us, p95 "
+            << percentile(0.95) << " us, p99 " << percentile(0.99)
+            << " us; passed " << passed << " candidates" << std::endl;
+}
+
+int main(int argc, char *argv[]) {
+  const int keystrokes = argc > 1 ? std::stoi(argv[1]) : 1000;
+  const int num_candidates = argc > 2 ? std::stoi(argv[2]) : 100;
+  const int num_filters = argc > 3 ? std::stoi(argv[3]) : 3;
+  LoadModules(kDefaultModules);
+
+  run("one candidate per resume", "single_filter", keystrokes,
+      num_candidates, num_filters);
+  run("batches of candidates", "batch_filter", keystrokes, num_candidates,
+      num_filters);
+  run("arrays of candidates", "array_filter", keystrokes, num_candidates,
+      num_filters);
+  return 0;
+}
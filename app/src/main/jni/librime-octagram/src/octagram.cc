@@ -22,11 +22,10 @@ const ResourceType kGramDbType = {"gram_db", "", ".gram"};
 const string kGrammarDefaultLanguage = "zh-hant";
 
 Octagram::Octagram(Config* config, OctagramComponent* component)
-    : config_(std::make_unique<GrammarConfig>()) {
-  string language;
+    : config_(std::make_unique<GrammarConfig>()), component_(component) {
   if (config) {
-    if (config->GetString("grammar/language", &language)) {
-      LOG(INFO) << "use grammar: " << language;
+    if (config->GetString("grammar/language", &language_)) {
+      LOG(INFO) << "use grammar: " << language_;
     } else {
       return;
     }
@@ -43,13 +42,19 @@ Octagram::Octagram(Config* config, OctagramComponent* component)
     config->GetDouble("grammar/rear_penalty",
                      &config_->rear_penalty);
   }
-  if (!language.empty()) {
-    db_ = component->GetDb(language);
-  }
 }
 
 Octagram::~Octagram() {}
 
+bool Octagram::Load() {
+  if (!db_fetched_) {
+    db_fetched_ = true;
+    if (!language_.empty())
+      db_ = component_->GetDb(language_);
+  }
+  return db_ != nullptr;
+}
+
 inline static double scale_value(int value) {
   return value >= 0 ? double(value) / GramDb::kValueScale : -1;
 }
@@ -107,7 +112,7 @@ inline static bool matches_whole_query(const char* context_ptr,
 double Octagram::Query(const string& context,
                        const string& word,
                        bool is_rear) {
-  if (!db_ || context.empty()) {
+  if (context.empty() || !Load()) {
     return config_->non_collocation_penalty;
   }
   double result = config_->non_collocation_penalty;
@@ -170,6 +175,7 @@ Octagram* OctagramComponent::Create(Config* config) {
 }
 
 GramDb* OctagramComponent::GetDb(const string& language) {
+  std::lock_guard<std::mutex> lock(mutex_);
   auto& loaded = db_by_language_[language];
   if (!loaded) {
     the<ResourceResolver> resolver(
@@ -1,6 +1,7 @@
 #ifndef RIME_OCTAGRAM_H_
 #define RIME_OCTAGRAM_H_
 
+#include <mutex>
 #include <rime/common.h>
 #include <rime/component.h>
 #include <rime/resource.h>
@@ -20,12 +21,18 @@ class Octagram : public Grammar {
  public:
   Octagram(Config* config, OctagramComponent* component);
   virtual ~Octagram();
+  bool Load() override;
   double Query(const string& context,
                const string& word,
                bool is_rear) override;
 
  private:
   the<GrammarConfig> config_;
+  OctagramComponent* component_;
+  string language_;
+  // the db is fetched at the first query rather than on creating the
+  // grammar, as the preloader may be loading it then.
+  bool db_fetched_ = false;
   GramDb* db_ = nullptr;
 };
 
@@ -40,6 +47,8 @@ class OctagramComponent : public Grammar::Component {
 
  private:
   map<string, the<GramDb>> db_by_language_;
+  // held while loading, as grammars are also preloaded in the background.
+  std::mutex mutex_;
 };
 
 }  // namespace rime
@@ -1,15 +1,35 @@
 #include "predict_db.h"
 #include <algorithm>
+#include <cfloat>
 #include <boost/algorithm/string.hpp>
 #include <darts.h>
+#include <utf8.h>
 #include <rime/resource.h>
 #include <rime/dict/mapped_file.h>
 #include <rime/dict/string_table.h>
 
 namespace rime {
 
-const string kPredictFormat = "Rime::Predict/1.0";
+const string kPredictFormat = "Rime::Predict/2.0";
 const string kPredictFormatPrefix = "Rime::Predict/";
+const double kPredictFormatReversedKeys = 2.0;
+
+// maximum number of suffixes of a context that can be keys in the trie.
+const size_t kMaxSuffixMatches = 64;
+
+static string ReverseCharacters(const string& text) {
+  string reversed;
+  reversed.reserve(text.length());
+  const char* begin = text.c_str();
+  const char* end = begin + text.length();
+  while (end != begin) {
+    const char* p = end;
+    utf8::unchecked::prior(p);
+    reversed.append(p, end);
+    end = p;
+  }
+  return reversed;
+}
 
 bool PredictDb::Load() {
   LOG(INFO) << "loading predict db: " << file_path();
@@ -34,6 +54,9 @@ bool PredictDb::Load() {
     Close();
     return false;
   }
+  double format_version =
+      atof(&metadata_->format[kPredictFormatPrefix.length()]);
+  reversed_keys_ = format_version >= kPredictFormatReversedKeys - DBL_EPSILON;
 
   if (!metadata_->key_trie) {
     LOG(ERROR) << "double array image not found.";
@@ -86,15 +109,23 @@ bool PredictDb::Build(const predict::RawData& data) {
   for (const auto& kv : data) {
     entry_count += kv.second.size();
   }
+  // keys are reversed so that all suffixes of a context can be found with
+  // a common prefix search; the trie requires them to be sorted again.
+  vector<pair<string, const vector<predict::RawEntry>*>> sorted_data;
+  sorted_data.reserve(data_size);
+  for (const auto& kv : data) {
+    if (kv.second.empty())
+      continue;
+    sorted_data.emplace_back(ReverseCharacters(kv.first), &kv.second);
+  }
+  std::sort(sorted_data.begin(), sorted_data.end());
   StringTableBuilder string_table;
   vector<table::Entry> entries(entry_count);
   vector<const char*> keys;
-  keys.reserve(data_size);
+  keys.reserve(sorted_data.size());
   int i = 0;
-  for (const auto& kv : data) {
-    if (kv.second.empty())
-      continue;
-    for (const auto& candidate : kv.second) {
+  for (const auto& kv : sorted_data) {
+    for (const auto& candidate : *kv.second) {
       string_table.Add(candidate.text, candidate.weight,
                        &entries[i].text.str_id());
       entries[i].weight = float(candidate.weight);
@@ -118,15 +149,13 @@ bool PredictDb::Build(const predict::RawData& data) {
   // copy from entry vector to entry array
   const table::Entry* available_entries = &entries[0];
   vector<int> values;
-  values.reserve(data_size);
-  for (const auto& kv : data) {
-    if (kv.second.empty())
-      continue;
-    values.push_back(WriteCandidates(kv.second, available_entries));
-    available_entries += kv.second.size();
+  values.reserve(sorted_data.size());
+  for (const auto& kv : sorted_data) {
+    values.push_back(WriteCandidates(*kv.second, available_entries));
+    available_entries += kv.second->size();
   }
   // build real key trie
-  if (0 != key_trie_->build(data_size, keys.data(), NULL, values.data())) {
+  if (0 != key_trie_->build(keys.size(), keys.data(), NULL, values.data())) {
     LOG(ERROR) << "Error building double-array trie.";
     return false;
   }
@@ -157,19 +186,57 @@ bool PredictDb::Build(const predict::RawData& data) {
   // at last, complete the metadata
   std::strncpy(metadata_->format, kPredictFormat.c_str(),
                kPredictFormat.length());
+  reversed_keys_ = true;
   return true;
 }
 
 predict::Candidates* PredictDb::Lookup(const string& query) {
-  int result = key_trie_->exactMatchSearch<int>(query.c_str());
+  int result = key_trie_->exactMatchSearch<int>(
+      reversed_keys_ ? ReverseCharacters(query).c_str() : query.c_str());
   if (result == -1)
     return nullptr;
   else
     return Find<predict::Candidates>(result);
 }
 
+bool PredictDb::LookupSuffixes(const string& context,
+                               vector<predict::SuffixMatch>* matches) {
+  matches->clear();
+  if (!reversed_keys_) {
+    // legacy format only supports looking up the whole context
+    if (auto* candidates = Lookup(context)) {
+      matches->push_back({context.length(), candidates});
+    }
+    return !matches->empty();
+  }
+  const string reversed_context = ReverseCharacters(context);
+  Darts::DoubleArray::result_pair_type results[kMaxSuffixMatches];
+  size_t num_results = std::min(
+      kMaxSuffixMatches,
+      key_trie_->commonPrefixSearch(reversed_context.c_str(), results,
+                                    kMaxSuffixMatches,
+                                    reversed_context.length()));
+  for (size_t i = num_results; i > 0; --i) {
+    const auto& result = results[i - 1];
+    if (auto* candidates = Find<predict::Candidates>(result.value)) {
+      matches->push_back({result.length, candidates});
+    }
+  }
+  return !matches->empty();
+}
+
 string PredictDb::GetEntryText(const ::rime::table::Entry& entry) {
   return value_trie_->GetString(entry.text.str_id());
 }
 
+void PredictDb::GetTexts(const vector<StringId>& text_ids,
+                         vector<string>* texts) {
+  value_trie_->GetStrings(text_ids, texts);
+}
+
+void PredictDb::LookupTextIds(const vector<string>& texts,
+                              vector<StringId>* text_ids) {
+  value_trie_->Lookup(texts, text_ids);
+}
+
 }  // namespace rime
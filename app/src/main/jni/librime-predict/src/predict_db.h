@@ -23,6 +23,12 @@ struct Metadata {
 
 using Candidates = ::rime::Array<::rime::table::Entry>;
 
+// candidates predicted for a suffix of the context, in bytes.
+struct SuffixMatch {
+  size_t length;
+  const Candidates* candidates;
+};
+
 struct RawEntry {
   string text;
   double weight;
@@ -43,13 +49,23 @@ class PredictDb : public MappedFile {
   bool Save();
   bool Build(const predict::RawData& data);
   predict::Candidates* Lookup(const string& query);
+  // finds candidates for every suffix of the context in a single trie walk,
+  // from the longest suffix to the shortest.
+  bool LookupSuffixes(const string& context,
+                      vector<predict::SuffixMatch>* matches);
   string GetEntryText(const ::rime::table::Entry& entry);
+  // entries of the same text share a string id; texts are resolved in a
+  // batch, and texts not in the db are mapped to kInvalidStringId.
+  void GetTexts(const vector<StringId>& text_ids, vector<string>* texts);
+  void LookupTextIds(const vector<string>& texts, vector<StringId>* text_ids);
 
  private:
   int WriteCandidates(const vector<predict::RawEntry>& candidates,
                       const table::Entry* entry);
 
   predict::Metadata* metadata_ = nullptr;
+  // keys are stored in reversed character order since format 2.0
+  bool reversed_keys_ = false;
   the<Darts::DoubleArray> key_trie_;
   the<StringTable> value_trie_;
 };
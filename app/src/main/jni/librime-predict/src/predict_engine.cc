@@ -1,5 +1,6 @@
 #include "predict_engine.h"
 
+#include <algorithm>
 #include "predict_db.h"
 #include <rime/candidate.h>
 #include <rime/context.h>
@@ -12,15 +13,21 @@
 #include <rime/translation.h>
 #include <rime/schema.h>
 #include <rime/dict/db_pool_impl.h>
+#include <rime/dict/level_db.h>
 
 namespace rime {
 
 static const ResourceType kPredictDbResourceType = {"predict_db", "", ""};
 
+// not ".userdb", which would list the db among user dictionaries.
+static const string kPredictUserDbExtension = ".predict_userdb";
+
 PredictEngine::PredictEngine(an<PredictDb> db,
+                             an<PredictUserDb> user_db,
                              int max_iterations,
                              int max_candidates)
     : db_(db),
+      user_db_(user_db),
       max_iterations_(max_iterations),
       max_candidates_(max_candidates) {}
 
@@ -28,20 +35,99 @@ PredictEngine::~PredictEngine() {}
 
 bool PredictEngine::Predict(Context* ctx, const string& context_query) {
   DLOG(INFO) << "PredictEngine::Predict [" << context_query << "]";
-  if (const auto* candidates = db_->Lookup(context_query)) {
-    query_ = context_query;
-    candidates_ = candidates;
-    return true;
-  } else {
+  vector<predict::SuffixMatch> matches;
+  vector<predict::RawEntry> learned;
+  bool found_static = db_->LookupSuffixes(context_query, &matches);
+  bool found_learned =
+      user_db_ && user_db_->Lookup(context_query, max_candidates_, &learned);
+  if (!found_static && !found_learned) {
     Clear();
     return false;
   }
+  // merge candidates predicted by all matching suffixes by the id of their
+  // text; on equal weight, those from a longer suffix of the context come
+  // first. texts are resolved only for candidates that make the list.
+  struct Prediction {
+    double weight;
+    StringId text_id;
+    string text;
+  };
+  vector<Prediction> merged;
+  hash_map<StringId, size_t> index;
+  double max_static_weight = 0.0;
+  for (const auto& match : matches) {
+    for (const auto* it = match.candidates->begin();
+         it != match.candidates->end(); ++it) {
+      StringId text_id = it->text.str_id();
+      max_static_weight = (std::max)(max_static_weight, double(it->weight));
+      auto found = index.find(text_id);
+      if (found == index.end()) {
+        index[text_id] = merged.size();
+        merged.push_back({it->weight, text_id, string()});
+      } else if (merged[found->second].weight < it->weight) {
+        merged[found->second].weight = it->weight;
+      }
+    }
+  }
+  // static weights are corpus frequencies, scaled so that the most likely
+  // one counts as much as a single recent commit of a learned candidate.
+  if (max_static_weight > 0.0) {
+    for (auto& candidate : merged) {
+      candidate.weight /= max_static_weight;
+    }
+  }
+  if (!learned.empty()) {
+    vector<string> texts;
+    texts.reserve(learned.size());
+    for (const auto& entry : learned) {
+      texts.push_back(entry.text);
+    }
+    vector<StringId> text_ids;
+    db_->LookupTextIds(texts, &text_ids);
+    for (size_t i = 0; i < learned.size(); ++i) {
+      auto found = text_ids[i] == kInvalidStringId ? index.end()
+                                                   : index.find(text_ids[i]);
+      if (found == index.end()) {
+        merged.push_back({learned[i].weight, kInvalidStringId,
+                          std::move(learned[i].text)});
+      } else {
+        merged[found->second].weight += learned[i].weight;
+      }
+    }
+  }
+  std::stable_sort(merged.begin(), merged.end(),
+                   [](const Prediction& a, const Prediction& b) {
+                     return a.weight > b.weight;
+                   });
+  if (max_candidates_ > 0 && merged.size() > size_t(max_candidates_)) {
+    merged.resize(max_candidates_);
+  }
+  vector<StringId> text_ids;
+  for (const auto& candidate : merged) {
+    if (candidate.text.empty())
+      text_ids.push_back(candidate.text_id);
+  }
+  vector<string> texts;
+  db_->GetTexts(text_ids, &texts);
+  query_ = context_query;
+  candidates_.clear();
+  candidates_.reserve(merged.size());
+  auto next_text = texts.begin();
+  for (auto& candidate : merged) {
+    candidates_.push_back(candidate.text.empty() ? std::move(*next_text++)
+                                                 : std::move(candidate.text));
+  }
+  return true;
+}
+
+bool PredictEngine::Learn(const string& context, const string& text) {
+  return user_db_ && user_db_->Learn(context, text);
 }
 
 void PredictEngine::Clear() {
   DLOG(INFO) << "PredictEngine::Clear";
   query_.clear();
-  candidates_ = nullptr;
+  candidates_.clear();
 }
 
 void PredictEngine::CreatePredictSegment(Context* ctx) const {
@@ -60,9 +146,8 @@ an<Translation> PredictEngine::Translate(const Segment& segment) const {
   auto translation = New<FifoTranslation>();
   size_t end = segment.end;
   int i = 0;
-  for (auto* it = candidates_->begin(); it != candidates_->end(); ++it) {
-    translation->Append(
-        New<SimpleCandidate>("prediction", end, end, db_->GetEntryText(*it)));
+  for (const auto& text : candidates_) {
+    translation->Append(New<SimpleCandidate>("prediction", end, end, text));
     i++;
     if (max_candidates_ > 0 && i >= max_candidates_)
       break;
@@ -70,6 +155,14 @@ an<Translation> PredictEngine::Translate(const Segment& segment) const {
   return translation;
 }
 
+Db* PredictUserDbComponent::Create(const string& name) {
+  return new UserDbWrapper<LevelDb>(DbFilePath(name, extension()), name);
+}
+
+string PredictUserDbComponent::extension() const {
+  return kPredictUserDbExtension;
+}
+
 PredictEngineComponent::PredictEngineComponent()
     : db_pool_(the<ResourceResolver>(
           Service::instance().CreateResourceResolver(kPredictDbResourceType))) {
@@ -81,6 +174,9 @@ PredictEngine* PredictEngineComponent::Create(const Ticket& ticket) {
   string db_name = "predict.db";
   int max_candidates = 0;
   int max_iterations = 0;
+  bool enable_user_db = true;
+  string user_db_name = "predict";
+  int max_user_entries = int(PredictUserDb::kDefaultMaxEntries);
   if (auto* schema = ticket.schema) {
     auto* config = schema->config();
     if (config->GetString("predictor/db", &db_name)) {
@@ -92,10 +188,17 @@ PredictEngine* PredictEngineComponent::Create(const Ticket& ticket) {
     if (!config->GetInt("predictor/max_iterations", &max_iterations)) {
       LOG(INFO) << "predictor/max_iterations is not set in schema";
     }
+    config->GetBool("predictor/enable_user_db", &enable_user_db);
+    config->GetString("predictor/user_db", &user_db_name);
+    config->GetInt("predictor/max_user_entries", &max_user_entries);
   }
   if (auto db = db_pool_.GetDb(db_name)) {
     if (db->IsOpen() || db->Load()) {
-      return new PredictEngine(db, max_iterations, max_candidates);
+      auto user_db =
+          enable_user_db && max_user_entries > 0
+              ? GetUserDb(user_db_name, size_t(max_user_entries))
+              : nullptr;
+      return new PredictEngine(db, user_db, max_iterations, max_candidates);
     } else {
       LOG(ERROR) << "failed to load predict db: " << db_name;
     }
@@ -103,8 +206,24 @@ PredictEngine* PredictEngineComponent::Create(const Ticket& ticket) {
   return nullptr;
 }
 
+an<PredictUserDb> PredictEngineComponent::GetUserDb(const string& db_name,
+                                                    size_t max_entries) {
+  std::lock_guard<std::mutex> lock(user_db_mutex_);
+  if (auto user_db = user_db_pool_[db_name].lock()) {
+    return user_db;
+  }
+  auto user_db = New<PredictUserDb>(
+      an<Db>(user_db_component_.Create(db_name)), max_entries);
+  if (!user_db->Load()) {
+    return nullptr;
+  }
+  user_db_pool_[db_name] = user_db;
+  return user_db;
+}
+
 an<PredictEngine> PredictEngineComponent::GetInstance(const Ticket& ticket) {
   if (Schema* schema = ticket.schema) {
+    std::lock_guard<std::mutex> lock(mutex_);
     auto found = predict_engine_by_schema_id.find(schema->schema_id());
     if (found != predict_engine_by_schema_id.end()) {
       if (auto instance = found->second.lock()) {
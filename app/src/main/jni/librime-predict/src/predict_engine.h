@@ -1,9 +1,13 @@
 #ifndef RIME_PREDICT_ENGINE_H_
 #define RIME_PREDICT_ENGINE_H_
 
+#include <mutex>
 #include "predict_db.h"
+#include "predict_user_db.h"
 #include <rime/component.h>
+#include <rime/dict/db.h>
 #include <rime/dict/db_pool.h>
+#include <rime/dict/user_db.h>
 
 namespace rime {
 
@@ -14,10 +18,14 @@ class Translation;
 
 class PredictEngine : public Class<PredictEngine, const Ticket&> {
  public:
-  PredictEngine(an<PredictDb> db, int max_iterations, int max_candidates);
+  PredictEngine(an<PredictDb> db,
+                an<PredictUserDb> user_db,
+                int max_iterations,
+                int max_candidates);
   virtual ~PredictEngine();
 
   bool Predict(Context* ctx, const string& context_query);
+  bool Learn(const string& context, const string& text);
   void Clear();
   void CreatePredictSegment(Context* ctx) const;
   an<Translation> Translate(const Segment& segment) const;
@@ -25,17 +33,27 @@ class PredictEngine : public Class<PredictEngine, const Ticket&> {
   int max_iterations() const { return max_iterations_; }
   int max_candidates() const { return max_candidates_; }
   const string& query() const { return query_; }
-  int num_candidates() const { return candidates_ ? candidates_->size : 0; }
+  int num_candidates() const { return int(candidates_.size()); }
   string candidate(size_t i) const {
-    return candidates_ ? db_->GetEntryText(candidates_->at[i]) : string();
+    return i < candidates_.size() ? candidates_[i] : string();
   }
 
  private:
   an<PredictDb> db_;
+  an<PredictUserDb> user_db_;  // optional, learns from user commits
   int max_iterations_;  // prediction times limit
   int max_candidates_;  // prediction candidate count limit
   string query_;        // cache last query
-  const predict::Candidates* candidates_ = nullptr;  // cache last result
+  vector<string> candidates_;  // cache last result, the most likely first
+};
+
+// creates predict user dbs, named apart from user dictionaries so that user
+// dict management and sync leave them alone.
+class PredictUserDbComponent : public UserDb::Component,
+                               protected DbComponentBase {
+ public:
+  Db* Create(const string& name) override;
+  string extension() const override;
 };
 
 class PredictEngineComponent : public PredictEngine::Component {
@@ -48,8 +66,15 @@ class PredictEngineComponent : public PredictEngine::Component {
   an<PredictEngine> GetInstance(const Ticket& ticket);
 
  protected:
+  an<PredictUserDb> GetUserDb(const string& db_name, size_t max_entries);
+
+  // engines are created for sessions on any thread.
+  std::mutex mutex_;
   map<string, weak<PredictEngine>> predict_engine_by_schema_id;
   DbPool<PredictDb> db_pool_;
+  std::mutex user_db_mutex_;
+  PredictUserDbComponent user_db_component_;
+  map<string, weak<PredictUserDb>> user_db_pool_;
 };
 
 }  // namespace rime
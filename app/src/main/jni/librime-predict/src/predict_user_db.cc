@@ -0,0 +1,202 @@
+#include "predict_user_db.h"
+
+#include <algorithm>
+#include <rime/algo/dynamics.h>
+
+namespace rime {
+
+PredictUserDb::~PredictUserDb() {
+  if (pending_updates_ > 0 && loaded() && !db_->readonly())
+    UpdateMetadata();
+}
+
+bool PredictUserDb::Load() {
+  if (!db_ || db_->disabled())
+    return false;
+  if (!db_->loaded() && !db_->Open()) {
+    LOG(ERROR) << "failed to open predict user db: " << db_->name();
+    return false;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  return FetchMetadata();
+}
+
+bool PredictUserDb::FetchMetadata() {
+  string value;
+  bool has_tick = false;
+  try {
+    if (db_->MetaFetch("/tick", &value)) {
+      tick_ = std::stoul(value);
+      has_tick = true;
+    }
+  } catch (...) {
+  }
+  try {
+    if (db_->MetaFetch("/entries", &value)) {
+      num_entries_ = std::stoul(value);
+      return has_tick || db_->MetaUpdate("/tick", std::to_string(tick_));
+    }
+  } catch (...) {
+  }
+  // counted once for a db learned before the number was kept.
+  num_entries_ = 0;
+  if (auto accessor = db_->QueryAll()) {
+    string key;
+    while (accessor->GetNextRecord(&key, &value)) {
+      ++num_entries_;
+    }
+  }
+  return UpdateMetadata();
+}
+
+bool PredictUserDb::UpdateMetadata() {
+  pending_updates_ = 0;
+  return db_->MetaUpdate("/tick", std::to_string(tick_)) &&
+         db_->MetaUpdate("/entries", std::to_string(num_entries_));
+}
+
+double PredictUserDb::Weight(const string& value,
+                             TickCount present_tick) const {
+  UserDbValue v(value);
+  if (v.commits <= 0)
+    return 0.0;
+  return algo::formula_d(0, (double)present_tick, v.dee, (double)v.tick);
+}
+
+bool PredictUserDb::Learn(const string& context, const string& text) {
+  if (!loaded() || db_->readonly() || context.empty() || text.empty())
+    return false;
+  std::lock_guard<std::mutex> lock(mutex_);
+  const string prefix(context + '\t');
+  const string key(prefix + text);
+  string value;
+  UserDbValue v;
+  bool is_new = !db_->Fetch(key, &value);
+  if (is_new) {
+    EvictFollowers(prefix);
+  } else {
+    v.Unpack(value);
+    if (v.tick > tick_) {
+      v.tick = tick_;  // fix abnormal timestamp
+    }
+  }
+  if (v.commits < 0)
+    v.commits = -v.commits;
+  ++v.commits;
+  ++tick_;
+  v.dee = algo::formula_d(1, (double)tick_, v.dee, (double)v.tick);
+  v.tick = tick_;
+  if (!db_->Update(key, v.Pack()))
+    return false;
+  if (is_new && ++num_entries_ > max_entries_) {
+    EvictEntry();
+  }
+  if (++pending_updates_ < kMetadataUpdateInterval)
+    return true;
+  return UpdateMetadata();
+}
+
+bool PredictUserDb::EvictFollowers(const string& prefix) {
+  auto accessor = db_->Query(prefix);
+  if (!accessor)
+    return false;
+  vector<pair<double, string>> followers;
+  const TickCount present_tick = tick_ + 1;
+  string key;
+  string value;
+  while (accessor->GetNextRecord(&key, &value)) {
+    followers.emplace_back(Weight(value, present_tick), key);
+  }
+  if (followers.size() < kMaxFollowers)
+    return true;
+  return Erase(&followers, followers.size() - kMaxFollowers + 1);
+}
+
+bool PredictUserDb::EvictEntry() {
+  auto accessor = db_->QueryAll();
+  if (!accessor)
+    return false;
+  // records start after the metadata and the change log, at " ".
+  const string start = eviction_cursor_.empty() ? " " : eviction_cursor_;
+  vector<pair<double, string>> sample;
+  const TickCount present_tick = tick_ + 1;
+  string key;
+  string value;
+  accessor->Jump(start);
+  while (sample.size() < kEvictionSample &&
+         accessor->GetNextRecord(&key, &value)) {
+    sample.emplace_back(Weight(value, present_tick), key);
+  }
+  if (sample.size() < kEvictionSample && start != " ") {
+    // goes round to the first record.
+    accessor->Jump(" ");
+    while (sample.size() < kEvictionSample &&
+           accessor->GetNextRecord(&key, &value) && key < start) {
+      sample.emplace_back(Weight(value, present_tick), key);
+    }
+  }
+  if (sample.empty()) {
+    num_entries_ = 0;
+    return false;
+  }
+  // resumes right after the last key sampled.
+  eviction_cursor_ = sample.back().second + '\0';
+  return Erase(&sample, 1);
+}
+
+// erases the given number of the least likely keys.
+bool PredictUserDb::Erase(vector<pair<double, string>>* weighted_keys,
+                          size_t count) {
+  count = (std::min)(count, weighted_keys->size());
+  std::nth_element(weighted_keys->begin(), weighted_keys->begin() + count,
+                   weighted_keys->end());
+  auto* transactional = dynamic_cast<Transactional*>(db_.get());
+  bool in_transaction = transactional && transactional->BeginTransaction();
+  size_t erased = 0;
+  for (size_t i = 0; i < count; ++i) {
+    if (db_->Erase((*weighted_keys)[i].second))
+      ++erased;
+  }
+  if (in_transaction && !transactional->CommitTransaction()) {
+    return false;
+  }
+  num_entries_ -= (std::min)(erased, num_entries_);
+  return erased == count;
+}
+
+size_t PredictUserDb::Lookup(const string& context,
+                             size_t limit,
+                             vector<predict::RawEntry>* entries) {
+  entries->clear();
+  if (!loaded() || context.empty())
+    return 0;
+  std::lock_guard<std::mutex> lock(mutex_);
+  const string prefix(context + '\t');
+  auto accessor = db_->Query(prefix);
+  if (!accessor)
+    return 0;
+  // followers are few, being evicted beyond kMaxFollowers, so all of them
+  // are ranked before the list is cut.
+  const TickCount present_tick = tick_ + 1;
+  string key;
+  string value;
+  while (accessor->GetNextRecord(&key, &value)) {
+    double weight = Weight(value, present_tick);
+    if (weight > 0.0) {
+      entries->push_back({key.substr(prefix.length()), weight});
+    }
+  }
+  auto by_weight = [](const predict::RawEntry& a, const predict::RawEntry& b) {
+    return a.weight > b.weight;
+  };
+  if (limit > 0 && entries->size() > limit) {
+    std::partial_sort(entries->begin(), entries->begin() + limit,
+                      entries->end(), by_weight);
+    entries->resize(limit);
+  } else {
+    std::sort(entries->begin(), entries->end(), by_weight);
+  }
+  return entries->size();
+}
+
+}  // namespace rime
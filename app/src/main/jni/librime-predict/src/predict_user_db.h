@@ -0,0 +1,69 @@
+#ifndef RIME_PREDICT_USER_DB_H_
+#define RIME_PREDICT_USER_DB_H_
+
+#include <mutex>
+#include "predict_db.h"
+#include <rime/dict/db.h>
+#include <rime/dict/user_db.h>
+
+namespace rime {
+
+// learns which text the user commits after a given commit.
+// records are stored as "context\ttext" keys in a user db, with values in
+// the same format as user dictionaries.
+// engines of all sessions share an instance, so access is serialized.
+class PredictUserDb {
+ public:
+  // the followers kept for each context; the least likely one is evicted
+  // to make room for a new one.
+  static constexpr size_t kMaxFollowers = 64;
+  static constexpr size_t kDefaultMaxEntries = 100000;
+  // pairs inspected for each eviction once the db is full.
+  static constexpr size_t kEvictionSample = 16;
+  // commits between updates of the tick and the number of entries kept in
+  // the metadata; both are saved as well when the instance goes away.
+  static constexpr size_t kMetadataUpdateInterval = 64;
+
+  // once more than max_entries pairs are learned, each new pair evicts the
+  // least likely of a sample of the others, taken in turns around the db.
+  explicit PredictUserDb(an<Db> db, size_t max_entries = kDefaultMaxEntries)
+      : db_(db), max_entries_(max_entries) {}
+  ~PredictUserDb();
+
+  bool Load();
+  bool loaded() const { return db_ && db_->loaded(); }
+  // one fetch and one update per commit; a new pair adds a scan of the
+  // followers of the context, and of a sample of pairs if the db is full.
+  bool Learn(const string& context, const string& text);
+  // finds the `limit` most likely candidates following the context,
+  // weighted by decayed commit counts; 0 for no limit.
+  size_t Lookup(const string& context,
+                size_t limit,
+                vector<predict::RawEntry>* entries);
+
+  Db* db() const { return db_.get(); }
+  TickCount tick() const { return tick_; }
+  // counted as pairs are learned and evicted, rather than stored.
+  size_t num_entries() const { return num_entries_; }
+
+ private:
+  bool FetchMetadata();
+  bool UpdateMetadata();
+  double Weight(const string& value, TickCount present_tick) const;
+  bool EvictFollowers(const string& prefix);
+  bool EvictEntry();
+  bool Erase(vector<pair<double, string>>* weighted_keys, size_t count);
+
+  std::mutex mutex_;
+  an<Db> db_;
+  size_t max_entries_;
+  TickCount tick_ = 0;
+  size_t num_entries_ = 0;
+  size_t pending_updates_ = 0;
+  // where the next sample for eviction starts.
+  string eviction_cursor_;
+};
+
+}  // namespace rime
+
+#endif  // RIME_PREDICT_USER_DB_H_
@@ -22,11 +22,20 @@ Predictor::Predictor(const Ticket& ticket, an<PredictEngine> predict_engine)
       [this](Context* ctx) { OnSelect(ctx); });
   context_update_connection_ = context->update_notifier().connect(
       [this](Context* ctx) { OnContextUpdate(ctx); });
+  // connected after the engine, which has added the commit to history.
+  commit_connection_ = context->commit_notifier().connect(
+      [this](Context* ctx) { OnCommit(ctx); });
 }
 
 Predictor::~Predictor() {
   select_connection_.disconnect();
   context_update_connection_.disconnect();
+  commit_connection_.disconnect();
+}
+
+static bool IsPredictable(const CommitRecord& record) {
+  return record.type != "punct" && record.type != "raw" &&
+         record.type != "thru";
 }
 
 ProcessResult Predictor::ProcessKeyEvent(const KeyEvent& key_event) {
@@ -65,8 +74,7 @@ void Predictor::OnContextUpdate(Context* ctx) {
     return;
   }
   auto last_commit = ctx->commit_history().back();
-  if (last_commit.type == "punct" || last_commit.type == "raw" ||
-      last_commit.type == "thru") {
+  if (!IsPredictable(last_commit)) {
     predict_engine_->Clear();
     iteration_counter_ = 0;
     return;
@@ -88,6 +96,19 @@ void Predictor::OnContextUpdate(Context* ctx) {
   PredictAndUpdate(ctx, last_commit.text);
 }
 
+void Predictor::OnCommit(Context* ctx) {
+  if (!predict_engine_ || !ctx || !ctx->get_option("prediction"))
+    return;
+  const auto& history = ctx->commit_history();
+  if (history.size() < 2)
+    return;
+  auto last = history.rbegin();
+  auto previous = std::next(last);
+  if (IsPredictable(*last) && IsPredictable(*previous)) {
+    predict_engine_->Learn(previous->text, last->text);
+  }
+}
+
 void Predictor::PredictAndUpdate(Context* ctx, const string& context_query) {
   if (predict_engine_->Predict(ctx, context_query)) {
     predict_engine_->CreatePredictSegment(ctx);
@@ -0,0 +1,90 @@
+//
+// Copyright RIME Developers
+//
+#include <filesystem>
+#include <gtest/gtest.h>
+#include <rime/common.h>
+#include "predict_db.h"
+
+using namespace rime;
+
+class PredictDbTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    predict::RawData data;
+    data["你好"] = {{"嗎", 3.0}, {"啊", 1.0}};
+    data["好"] = {{"的", 2.0}};
+    data["我們"] = {{"的", 5.0}, {"都", 4.0}};
+    data["$"] = {{"我", 7.0}};
+    PredictDb builder(file_path_);
+    ASSERT_TRUE(builder.Build(data));
+    ASSERT_TRUE(builder.Save());
+    db_ = New<PredictDb>(file_path_);
+    ASSERT_TRUE(db_->Load());
+  }
+
+  void TearDown() override {
+    db_.reset();
+    std::error_code ec;
+    std::filesystem::remove(file_path_, ec);
+  }
+
+  vector<string> Texts(const predict::Candidates* candidates) {
+    vector<string> texts;
+    for (const auto* it = candidates->begin(); it != candidates->end(); ++it) {
+      texts.push_back(db_->GetEntryText(*it));
+    }
+    return texts;
+  }
+
+  const path file_path_{"predict_db_test.db"};
+  an<PredictDb> db_;
+};
+
+TEST_F(PredictDbTest, LookupAfterReload) {
+  auto* candidates = db_->Lookup("你好");
+  ASSERT_TRUE(candidates);
+  EXPECT_EQ((vector<string>{"嗎", "啊"}), Texts(candidates));
+  EXPECT_FLOAT_EQ(3.0f, candidates->at[0].weight);
+  EXPECT_FLOAT_EQ(1.0f, candidates->at[1].weight);
+  candidates = db_->Lookup("我們");
+  ASSERT_TRUE(candidates);
+  EXPECT_EQ((vector<string>{"的", "都"}), Texts(candidates));
+  ASSERT_TRUE(db_->Lookup("$"));
+  // keys are matched whole.
+  EXPECT_FALSE(db_->Lookup("你"));
+  EXPECT_FALSE(db_->Lookup("我們你好"));
+}
+
+TEST_F(PredictDbTest, LookupSuffixesLongestFirst) {
+  vector<predict::SuffixMatch> matches;
+  ASSERT_TRUE(db_->LookupSuffixes("我們你好", &matches));
+  ASSERT_EQ(2, matches.size());
+  EXPECT_EQ(string("你好").length(), matches[0].length);
+  EXPECT_EQ((vector<string>{"嗎", "啊"}), Texts(matches[0].candidates));
+  EXPECT_EQ(string("好").length(), matches[1].length);
+  EXPECT_EQ((vector<string>{"的"}), Texts(matches[1].candidates));
+
+  ASSERT_TRUE(db_->LookupSuffixes("我們", &matches));
+  ASSERT_EQ(1, matches.size());
+  EXPECT_EQ(string("我們").length(), matches[0].length);
+
+  // a key in the middle of the context is not a suffix.
+  EXPECT_FALSE(db_->LookupSuffixes("我們呀", &matches));
+  EXPECT_TRUE(matches.empty());
+}
+
+TEST_F(PredictDbTest, SameTextSharesId) {
+  auto* a = db_->Lookup("好");
+  auto* b = db_->Lookup("我們");
+  ASSERT_TRUE(a && b);
+  StringId id = a->at[0].text.str_id();
+  EXPECT_EQ(id, b->at[0].text.str_id());
+
+  vector<StringId> ids;
+  db_->LookupTextIds({"的", "沒有"}, &ids);
+  EXPECT_EQ((vector<StringId>{id, kInvalidStringId}), ids);
+  vector<string> texts;
+  db_->GetTexts({id, b->at[1].text.str_id()}, &texts);
+  EXPECT_EQ((vector<string>{"的", "都"}), texts);
+}
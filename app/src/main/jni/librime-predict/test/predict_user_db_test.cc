@@ -0,0 +1,104 @@
+//
+// Copyright RIME Developers
+//
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <rime/common.h>
+#include <rime/dict/level_db.h>
+#include "predict_user_db.h"
+
+using namespace rime;
+
+class PredictUserDbTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    db_ = New<UserDbWrapper<LevelDb>>(path{"predict_user_db_test.userdb"},
+                                      "predict_user_db_test");
+    if (db_->Exists())
+      db_->Remove();
+  }
+
+  void TearDown() override {
+    user_db_.reset();
+    db_->Close();
+    db_->Remove();
+  }
+
+  void Open(size_t max_entries = PredictUserDb::kDefaultMaxEntries) {
+    // saves the metadata of the previous instance.
+    user_db_.reset();
+    user_db_ = New<PredictUserDb>(db_, max_entries);
+    ASSERT_TRUE(user_db_->Load());
+  }
+
+  vector<string> Predict(const string& context, size_t limit) {
+    vector<predict::RawEntry> entries;
+    user_db_->Lookup(context, limit, &entries);
+    vector<string> texts;
+    for (const auto& entry : entries) {
+      texts.push_back(entry.text);
+    }
+    return texts;
+  }
+
+  an<Db> db_;
+  an<PredictUserDb> user_db_;
+};
+
+TEST_F(PredictUserDbTest, RankByWeightBeforeLimit) {
+  Open();
+  // the most frequent follower sorts last by key.
+  for (int i = 0; i < 3; ++i) {
+    ASSERT_TRUE(user_db_->Learn("c", "z"));
+  }
+  for (int i = 0; i < 40; ++i) {
+    ASSERT_TRUE(user_db_->Learn("c", "t" + std::to_string(i)));
+  }
+  ASSERT_TRUE(user_db_->Learn("c", "y"));
+  EXPECT_EQ((vector<string>{"z", "y"}), Predict("c", 2));
+  EXPECT_EQ(41 + 1, Predict("c", 0).size());
+  EXPECT_TRUE(Predict("d", 0).empty());
+}
+
+TEST_F(PredictUserDbTest, EvictLeastLikelyFollowers) {
+  Open();
+  ASSERT_TRUE(user_db_->Learn("c", "frequent"));
+  ASSERT_TRUE(user_db_->Learn("c", "frequent"));
+  const int kFollowers = int(PredictUserDb::kMaxFollowers) + 10;
+  for (int i = 0; i < kFollowers; ++i) {
+    ASSERT_TRUE(user_db_->Learn("c", "t" + std::to_string(i)));
+  }
+  auto followers = Predict("c", 0);
+  ASSERT_EQ(PredictUserDb::kMaxFollowers, followers.size());
+  auto has = [&](const string& text) {
+    return std::find(followers.begin(), followers.end(), text) !=
+           followers.end();
+  };
+  EXPECT_TRUE(has("frequent"));
+  EXPECT_TRUE(has("t" + std::to_string(kFollowers - 1)));
+  EXPECT_FALSE(has("t0"));
+  EXPECT_EQ(PredictUserDb::kMaxFollowers, user_db_->num_entries());
+}
+
+TEST_F(PredictUserDbTest, EvictLeastLikelyEntries) {
+  const size_t kMaxEntries = 100;
+  Open(kMaxEntries);
+  for (int i = 0; i < 3; ++i) {
+    ASSERT_TRUE(user_db_->Learn("c0", "frequent"));
+  }
+  for (size_t i = 1; i <= kMaxEntries * 2; ++i) {
+    ASSERT_TRUE(user_db_->Learn("c" + std::to_string(i), "t"));
+    EXPECT_GE(kMaxEntries, user_db_->num_entries());
+  }
+  EXPECT_EQ((vector<string>{"frequent"}), Predict("c0", 0));
+  EXPECT_EQ((vector<string>{"t"}),
+            Predict("c" + std::to_string(kMaxEntries * 2), 0));
+  EXPECT_TRUE(Predict("c1", 0).empty());
+
+  // the number of entries is kept across loads.
+  size_t num_entries = user_db_->num_entries();
+  TickCount tick = user_db_->tick();
+  Open(kMaxEntries);
+  EXPECT_EQ(num_entries, user_db_->num_entries());
+  EXPECT_EQ(tick, user_db_->tick());
+}
@@ -0,0 +1,77 @@
+//
+// Copyright RIME Developers
+//
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <rime/common.h>
+#include <rime/context.h>
+#include <rime/dict/level_db.h>
+#include "predict_engine.h"
+#include "predict_user_db.h"
+
+using namespace rime;
+using std::chrono::duration;
+using std::chrono::steady_clock;
+
+// usage: bench_predict [num_pairs] [num_contexts]
+// learns (context -> text) pairs into a scratch user db, then measures
+// prediction latency merged with a small static predict db.
+int main(int argc, char* argv[]) {
+  const int num_pairs = argc > 1 ? std::stoi(argv[1]) : 100000;
+  const int num_contexts = argc > 2 ? std::stoi(argv[2]) : 10000;
+
+  predict::RawData data;
+  for (int i = 0; i < 100; ++i) {
+    data["c" + std::to_string(i)].push_back({"s" + std::to_string(i), 1.0});
+  }
+  auto db = New<PredictDb>(path{"bench_predict.db"});
+  if (!db->Build(data) || !db->Save() || !db->Load()) {
+    std::cerr << "failed to build " << db->file_path() << std::endl;
+    return 1;
+  }
+
+  auto leveldb =
+      New<UserDbWrapper<LevelDb>>(path{"bench_predict.userdb"}, "bench");
+  if (leveldb->Exists())
+    leveldb->Remove();
+  auto user_db = New<PredictUserDb>(leveldb);
+  if (!user_db->Load()) {
+    std::cerr << "failed to open " << leveldb->file_path() << std::endl;
+    return 1;
+  }
+
+  auto start = steady_clock::now();
+  for (int i = 0; i < num_pairs; ++i) {
+    user_db->Learn("c" + std::to_string(i % num_contexts),
+                   "t" + std::to_string(i * 7919 % 1000));
+  }
+  duration<double, std::micro> learn_time = steady_clock::now() - start;
+
+  PredictEngine engine(db, user_db, 0, 0);
+  Context ctx;
+  vector<double> latencies;
+  const int kQueries = 10000;
+  latencies.reserve(kQueries);
+  for (int i = 0; i < kQueries; ++i) {
+    string context_query = "c" + std::to_string(i * 31 % num_contexts);
+    auto begin = steady_clock::now();
+    engine.Predict(&ctx, context_query);
+    latencies.push_back(
+        duration<double, std::micro>(steady_clock::now() - begin).count());
+  }
+  std::sort(latencies.begin(), latencies.end());
+  auto percentile = [&](double p) {
+    return latencies[size_t(p * (latencies.size() - 1))];
+  };
+  std::cout << "learned pairs: " << num_pairs << std::endl
+            << "learn: " << learn_time.count() / num_pairs << " us/commit"
+            << std::endl
+            << "predict p50: " << percentile(0.5) << " us" << std::endl
+            << "predict p95: " << percentile(0.95) << " us" << std::endl
+            << "predict p99: " << percentile(0.99) << " us" << std::endl;
+
+  leveldb->Close();
+  leveldb->Remove();
+  return 0;
+}
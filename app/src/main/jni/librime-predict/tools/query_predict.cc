@@ -0,0 +1,33 @@
+//
+// Copyright RIME Developers
+//
+#include <iostream>
+#include <rime/common.h>
+#include "predict_db.h"
+
+using namespace rime;
+
+// usage: query_predict [predict.db] < contexts.txt
+// prints the candidates of each context read from stdin, one per line, as
+// `context<TAB>candidate<TAB>weight`, in the format read by build_predict.
+int main(int argc, char* argv[]) {
+  path file_path = argc > 1 ? path(argv[1]) : path{"predict.db"};
+  PredictDb db(file_path);
+  if (!db.Load()) {
+    std::cerr << "failed to load " << db.file_path() << std::endl;
+    return 1;
+  }
+  string context;
+  while (std::getline(std::cin, context)) {
+    if (context.empty())
+      continue;
+    auto* candidates = db.Lookup(context);
+    if (!candidates)
+      continue;
+    for (const auto* it = candidates->begin(); it != candidates->end(); ++it) {
+      std::cout << context << '\t' << db.GetEntryText(*it) << '\t'
+                << it->weight << std::endl;
+    }
+  }
+  return 0;
+}
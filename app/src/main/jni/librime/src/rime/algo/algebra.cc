@@ -5,7 +5,13 @@
 // 2012-01-19 GONG Chen <chen.sst@gmail.com>
 //
 #include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <fstream>
+#ifndef RIME_NO_THREADING
+#include <thread>
+#endif
+#include <rime/tracer.h>
 #include <rime/algo/algebra.h>
 #include <rime/algo/calculus.h>
 
@@ -51,10 +57,32 @@ void Script::Dump(const path& file_path) const {
   out.close();
 }
 
+Projection::Projection() : cache_(kDefaultCacheCapacity) {}
+
+Projection::Projection(const Projection& other)
+    : calculation_(other.calculation_),
+      cache_(other.cache_.capacity()),
+      num_threads_(other.num_threads_) {}
+
+Projection& Projection::operator=(const Projection& other) {
+  if (this != &other) {
+    calculation_ = other.calculation_;
+    set_cache_capacity(other.cache_.capacity());
+    stats_ = ProjectionStats();
+    num_threads_ = other.num_threads_;
+  }
+  return *this;
+}
+
+void Projection::set_cache_capacity(size_t capacity) {
+  cache_ = LruCache<string, pair<bool, string>>(capacity);
+}
+
 bool Projection::Load(an<ConfigList> settings) {
   if (!settings)
     return false;
   calculation_.clear();
+  cache_.Clear();
   Calculus calc;
   bool success = true;
   for (size_t i = 0; i < settings->size(); ++i) {
@@ -88,6 +116,16 @@ bool Projection::Load(an<ConfigList> settings) {
 bool Projection::Apply(string* value) {
   if (!value || value->empty())
     return false;
+  ++stats_.applications;
+  auto cached = cache_.Find(*value);
+  TraceCacheLookup("spelling_projection", cached);
+  if (cached) {
+    ++stats_.cache_hits;
+    if (cached->first)
+      value->assign(cached->second);
+    return cached->first;
+  }
+  auto start = std::chrono::steady_clock::now();
   bool modified = false;
   Spelling s(*value);
   for (an<Calculation>& x : calculation_) {
@@ -99,39 +137,122 @@ bool Projection::Apply(string* value) {
       return false;
     }
   }
+  stats_.calculation_micros +=
+      std::chrono::duration<double, std::micro>(
+          std::chrono::steady_clock::now() - start)
+          .count();
+  cache_.Insert(*value, {modified, modified ? s.str : string()});
   if (modified)
     value->assign(s.str);
   return modified;
 }
 
+// spellings are not worth a thread of their own below this many.
+static const size_t kMinSpellingsPerThread = 512;
+// lists of spellings longer than this are indexed while merging.
+static const size_t kIndexedListLength = 32;
+
 bool Projection::Apply(Script* value) {
   if (!value || value->empty())
     return false;
+  size_t num_threads = 1;
+#ifndef RIME_NO_THREADING
+  num_threads = num_threads_ > 0 ? num_threads_
+                                 : std::thread::hardware_concurrency();
+#endif
   bool modified = false;
   int round = 0;
   for (an<Calculation>& x : calculation_) {
     ++round;
     DLOG(INFO) << "round #" << round;
-    Script temp;
+    // the calculation is applied to the spellings in parallel, then the
+    // results are merged in the order of the script.
+    vector<const Script::value_type*> entries;
+    entries.reserve(value->size());
     for (const Script::value_type& v : *value) {
-      Spelling s(v.first);
-      bool applied = false;
-      try {
-        applied = x->Apply(&s);
-      } catch (std::runtime_error& e) {
-        LOG(ERROR) << "Error applying calculation: " << e.what();
-        return false;
+      entries.push_back(&v);
+    }
+    vector<Spelling> results(entries.size());
+    vector<char> applied(entries.size());
+    std::atomic<bool> failed{false};
+    auto apply = [&](size_t begin, size_t end) {
+      for (size_t i = begin; i < end && !failed; ++i) {
+        results[i].str = entries[i]->first;
+        try {
+          applied[i] = x->Apply(&results[i]);
+        } catch (std::runtime_error& e) {
+          LOG(ERROR) << "Error applying calculation: " << e.what();
+          failed = true;
+        }
+      }
+    };
+    const size_t num_workers = (std::max)(
+        size_t(1),
+        (std::min)(num_threads, entries.size() / kMinSpellingsPerThread));
+    const size_t chunk = (entries.size() + num_workers - 1) / num_workers;
+#ifndef RIME_NO_THREADING
+    vector<std::thread> workers;
+    for (size_t begin = chunk; begin < entries.size(); begin += chunk) {
+      workers.emplace_back(apply, begin,
+                           (std::min)(begin + chunk, entries.size()));
+    }
+#endif
+    apply(0, (std::min)(chunk, entries.size()));
+#ifndef RIME_NO_THREADING
+    for (auto& worker : workers) {
+      worker.join();
+    }
+#endif
+    if (failed)
+      return false;
+    Script temp;
+    // same as Script::Merge(), but spellings in long lists are found by
+    // index; abbreviations make some of the lists very long.
+    hash_map<string, hash_map<string, size_t>> positions;
+    auto merge = [&](const string& s, const SpellingProperties& sp,
+                     const vector<Spelling>& v) {
+      vector<Spelling>& m(temp[s]);
+      hash_map<string, size_t>* index = nullptr;
+      if (m.size() + v.size() > kIndexedListLength) {
+        index = &positions[s];
+        for (size_t i = index->size(); i < m.size(); ++i) {
+          index->emplace(m[i].str, i);
+        }
+      }
+      for (const Spelling& y : v) {
+        size_t pos = m.size();
+        if (index) {
+          auto found = index->find(y.str);
+          if (found != index->end())
+            pos = found->second;
+        } else {
+          pos = std::find(m.begin(), m.end(), y) - m.begin();
+        }
+        if (pos == m.size()) {
+          if (index)
+            index->emplace(y.str, pos);
+          m.push_back(y);
+          m.back().properties.Compose(sp);
+        } else {
+          SpellingProperties properties(y.properties);
+          properties.Compose(sp);
+          m[pos].properties.Update(properties);
+        }
       }
-      if (applied) {
+    };
+    for (size_t i = 0; i < entries.size(); ++i) {
+      const Script::value_type& v = *entries[i];
+      const Spelling& s = results[i];
+      if (applied[i]) {
         modified = true;
         if (!x->deletion()) {
-          temp.Merge(v.first, SpellingProperties(), v.second);
+          merge(v.first, SpellingProperties(), v.second);
         }
         if (x->addition() && !s.str.empty()) {
-          temp.Merge(s.str, s.properties, v.second);
+          merge(s.str, s.properties, v.second);
         }
       } else {
-        temp.Merge(v.first, SpellingProperties(), v.second);
+        merge(v.first, SpellingProperties(), v.second);
       }
     }
     value->swap(temp);
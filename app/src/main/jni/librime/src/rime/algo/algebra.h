@@ -10,6 +10,7 @@
 
 #include <rime/common.h>
 #include <rime/config.h>
+#include <rime/algo/lru_cache.h>
 #include "spelling.h"
 
 namespace rime {
@@ -26,16 +27,41 @@ class Script : public map<string, vector<Spelling>> {
   void Dump(const path& file_path) const;
 };
 
+struct ProjectionStats {
+  // calls to Apply(string*), and how many of them were answered from cache.
+  size_t applications = 0;
+  size_t cache_hits = 0;
+  // time spent running the calculations on inputs not in cache.
+  double calculation_micros = 0;
+};
+
 class Projection {
  public:
+  // results of Apply(string*) are kept for this many recent inputs.
+  static constexpr size_t kDefaultCacheCapacity = 512;
+
+  RIME_DLL Projection();
+  // copies the calculations; the copy starts with an empty cache.
+  RIME_DLL Projection(const Projection& other);
+  RIME_DLL Projection& operator=(const Projection& other);
   RIME_DLL bool Load(an<ConfigList> settings);
   // "spelling" -> "gnilleps"
   RIME_DLL bool Apply(string* value);
   // {z, y, x} -> {a, b, c, d}
   RIME_DLL bool Apply(Script* value);
 
+  RIME_DLL void set_cache_capacity(size_t capacity);
+  const ProjectionStats& stats() const { return stats_; }
+  // threads applying each calculation to a script; 0 for as many as the
+  // hardware runs concurrently.
+  void set_num_threads(int num_threads) { num_threads_ = num_threads; }
+
  protected:
   vector<of<Calculation>> calculation_;
+  // input -> whether it was modified, and the result.
+  LruCache<string, pair<bool, string>> cache_;
+  ProjectionStats stats_;
+  int num_threads_ = 0;
 };
 
 }  // namespace rime
@@ -81,8 +81,9 @@ bool Transliteration::Apply(Spelling* spelling) {
       modified = false;
       break;
     }
-    if (char_map_.find(c) != char_map_.end()) {
-      c = char_map_[c];
+    auto found = char_map_.find(c);
+    if (found != char_map_.end()) {
+      c = found->second;
       modified = true;
     }
     q = utf8::unchecked::append(c, q);
@@ -94,8 +95,22 @@ bool Transliteration::Apply(Spelling* spelling) {
   return modified;
 }
 
+// patterns without special characters are matched as they are.
+static bool IsLiteral(const string& pattern) {
+  return pattern.find_first_of("\\^$.|?*+()[]{}") == string::npos;
+}
+
 // Transformation
 
+void Transformation::Assign(const string& pattern, const string& replacement) {
+  pattern_.assign(pattern);
+  replacement_.assign(replacement);
+  literal_ = IsLiteral(pattern) &&
+                     replacement.find_first_of("$\\") == string::npos
+                 ? pattern
+                 : string();
+}
+
 Calculation* Transformation::Parse(const vector<string>& args) {
   if (args.size() < 3)
     return NULL;
@@ -104,14 +119,29 @@ Calculation* Transformation::Parse(const vector<string>& args) {
   if (left.empty())
     return NULL;
   the<Transformation> x(new Transformation);
-  x->pattern_.assign(left);
-  x->replacement_.assign(right);
+  x->Assign(left, right);
   return x.release();
 }
 
 bool Transformation::Apply(Spelling* spelling) {
   if (!spelling || spelling->str.empty())
     return false;
+  if (!literal_.empty()) {
+    size_t pos = spelling->str.find(literal_);
+    if (pos == string::npos)
+      return false;
+    string result;
+    size_t last = 0;
+    for (; pos != string::npos; pos = spelling->str.find(literal_, last)) {
+      result.append(spelling->str, last, pos - last).append(replacement_);
+      last = pos + literal_.length();
+    }
+    result.append(spelling->str, last, string::npos);
+    if (result == spelling->str)
+      return false;
+    spelling->str.swap(result);
+    return true;
+  }
   string result = boost::regex_replace(spelling->str, pattern_, replacement_);
   if (result == spelling->str)
     return false;
@@ -129,13 +159,16 @@ Calculation* Erasion::Parse(const vector<string>& args) {
     return NULL;
   the<Erasion> x(new Erasion);
   x->pattern_.assign(pattern);
+  if (IsLiteral(pattern))
+    x->literal_ = pattern;
   return x.release();
 }
 
 bool Erasion::Apply(Spelling* spelling) {
   if (!spelling || spelling->str.empty())
     return false;
-  if (!boost::regex_match(spelling->str, pattern_))
+  if (!literal_.empty() ? spelling->str != literal_
+                        : !boost::regex_match(spelling->str, pattern_))
     return false;
   spelling->str.clear();
   return true;
@@ -157,30 +190,26 @@ Calculation* Derivation::Parse(const vector<string>& args) {
     // 糾錯
     if (tag == "correction") {
       the<Correction> x(new Correction);
-      x->pattern_.assign(left);
-      x->replacement_.assign(right);
+      x->Assign(left, right);
       return x.release();
     }
     // 簡拼
     if (tag == "abbrev") {
       the<Abbreviation> x(new Abbreviation);
-      x->pattern_.assign(left);
-      x->replacement_.assign(right);
+      x->Assign(left, right);
       return x.release();
     }
     // 模糊音
     if (tag == "fuzz") {
       the<Fuzzing> x(new Fuzzing);
-      x->pattern_.assign(left);
-      x->replacement_.assign(right);
+      x->Assign(left, right);
       return x.release();
     }
     // tag 無法識別, 作爲普通 derive 處理
   }
 
   the<Derivation> x(new Derivation);
-  x->pattern_.assign(left);
-  x->replacement_.assign(right);
+  x->Assign(left, right);
   return x.release();
 }
 
@@ -194,8 +223,7 @@ Calculation* Fuzzing::Parse(const vector<string>& args) {
   if (left.empty())
     return NULL;
   the<Fuzzing> x(new Fuzzing);
-  x->pattern_.assign(left);
-  x->replacement_.assign(right);
+  x->Assign(left, right);
   return x.release();
 }
 
@@ -218,8 +246,7 @@ Calculation* Abbreviation::Parse(const vector<string>& args) {
   if (left.empty())
     return NULL;
   the<Abbreviation> x(new Abbreviation);
-  x->pattern_.assign(left);
-  x->replacement_.assign(right);
+  x->Assign(left, right);
   return x.release();
 }
 
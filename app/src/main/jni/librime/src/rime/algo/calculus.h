@@ -54,8 +54,12 @@ class Transformation : public Calculation {
   bool Apply(Spelling* spelling) override;
 
  protected:
+  void Assign(const string& pattern, const string& replacement);
+
   boost::regex pattern_;
   string replacement_;
+  // the pattern, if it can be replaced without running the regex.
+  string literal_;
 };
 
 // erase/x/
@@ -67,6 +71,8 @@ class Erasion : public Calculation {
 
  protected:
   boost::regex pattern_;
+  // the pattern, if it matches nothing but itself.
+  string literal_;
 };
 
 // derive/x/X/
@@ -0,0 +1,74 @@
+//
+// Copyright RIME Developers
+// Distributed under the BSD License
+//
+#ifndef RIME_LRU_CACHE_H_
+#define RIME_LRU_CACHE_H_
+
+#include <rime/common.h>
+
+namespace rime {
+
+// A bounded map that evicts the least recently used entry when full.
+// Not thread-safe; callers sharing an instance must serialize access.
+template <class K, class V>
+class LruCache {
+ public:
+  explicit LruCache(size_t capacity) : capacity_(capacity) {}
+  LruCache(const LruCache&) = delete;
+  LruCache& operator=(const LruCache&) = delete;
+  LruCache(LruCache&&) = default;
+  LruCache& operator=(LruCache&&) = default;
+
+  // Returns the cached value and marks it as most recently used, or nullptr.
+  // The pointer is valid until the next call to Insert() or Clear().
+  const V* Find(const K& key) {
+    auto found = index_.find(key);
+    if (found == index_.end()) {
+      ++misses_;
+      return nullptr;
+    }
+    ++hits_;
+    items_.splice(items_.begin(), items_, found->second);
+    return &found->second->second;
+  }
+
+  void Insert(const K& key, V value) {
+    if (capacity_ == 0)
+      return;
+    auto found = index_.find(key);
+    if (found != index_.end()) {
+      found->second->second = std::move(value);
+      items_.splice(items_.begin(), items_, found->second);
+      return;
+    }
+    if (items_.size() >= capacity_) {
+      index_.erase(items_.back().first);
+      items_.pop_back();
+    }
+    items_.emplace_front(key, std::move(value));
+    index_[key] = items_.begin();
+  }
+
+  void Clear() {
+    index_.clear();
+    items_.clear();
+  }
+
+  size_t size() const { return items_.size(); }
+  size_t capacity() const { return capacity_; }
+  size_t hits() const { return hits_; }
+  size_t misses() const { return misses_; }
+
+ private:
+  using Item = pair<K, V>;
+  size_t capacity_;
+  size_t hits_ = 0;
+  size_t misses_ = 0;
+  list<Item> items_;
+  hash_map<K, typename list<Item>::iterator> index_;
+};
+
+}  // namespace rime
+
+#endif  // RIME_LRU_CACHE_H_
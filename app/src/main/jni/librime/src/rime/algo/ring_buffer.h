@@ -0,0 +1,100 @@
+//
+// Copyright RIME Developers
+// Distributed under the BSD License
+//
+#ifndef RIME_RING_BUFFER_H_
+#define RIME_RING_BUFFER_H_
+
+#include <atomic>
+#include <rime/common.h>
+
+namespace rime {
+
+// A bounded lock-free queue, safe for any number of producer and consumer
+// threads. Each slot carries a sequence number telling whether it is ready
+// to be written or read in the current lap around the buffer.
+template <class T>
+class RingBuffer {
+ public:
+  // capacity is rounded up to a power of 2.
+  explicit RingBuffer(size_t capacity) {
+    size_t size = 2;
+    while (size < capacity)
+      size <<= 1;
+    mask_ = size - 1;
+    slots_.reset(new Slot[size]);
+    for (size_t i = 0; i < size; ++i) {
+      slots_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+  RingBuffer(const RingBuffer&) = delete;
+  RingBuffer& operator=(const RingBuffer&) = delete;
+
+  // returns false if the buffer is full, leaving the value untouched so that
+  // the caller may try again; it is moved only into a claimed slot.
+  bool TryPush(T&& value) {
+    size_t pos = tail_.load(std::memory_order_relaxed);
+    Slot* slot;
+    while (true) {
+      slot = &slots_[pos & mask_];
+      size_t sequence = slot->sequence.load(std::memory_order_acquire);
+      intptr_t diff = intptr_t(sequence) - intptr_t(pos);
+      if (diff == 0) {
+        if (tail_.compare_exchange_weak(pos, pos + 1,
+                                        std::memory_order_relaxed))
+          break;
+      } else if (diff < 0) {
+        return false;
+      } else {
+        pos = tail_.load(std::memory_order_relaxed);
+      }
+    }
+    slot->value = std::move(value);
+    slot->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+  }
+
+  // returns false if the buffer is empty.
+  bool TryPop(T* value) {
+    size_t pos = head_.load(std::memory_order_relaxed);
+    Slot* slot;
+    while (true) {
+      slot = &slots_[pos & mask_];
+      size_t sequence = slot->sequence.load(std::memory_order_acquire);
+      intptr_t diff = intptr_t(sequence) - intptr_t(pos + 1);
+      if (diff == 0) {
+        if (head_.compare_exchange_weak(pos, pos + 1,
+                                        std::memory_order_relaxed))
+          break;
+      } else if (diff < 0) {
+        return false;
+      } else {
+        pos = head_.load(std::memory_order_relaxed);
+      }
+    }
+    *value = std::move(slot->value);
+    slot->sequence.store(pos + mask_ + 1, std::memory_order_release);
+    return true;
+  }
+
+  bool empty() const {
+    return head_.load(std::memory_order_acquire) ==
+           tail_.load(std::memory_order_acquire);
+  }
+  size_t capacity() const { return mask_ + 1; }
+
+ private:
+  struct Slot {
+    std::atomic<size_t> sequence;
+    T value;
+  };
+  size_t mask_;
+  the<Slot[]> slots_;
+  // kept apart to avoid false sharing between producers and consumers.
+  alignas(64) std::atomic<size_t> head_{0};
+  alignas(64) std::atomic<size_t> tail_{0};
+};
+
+}  // namespace rime
+
+#endif  // RIME_RING_BUFFER_H_
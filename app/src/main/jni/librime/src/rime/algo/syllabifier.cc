@@ -65,7 +65,8 @@ int Syllabifier::BuildSyllableGraph(const string& input,
         exact_match_syllables.insert(m.value);
       }
       Corrections corrections;
-      corrector_->ToleranceSearch(prism, current_input, &corrections, 5);
+      corrector_->ToleranceSearch(prism, current_input, &corrections,
+                                  kDefaultTolerance);
       for (const auto& m : corrections) {
         for (auto accessor = prism.QuerySpelling(m.first);
              !accessor.exhausted(); accessor.Next()) {
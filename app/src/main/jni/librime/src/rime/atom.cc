@@ -0,0 +1,70 @@
+//
+// Copyright RIME Developers
+// Distributed under the BSD License
+//
+#include <bitset>
+#include <mutex>
+#include <rime/atom.h>
+
+namespace rime {
+
+Atom AtomTable::Intern(const string& name) {
+  Atom atom = Find(name);
+  if (atom != kNone)
+    return atom;
+  std::unique_lock<std::shared_mutex> lock(mutex_);
+  auto inserted = atoms_.emplace(name, Atom(names_.size()));
+  if (inserted.second)
+    names_.push_back(name);
+  return inserted.first->second;
+}
+
+Atom AtomTable::Find(const string& name) const {
+  std::shared_lock<std::shared_mutex> lock(mutex_);
+  auto found = atoms_.find(name);
+  return found != atoms_.end() ? found->second : kNone;
+}
+
+const string& AtomTable::NameOf(Atom atom) const {
+  static const string kEmpty;
+  std::shared_lock<std::shared_mutex> lock(mutex_);
+  return atom < names_.size() ? names_[atom] : kEmpty;
+}
+
+size_t AtomTable::size() const {
+  std::shared_lock<std::shared_mutex> lock(mutex_);
+  return names_.size();
+}
+
+AtomTable& AtomTable::options() {
+  static AtomTable table;
+  return table;
+}
+
+AtomTable& AtomTable::tags() {
+  static AtomTable table;
+  return table;
+}
+
+size_t AtomSet::size() const {
+  size_t count = std::bitset<64>(low_).count();
+  for (uint64_t word : high_) {
+    count += std::bitset<64>(word).count();
+  }
+  return count;
+}
+
+bool AtomSet::operator==(const AtomSet& other) const {
+  if (low_ != other.low_)
+    return false;
+  size_t n = (std::max)(high_.size(), other.high_.size());
+  for (size_t i = 0; i < n; ++i) {
+    uint64_t a = i < high_.size() ? high_[i] : 0;
+    uint64_t b = i < other.high_.size() ? other.high_[i] : 0;
+    if (a != b)
+      return false;
+  }
+  return true;
+}
+
+}  // namespace rime
@@ -0,0 +1,136 @@
+//
+// Copyright RIME Developers
+// Distributed under the BSD License
+//
+#ifndef RIME_ATOM_H_
+#define RIME_ATOM_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <shared_mutex>
+#include <rime_api.h>
+#include <rime/common.h>
+
+namespace rime {
+
+// a small integer standing for a name, such as an option or a tag.
+using Atom = uint32_t;
+
+// process-wide table of names turned into atoms, numbered from 0 in the order
+// they are first seen. atoms are never released.
+class RIME_DLL AtomTable {
+ public:
+  static constexpr Atom kNone = ~Atom(0);
+
+  Atom Intern(const string& name);
+  // returns kNone if the name has never been interned.
+  Atom Find(const string& name) const;
+  const string& NameOf(Atom atom) const;
+  size_t size() const;
+
+  // separate tables keep the atoms of each kind few and dense.
+  static AtomTable& options();
+  static AtomTable& tags();
+
+ private:
+  mutable std::shared_mutex mutex_;
+  hash_map<string, Atom> atoms_;
+  // references to names stay valid as the table grows.
+  std::deque<string> names_;
+};
+
+// a set of atoms stored as a bitmap; the first 64 atoms take no allocation.
+class RIME_DLL AtomSet {
+ public:
+  bool Contains(Atom atom) const {
+    if (atom < 64)
+      return (low_ >> atom) & 1;
+    size_t word = atom / 64 - 1;
+    return word < high_.size() && ((high_[word] >> (atom % 64)) & 1);
+  }
+  // returns false if already in the set.
+  bool Insert(Atom atom) {
+    uint64_t* word = &low_;
+    if (atom >= 64) {
+      size_t index = atom / 64 - 1;
+      if (index >= high_.size())
+        high_.resize(index + 1);
+      word = &high_[index];
+    }
+    uint64_t bit = uint64_t(1) << (atom % 64);
+    if (*word & bit)
+      return false;
+    *word |= bit;
+    return true;
+  }
+  // returns false if not in the set.
+  bool Erase(Atom atom) {
+    if (!Contains(atom))
+      return false;
+    uint64_t bit = uint64_t(1) << (atom % 64);
+    (atom < 64 ? low_ : high_[atom / 64 - 1]) &= ~bit;
+    return true;
+  }
+  void Clear() {
+    low_ = 0;
+    high_.clear();
+  }
+  void Merge(const AtomSet& other) {
+    low_ |= other.low_;
+    if (high_.size() < other.high_.size())
+      high_.resize(other.high_.size());
+    for (size_t i = 0; i < other.high_.size(); ++i) {
+      high_[i] |= other.high_[i];
+    }
+  }
+  bool Intersects(const AtomSet& other) const {
+    if (low_ & other.low_)
+      return true;
+    size_t n = (std::min)(high_.size(), other.high_.size());
+    for (size_t i = 0; i < n; ++i) {
+      if (high_[i] & other.high_[i])
+        return true;
+    }
+    return false;
+  }
+  bool empty() const {
+    return !low_ && std::all_of(high_.begin(), high_.end(),
+                                [](uint64_t word) { return !word; });
+  }
+  size_t size() const;
+
+  // returns the least atom in the set no less than from, or
+  // AtomTable::kNone.
+  Atom Next(Atom from) const {
+    Atom limit = Atom(64 * (high_.size() + 1));
+    for (Atom atom = from; atom < limit; ++atom) {
+      if (Contains(atom))
+        return atom;
+    }
+    return AtomTable::kNone;
+  }
+
+  // visits atoms in ascending order.
+  template <class F>
+  void ForEach(F f) const {
+    for (size_t i = 0; i <= high_.size(); ++i) {
+      uint64_t word = i == 0 ? low_ : high_[i - 1];
+      for (Atom atom = Atom(i * 64); word; word >>= 1, ++atom) {
+        if (word & 1)
+          f(atom);
+      }
+    }
+  }
+
+  bool operator==(const AtomSet& other) const;
+  bool operator!=(const AtomSet& other) const { return !(*this == other); }
+
+ private:
+  uint64_t low_ = 0;
+  vector<uint64_t> high_;
+};
+
+}  // namespace rime
+
+#endif  // RIME_ATOM_H_
@@ -12,6 +12,8 @@
 
 namespace rime {
 
+static const Atom kPhonyTag = AtomTable::tags().Intern("phony");
+
 bool Composition::HasFinishedComposition() const {
   if (empty())
     return false;
@@ -40,7 +42,7 @@ Preedit Composition::GetPreedit(const string& full_input,
         preedit.text += cand->text();
       } else {  // raw input
         end = at(i).end;
-        if (!at(i).HasTag("phony")) {
+        if (!at(i).HasTag(kPhonyTag)) {
           preedit.text += input_.substr(start, end - start);
         }
       }
@@ -108,7 +110,7 @@ string Composition::GetCommitText() const {
       result += cand->text();
     } else {
       end = seg.end;
-      if (!seg.HasTag("phony")) {
+      if (!seg.HasTag(kPhonyTag)) {
         result += input_.substr(seg.start, seg.end - seg.start);
       }
     }
@@ -132,7 +134,7 @@ string Composition::GetScriptText(bool keep_selection) const {
       result += cand->text();
     else if (cand && !cand->preedit().empty())
       result += boost::erase_first_copy(cand->preedit(), "\t");
-    else if (!seg.HasTag("phony"))
+    else if (!seg.HasTag(kPhonyTag))
       result += input_.substr(start, end - start);
   }
   if (input_.length() > end) {
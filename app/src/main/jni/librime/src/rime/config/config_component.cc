@@ -181,15 +181,41 @@ Config* ConfigComponentBase::Create(const string& file_name) {
 
 an<ConfigData> ConfigComponentBase::GetConfigData(const string& file_name) {
   auto config_id = resource_resolver_->ToResourceId(file_name);
-  // keep a weak reference to the shared config data in the component
-  weak<ConfigData>& wp(cache_[config_id]);
-  if (wp.expired()) {  // create a new copy and load it
-    auto data = LoadConfig(config_id);
-    wp = data;
-    return data;
+  std::promise<an<ConfigData>> loaded;
+  std::shared_future<an<ConfigData>> loading;
+  {
+    std::lock_guard<std::mutex> lock(cache_mutex_);
+    // keep a weak reference to the shared config data in the component
+    if (auto data = cache_[config_id].lock())
+      return data;
+    auto found = loading_.find(config_id);
+    if (found != loading_.end())
+      loading = found->second;
+    else
+      loading_[config_id] = loaded.get_future().share();
   }
-  // obtain the shared copy
-  return wp.lock();
+  // another thread is loading the same config.
+  if (loading.valid())
+    return loading.get();
+  // create a new copy and load it
+  an<ConfigData> data;
+  try {
+    data = LoadConfig(config_id);
+  } catch (...) {
+    {
+      std::lock_guard<std::mutex> lock(cache_mutex_);
+      loading_.erase(config_id);
+    }
+    loaded.set_exception(std::current_exception());
+    throw;
+  }
+  {
+    std::lock_guard<std::mutex> lock(cache_mutex_);
+    cache_[config_id] = data;
+    loading_.erase(config_id);
+  }
+  loaded.set_value(data);
+  return data;
 }
 
 an<ConfigData> ConfigLoader::LoadConfig(ResourceResolver* resource_resolver,
@@ -7,7 +7,9 @@
 #ifndef RIME_CONFIG_COMPONENT_H_
 #define RIME_CONFIG_COMPONENT_H_
 
+#include <future>
 #include <iostream>
+#include <mutex>
 #include <type_traits>
 #include <rime/common.h>
 #include <rime/component.h>
@@ -103,6 +105,11 @@ class ConfigComponentBase : public Config::Component {
  private:
   an<ConfigData> GetConfigData(const string& file_name);
   map<string, weak<ConfigData>> cache_;
+  // configs being loaded, for other threads to wait for rather than load
+  // them again.
+  map<string, std::shared_future<an<ConfigData>>> loading_;
+  // not held while loading, which may take long and require other configs.
+  std::mutex cache_mutex_;
 };
 
 template <class Loader, class ResourceProvider = ConfigResourceProvider>
@@ -26,7 +26,8 @@ bool Context::Commit() {
 }
 
 string Context::GetCommitText() const {
-  if (get_option("dumb"))
+  static const Atom kDumb = AtomTable::options().Intern("dumb");
+  if (get_option(kDumb))
     return string();
   return composition_.GetCommitText();
 }
@@ -38,7 +39,8 @@ string Context::GetScriptText() const {
 static const string kCaretSymbol("\xe2\x80\xb8");  // U+2038 ‸ CARET
 
 string Context::GetSoftCursor() const {
-  return get_option("soft_cursor") ? kCaretSymbol : string();
+  static const Atom kSoftCursor = AtomTable::options().Intern("soft_cursor");
+  return get_option(kSoftCursor) ? kCaretSymbol : string();
 }
 
 Preedit Context::GetPreedit() const {
@@ -284,17 +286,31 @@ void Context::set_input(const string& value) {
 }
 
 void Context::set_option(const string& name, bool value) {
-  options_[name] = value;
+  set_option(AtomTable::options().Intern(name), value);
+}
+
+void Context::set_option(Atom option, bool value) {
+  options_.Insert(option);
+  if (value)
+    enabled_options_.Insert(option);
+  else
+    enabled_options_.Erase(option);
+  const string& name = AtomTable::options().NameOf(option);
   DLOG(INFO) << "Context::set_option " << name << " = " << value;
   option_update_notifier_(this, name);
 }
 
 bool Context::get_option(const string& name) const {
-  auto it = options_.find(name);
-  if (it != options_.end())
-    return it->second;
-  else
-    return false;
+  Atom option = AtomTable::options().Find(name);
+  return option != AtomTable::kNone && get_option(option);
+}
+
+map<string, bool> Context::options() const {
+  map<string, bool> result;
+  options_.ForEach([&](Atom option) {
+    result[AtomTable::options().NameOf(option)] = get_option(option);
+  });
+  return result;
 }
 
 void Context::set_property(const string& name, const string& value) {
@@ -312,10 +328,17 @@ string Context::get_property(const string& name) const {
 
 void Context::ClearTransientOptions() {
   DLOG(INFO) << "Context::ClearTransientOptions";
-  auto opt = options_.lower_bound("_");
-  while (opt != options_.end() && !opt->first.empty() && opt->first[0] == '_') {
-    DLOG(INFO) << "cleared opption: " << opt->first;
-    options_.erase(opt++);
+  vector<Atom> transient;
+  options_.ForEach([&](Atom option) {
+    const string& name = AtomTable::options().NameOf(option);
+    if (!name.empty() && name[0] == '_') {
+      DLOG(INFO) << "cleared opption: " << name;
+      transient.push_back(option);
+    }
+  });
+  for (Atom option : transient) {
+    options_.Erase(option);
+    enabled_options_.Erase(option);
   }
   auto prop = properties_.lower_bound("_");
   while (prop != properties_.end() && !prop->first.empty() &&
@@ -7,6 +7,7 @@
 #ifndef RIME_CONTEXT_H_
 #define RIME_CONTEXT_H_
 
+#include <rime/atom.h>
 #include <rime/common.h>
 #include <rime/commit_history.h>
 #include <rime/composition.h>
@@ -74,9 +75,14 @@ class RIME_DLL Context {
 
   void set_option(const string& name, bool value);
   bool get_option(const string& name) const;
+  // options interned in AtomTable::options(), saving string compares.
+  void set_option(Atom option, bool value);
+  bool get_option(Atom option) const {
+    return enabled_options_.Contains(option);
+  }
   void set_property(const string& name, const string& value);
   string get_property(const string& name) const;
-  const map<string, bool>& options() const { return options_; }
+  map<string, bool> options() const;
   const map<string, string>& properties() const { return properties_; }
   // options and properties starting with '_' are local to schema;
   // others are session scoped.
@@ -102,7 +108,9 @@ class RIME_DLL Context {
   size_t caret_pos_ = 0;
   Composition composition_;
   CommitHistory commit_history_;
-  map<string, bool> options_;
+  // options ever set, and those of them turned on.
+  AtomSet options_;
+  AtomSet enabled_options_;
   map<string, string> properties_;
 
   Notifier commit_notifier_;
@@ -4,8 +4,12 @@
 //
 // 2011-12-01 GONG Chen <chen.sst@gmail.com>
 //
+#include <algorithm>
 #include <chrono>
+#include <condition_variable>
+#include <deque>
 #include <exception>
+#include <thread>
 #include <utility>
 #include <rime/common.h>
 #include <rime/deployer.h>
@@ -103,6 +107,92 @@ bool Deployer::Run() {
   return !failure;
 }
 
+static bool RunJob(Deployer* deployer, const an<DeploymentTask>& task) {
+  try {
+    return task && task->Run(deployer);
+  } catch (const std::exception& ex) {
+    LOG(ERROR) << "Error deploying: " << ex.what();
+    return false;
+  }
+}
+
+bool Deployer::RunJobs(const vector<DeploymentJob>& jobs) {
+  const size_t n = jobs.size();
+  // number of unfinished dependencies of each job.
+  vector<size_t> waiting(n);
+  vector<vector<size_t>> dependents(n);
+  std::deque<size_t> ready;
+  for (size_t i = 0; i < n; ++i) {
+    for (size_t d : jobs[i].dependencies) {
+      // only earlier jobs count, which rules out cycles.
+      if (d < i) {
+        ++waiting[i];
+        dependents[d].push_back(i);
+      }
+    }
+    if (!waiting[i])
+      ready.push_back(i);
+  }
+  std::mutex mutex;
+  std::condition_variable cv;
+  size_t finished = 0;
+  size_t failure = 0;
+  auto work = [&] {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+      cv.wait(lock, [&] { return !ready.empty() || finished == n; });
+      if (ready.empty())
+        return;
+      size_t i = ready.front();
+      ready.pop_front();
+      lock.unlock();
+      bool success = RunJob(this, jobs[i].task);
+      lock.lock();
+      if (!success)
+        ++failure;
+      ++finished;
+      for (size_t j : dependents[i]) {
+        if (--waiting[j] == 0)
+          ready.push_back(j);
+      }
+      cv.notify_all();
+    }
+  };
+#ifdef RIME_NO_THREADING
+  work();
+#else
+  size_t num_workers = (std::min)(n, size_t(max_workers()));
+  LOG(INFO) << "running " << n << " jobs on " << num_workers << " workers.";
+  vector<std::thread> workers;
+  for (size_t i = 1; i < num_workers; ++i) {
+    workers.emplace_back(work);
+  }
+  work();
+  for (auto& worker : workers) {
+    worker.join();
+  }
+#endif
+  return !failure;
+}
+
+std::unique_lock<std::mutex> Deployer::LockOutput(const string& output) {
+  std::mutex* output_mutex;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& m = output_mutexes_[output];
+    if (!m)
+      m.reset(new std::mutex);
+    output_mutex = m.get();
+  }
+  return std::unique_lock<std::mutex>(*output_mutex);
+}
+
+int Deployer::max_workers() const {
+  if (max_workers_ > 0)
+    return max_workers_;
+  return (std::max)(1u, std::thread::hardware_concurrency());
+}
+
 bool Deployer::StartWork(bool maintenance_mode) {
   if (IsWorking()) {
     LOG(WARNING) << "a work thread is already running.";
@@ -29,6 +29,13 @@ class DeploymentTask : public Class<DeploymentTask, TaskInitializer> {
   virtual bool Run(Deployer* deployer) = 0;
 };
 
+// a task to run on the worker pool, after the tasks it depends on.
+struct DeploymentJob {
+  an<DeploymentTask> task;
+  // indices of jobs listed before this one.
+  vector<size_t> dependencies;
+};
+
 class Deployer : public Messenger {
  public:
   // read-only access after library initialization {
@@ -57,6 +64,14 @@ class Deployer : public Messenger {
   bool HasPendingTasks();
 
   bool Run();
+  // runs the jobs on a pool of at most max_workers() threads, including the
+  // calling thread; a job starts once the jobs it depends on have finished.
+  // returns true if all jobs succeeded.
+  bool RunJobs(const vector<DeploymentJob>& jobs);
+  // serializes jobs producing the same output, e.g. a dictionary shared by
+  // several schemas, so that the later ones find the output up to date.
+  std::unique_lock<std::mutex> LockOutput(const string& output);
+
   bool StartWork(bool maintenance_mode = false);
   bool StartMaintenance();
   bool IsWorking();
@@ -67,9 +82,15 @@ class Deployer : public Messenger {
 
   path user_data_sync_dir() const;
 
+  // 0 (default) picks the number of hardware threads.
+  int max_workers() const;
+  void set_max_workers(int max_workers) { max_workers_ = max_workers; }
+
  private:
   std::queue<of<DeploymentTask>> pending_tasks_;
   std::mutex mutex_;
+  map<string, the<std::mutex>> output_mutexes_;
+  int max_workers_ = 0;
   std::future<void> work_;
   bool maintenance_mode_ = false;
 };
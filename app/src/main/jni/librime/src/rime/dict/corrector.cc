@@ -12,6 +12,7 @@
 #include <rime/schema.h>
 #include <rime/service.h>
 #include <rime/ticket.h>
+#include <rime/dict/dictionary.h>
 
 using namespace rime;
 using namespace corrector;
@@ -243,6 +244,109 @@ bool EditDistanceCorrector::Build(const Syllabary& syllabary,
 EditDistanceCorrector::EditDistanceCorrector(const path& file_path)
     : Prism(file_path) {}
 
+void KeyboardTypoCollector::CollectTypos(
+    const string& origin,
+    const hash_map<char, string>& typed_for,
+    size_t from,
+    size_t max_typos,
+    string* typo,
+    Script* script) {
+  for (size_t i = from; i < origin.length(); ++i) {
+    auto found = typed_for.find(origin[i]);
+    if (found == typed_for.end())
+      continue;
+    for (char key : found->second) {
+      (*typo)[i] = key;
+      Spelling spelling(origin);
+      spelling.properties.tips = origin;
+      spelling.properties.is_correction = true;
+      (*script)[*typo].push_back(spelling);
+      if (max_typos > 1 && prism_keys_.find(*typo) == prism_keys_.end()) {
+        CollectTypos(origin, typed_for, i + 1, max_typos - 1, typo, script);
+      }
+    }
+    (*typo)[i] = origin[i];
+  }
+}
+
+Script KeyboardTypoCollector::Collect(size_t max_typos) {
+  // keys that may be hit by mistake for each key on the keyboard.
+  hash_map<char, string> typed_for;
+  for (const auto& k : keyboard_map) {
+    for (char neighbor : k.second) {
+      typed_for[neighbor].push_back(k.first);
+    }
+  }
+  Script script;
+  max_typos = (std::min)(max_typos, kMaxIndexedTypos);
+  if (max_typos == 0)
+    return script;
+  for (const auto& spelling : spellings_) {
+    string typo = spelling;
+    CollectTypos(spelling, typed_for, 0, max_typos, &typo, &script);
+  }
+  return script;
+}
+
+TypoIndexCorrector::TypoIndexCorrector(const path& file_path)
+    : Prism(file_path) {}
+
+bool TypoIndexCorrector::Build(const Syllabary& syllabary,
+                               const Script* script,
+                               uint32_t dict_file_checksum,
+                               uint32_t schema_file_checksum) {
+  // only normal spellings are suggested as corrections.
+  Syllabary spellings;
+  Syllabary prism_keys;
+  if (script && !script->empty()) {
+    for (const auto& v : *script) {
+      prism_keys.insert(v.first);
+      if (std::any_of(v.second.begin(), v.second.end(),
+                      [](const Spelling& s) {
+                        return s.properties.type == kNormalSpelling &&
+                               !s.properties.is_correction;
+                      })) {
+        spellings.insert(v.first);
+      }
+    }
+  } else {
+    spellings = prism_keys = syllabary;
+  }
+  KeyboardTypoCollector collector(spellings, prism_keys);
+  auto typos = collector.Collect(kMaxIndexedTypos);
+  if (typos.empty())
+    return false;
+  return Prism::Build(spellings, &typos, dict_file_checksum,
+                      schema_file_checksum);
+}
+
+void TypoIndexCorrector::ToleranceSearch(const Prism& prism,
+                                         const string& key,
+                                         Corrections* results,
+                                         size_t tolerance) {
+  if (key.empty())
+    return;
+  vector<Prism::Match> matches;
+  CommonPrefixSearch(key, &matches);
+  for (const auto& m : matches) {
+    for (auto accessor = QuerySpelling(m.value); !accessor.exhausted();
+         accessor.Next()) {
+      // typos are of the same length as the spelling meant for.
+      auto origin = accessor.properties().tips;
+      Distance distance = 0;
+      for (size_t i = 0; i < m.length; ++i) {
+        distance += origin[i] != key[i];
+      }
+      if (distance > tolerance)
+        continue;
+      SyllableId corrected;
+      if (prism.GetValue(origin, &corrected)) {
+        results->Alter(corrected, {distance, corrected, m.length});
+      }
+    }
+  }
+}
+
 void NearSearchCorrector::ToleranceSearch(const Prism& prism,
                                           const string& key,
                                           Corrections* results,
@@ -296,26 +400,37 @@ void CorrectorComponent::Unified::ToleranceSearch(const Prism& prism,
 }
 CorrectorComponent::CorrectorComponent()
     : resolver_(Service::instance().CreateDeployedResourceResolver(
-          {"corrector", "", ".correction.bin"})) {}
+          {"corrector", "", ".correction.bin"})),
+      prism_resolver_(Service::instance().CreateDeployedResourceResolver(
+          {"prism", "", ".prism.bin"})) {}
 
 Corrector* CorrectorComponent::Create(const Ticket& ticket) noexcept {
-  // Don't use edit distance based correction for now.
-#if 0
-  if (!ticket.schema) return nullptr;
-  Config* config = ticket.schema->config();
-  string prism_name;
-  if (!config->GetString(ticket.name_space + "/prism", &prism_name)) {
-    config->GetString(ticket.name_space + "/dictionary", &prism_name);
-  }
-
-  auto file_path = resolver_->ResolvePath(prism_name);
-
-  auto ed_corrector = New<EditDistanceCorrector>(file_path);
-  if (ed_corrector->Load()) {
-    return Combine(New<NearSearchCorrector>(), ed_corrector);
-  } else {
-    return new NearSearchCorrector();
+  if (ticket.schema) {
+    Config* config = ticket.schema->config();
+    string prism_name;
+    if (!config->GetString(ticket.name_space + "/prism", &prism_name)) {
+      config->GetString(ticket.name_space + "/dictionary", &prism_name);
+    }
+    if (!prism_name.empty()) {
+      auto file_path = resolver_->ResolvePath(prism_name);
+      the<TypoIndexCorrector> typo_index(new TypoIndexCorrector(file_path));
+      typo_index->set_hot_pages_file_path(
+          DictionaryComponent::HotPagesFilePath(file_path));
+      if (typo_index->Exists() && typo_index->Load()) {
+        // built along with the prism; a stale index suggests spellings the
+        // prism may not have.
+        Prism prism(prism_resolver_->ResolvePath(prism_name));
+        prism.set_load_policy(0);
+        if (prism.Load() &&
+            prism.dict_file_checksum() == typo_index->dict_file_checksum() &&
+            prism.schema_file_checksum() ==
+                typo_index->schema_file_checksum()) {
+          return typo_index.release();
+        }
+        LOG(WARNING) << "typo index does not match prism: " << prism_name;
+      }
+    }
   }
-#endif
+  // the index is missing or stale; search near keys at each position instead.
   return new NearSearchCorrector();
 }
@@ -31,6 +31,11 @@ class SymDeleteCollector {
 
 namespace corrector {
 using Distance = size_t;
+// most typos tolerated in a spelling when searching for corrections.
+constexpr Distance kDefaultTolerance = 5;
+// most typos in a spelling kept in a typo index; with more, the typos of a
+// short spelling cover much of the keyboard, and their number explodes.
+constexpr Distance kMaxIndexedTypos = 2;
 struct Correction {
   size_t distance;
   SyllableId syllable;
@@ -50,6 +55,31 @@ class Corrections : public hash_map<SyllableId, Correction> {
 };
 }  // namespace corrector
 
+// collects spellings as they would be typed with up to kMaxIndexedTypos keys
+// swapped for an adjacent key on the keyboard, each with the spelling meant
+// for in tips.
+// a typo that is itself one of prism_keys gets no further typos: those are
+// closer to that spelling, and are collected as its own typos.
+class KeyboardTypoCollector {
+ public:
+  KeyboardTypoCollector(const Syllabary& spellings,
+                        const Syllabary& prism_keys)
+      : spellings_(spellings), prism_keys_(prism_keys) {}
+
+  Script Collect(size_t max_typos);
+
+ private:
+  void CollectTypos(const string& origin,
+                    const hash_map<char, string>& typed_for,
+                    size_t from,
+                    size_t max_typos,
+                    string* typo,
+                    Script* script);
+
+  const Syllabary& spellings_;
+  const Syllabary& prism_keys_;
+};
+
 /**
  * The unify interface of correctors
  */
@@ -73,6 +103,7 @@ class CorrectorComponent : public Corrector::Component {
   static Corrector* Combine(Cs... args);
 
   the<ResourceResolver> resolver_;
+  the<ResourceResolver> prism_resolver_;
 
   class Unified : public Corrector {
    public:
@@ -112,6 +143,24 @@ class EditDistanceCorrector : public Corrector, public Prism {
                                          corrector::Distance threshold);
 };
 
+// looks up typos in an index precomputed at deploy time, instead of searching
+// the prism for keyboard neighbors of each key.
+class TypoIndexCorrector : public Corrector, public Prism {
+ public:
+  ~TypoIndexCorrector() override = default;
+  RIME_DLL explicit TypoIndexCorrector(const path& file_path);
+
+  RIME_DLL bool Build(const Syllabary& syllabary,
+                      const Script* script = nullptr,
+                      uint32_t dict_file_checksum = 0,
+                      uint32_t schema_file_checksum = 0);
+
+  RIME_DLL void ToleranceSearch(const Prism& prism,
+                                const string& key,
+                                corrector::Corrections* results,
+                                size_t tolerance) override;
+};
+
 class RIME_DLL NearSearchCorrector : public Corrector {
  public:
   NearSearchCorrector() = default;
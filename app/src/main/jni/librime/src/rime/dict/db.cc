@@ -51,6 +51,16 @@ bool Db::Remove() {
   return std::filesystem::remove(file_path());
 }
 
+static std::atomic<uint64_t> db_generation{0};
+
+uint64_t Db::generation() {
+  return db_generation.load(std::memory_order_acquire);
+}
+
+void Db::BumpGeneration() {
+  db_generation.fetch_add(1, std::memory_order_release);
+}
+
 bool Db::CreateMetadata() {
   LOG(INFO) << "creating metadata for db '" << name_ << "'.";
   return MetaUpdate("/db_name", name_) &&
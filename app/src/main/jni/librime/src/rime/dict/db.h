@@ -7,6 +7,9 @@
 #ifndef RIME_DB_H_
 #define RIME_DB_H_
 
+#include <stdint.h>
+#include <atomic>
+#include <mutex>
 #include <rime_api.h>
 #include <rime/common.h>
 #include <rime/component.h>
@@ -63,13 +66,23 @@ class Db : public Class<Db, const string&> {
   bool disabled() const { return disabled_; }
   void disable() { disabled_ = true; }
   void enable() { disabled_ = false; }
+  // held while checking and opening a db that components on different
+  // threads share.
+  std::mutex& load_mutex() { return load_mutex_; }
+  // changes on every write to any db, including those of other sessions;
+  // what has been made of user data is stale once it changes.
+  RIME_DLL static uint64_t generation();
 
  protected:
+  // called by implementations on every write.
+  static void BumpGeneration();
+
   string name_;
   path file_path_;
   bool loaded_ = false;
   bool readonly_ = false;
   bool disabled_ = false;
+  std::mutex load_mutex_;
 };
 
 class Transactional {
@@ -80,9 +93,13 @@ class Transactional {
   virtual bool AbortTransaction() { return false; }
   virtual bool CommitTransaction() { return false; }
   bool in_transaction() const { return in_transaction_; }
+  // which of the users sharing the db began the transaction in progress.
+  const void* transaction_owner() const { return transaction_owner_; }
+  void set_transaction_owner(const void* owner) { transaction_owner_ = owner; }
 
  protected:
   bool in_transaction_ = false;
+  const void* transaction_owner_ = nullptr;
 };
 
 class Recoverable {
@@ -91,6 +108,46 @@ class Recoverable {
   virtual bool Recover() = 0;
 };
 
+// a db that keeps recent writes in memory and stores them in the background.
+class WriteBehind {
+ public:
+  virtual ~WriteBehind() = default;
+  // pending writes are stored at least this often; 0 writes through.
+  // takes effect when the db is opened.
+  virtual void set_flush_interval(int milliseconds) = 0;
+  // stores pending writes now.
+  virtual bool Flush() = 0;
+};
+
+// a db that logs the keys of records changed locally, numbered in sequence,
+// so that a sync can export what changed since a peer last caught up.
+// nothing is logged until the first sync starts the log.
+class ChangeLog {
+ public:
+  // changes a sync keeps in the log; beyond that many, a snapshot is cheaper
+  // for a peer to merge anyway.
+  static constexpr uint64_t kMaxLoggedChanges = 10000;
+
+  virtual ~ChangeLog() = default;
+  // tells this log from that of a db recreated under the same name, whose
+  // sequence numbers start over; empty if the log is not started.
+  virtual string log_id() = 0;
+  // logs changes from now on; does nothing if the log is already started.
+  virtual bool StartLog() = 0;
+  // written along with the change, in the same transaction if any. nothing
+  // is dropped here; syncs trim the log.
+  virtual bool LogChange(const string& key) = 0;
+  // the sequence number of the latest change logged; 0 if none.
+  virtual uint64_t last_change() = 0;
+  // the log holds every change after this one.
+  virtual uint64_t log_start() = 0;
+  // collects the keys changed after the given sequence number.
+  virtual bool GetChanges(uint64_t since, set<string>* keys) = 0;
+  // forgets changes up to and including the given sequence number, except
+  // for the latest.
+  virtual bool TrimChanges(uint64_t until) = 0;
+};
+
 class ResourceResolver;
 
 class RIME_DLL DbComponentBase {
@@ -1,6 +1,7 @@
 #ifndef RIME_DB_POOL_H_
 #define RIME_DB_POOL_H_
 
+#include <mutex>
 #include <rime/common.h>
 #include <rime/resource.h>
 
@@ -18,6 +19,7 @@ class DbPool {
  protected:
   the<ResourceResolver> resource_resolver_;
   map<string, weak<T>> db_pool_;
+  std::mutex mutex_;
 };
 
 }  // namespace rime
@@ -36,6 +36,22 @@ DictCompiler::DictCompiler(Dictionary* dictionary)
 
 DictCompiler::~DictCompiler() {}
 
+// the typo index sits next to the prism, eg. luna_pinyin.correction.bin
+static path correction_file_path(const path& prism_path) {
+  path file_path(prism_path);
+  file_path.replace_extension("");
+  file_path.replace_extension(".correction.bin");
+  return file_path;
+}
+
+static bool correction_enabled(const path& schema_file) {
+  Config config;
+  bool enable_correction = false;
+  return config.LoadFromFile(schema_file) &&
+         config.GetBool("translator/enable_correction", &enable_correction) &&
+         enable_correction;
+}
+
 static bool load_dict_settings_from_file(DictSettings* settings,
                                          const path& dict_file) {
   std::ifstream fin(dict_file.c_str());
@@ -123,6 +139,11 @@ bool DictCompiler::Compile(const path& schema_file) {
   } else {
     rebuild_prism = true;
   }
+  if (!rebuild_prism && !schema_file.empty() &&
+      correction_enabled(schema_file) &&
+      !std::filesystem::exists(correction_file_path(prism_->file_path()))) {
+    rebuild_prism = true;
+  }
   LOG(INFO) << dict_file << "[" << dict_files.size() << " file(s)]"
             << " (" << dict_file_checksum << ")";
   LOG(INFO) << schema_file << " (" << schema_file_checksum << ")";
@@ -223,6 +244,9 @@ bool DictCompiler::BuildTable(int table_index,
       relocate_target(table->file_path(), target_resolver_.get());
   LOG(INFO) << "building table: " << target_path;
   table = New<Table>(target_path);
+  // a record of the old file is removed with it.
+  table->set_hot_pages_file_path(
+      DictionaryComponent::HotPagesFilePath(target_path));
 
   collector.Configure(settings);
   collector.Collect(dict_files);
@@ -300,6 +324,8 @@ bool DictCompiler::BuildPrism(const path& schema_file,
   auto target_path =
       relocate_target(prism_->file_path(), target_resolver_.get());
   prism_ = New<Prism>(target_path);
+  prism_->set_hot_pages_file_path(
+      DictionaryComponent::HotPagesFilePath(target_path));
 
   // get syllabary from primary table, which may not be rebuilt
   Syllabary syllabary;
@@ -326,27 +352,26 @@ bool DictCompiler::BuildPrism(const path& schema_file,
       }
     }
 
-#if 0
     // build corrector
-    bool enable_correction = false; // Avoid if initializer to comfort compilers
+    bool enable_correction = false;
     if (config.GetBool("translator/enable_correction", &enable_correction) &&
         enable_correction) {
-      path corrector_path(prism_->file_path());
-      corrector_path.replace_extension("");
-      corrector_path.replace_extension(".correction.bin");
-      auto target_path = relocate_target(corrector_path,
-                                         target_resolver_.get());
-      correction_ = New<EditDistanceCorrector>(target_path);
+      auto target_path =
+          relocate_target(correction_file_path(prism_->file_path()),
+                          target_resolver_.get());
+      correction_ = New<TypoIndexCorrector>(target_path);
+      correction_->set_hot_pages_file_path(
+          DictionaryComponent::HotPagesFilePath(target_path));
       if (correction_->Exists()) {
         correction_->Remove();
       }
-      if (!correction_->Build(syllabary, &script,
-                         dict_file_checksum, schema_file_checksum) ||
+      LOG(INFO) << "building typo index: " << target_path;
+      if (!correction_->Build(syllabary, &script, dict_file_checksum,
+                              schema_file_checksum) ||
           !correction_->Save()) {
         return false;
       }
     }
-#endif
   }
   if ((options_ & kDump) && !script.empty()) {
     path dump_path(prism_->file_path());
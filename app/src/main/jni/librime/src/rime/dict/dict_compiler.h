@@ -17,7 +17,7 @@ class Prism;
 class Table;
 class ReverseDb;
 class DictSettings;
-class EditDistanceCorrector;
+class TypoIndexCorrector;
 class EntryCollector;
 class Vocabulary;
 class ResourceResolver;
@@ -54,7 +54,7 @@ class DictCompiler {
   const string& dict_name_;
   const vector<string>& packs_;
   an<Prism> prism_;
-  an<EditDistanceCorrector> correction_;
+  an<TypoIndexCorrector> correction_;
   vector<of<Table>> tables_;
   int options_ = 0;
   the<ResourceResolver> source_resolver_;
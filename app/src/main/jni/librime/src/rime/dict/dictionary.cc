@@ -235,17 +235,12 @@ Dictionary::~Dictionary() {
   // should not close shared table and prism objects
 }
 
-static void lookup_table(Table* table,
-                         DictEntryCollector* collector,
-                         const SyllableGraph& syllable_graph,
-                         size_t start_pos,
-                         bool predict_word,
-                         double initial_credibility) {
-  TableQueryResult result;
-  if (!table->Query(syllable_graph, start_pos, &result)) {
-    return;
-  }
-  // copy result
+static void collect_entries(Table* table,
+                            DictEntryCollector* collector,
+                            const SyllableGraph& syllable_graph,
+                            TableQueryResult& result,
+                            bool predict_word,
+                            double initial_credibility) {
   for (auto& v : result) {
     size_t end_pos = v.first;
     for (TableAccessor& a : v.second) {
@@ -268,6 +263,33 @@ static void lookup_table(Table* table,
   }
 }
 
+static void lookup_table(Table* table,
+                         DictEntryCollector* collector,
+                         const SyllableGraph& syllable_graph,
+                         size_t start_pos,
+                         bool predict_word,
+                         double initial_credibility) {
+  TableQueryResult result;
+  if (!table->Query(syllable_graph, start_pos, &result)) {
+    return;
+  }
+  collect_entries(table, collector, syllable_graph, result, predict_word,
+                  initial_credibility);
+}
+
+// for each group of equal code length, sort it and filter words
+static void sort_and_filter(DictEntryCollector* collector,
+                            const hash_set<string>* blacklist) {
+  for (auto& v : *collector) {
+    v.second.Sort();
+    if (blacklist && !blacklist->empty()) {
+      v.second.AddFilter([blacklist](an<DictEntry> entry) {
+        return entry && !blacklist->count(entry->text);
+      });
+    }
+  }
+}
+
 an<DictEntryCollector> Dictionary::Lookup(const SyllableGraph& syllable_graph,
                                           size_t start_pos,
                                           const hash_set<string>* blacklist,
@@ -284,16 +306,33 @@ an<DictEntryCollector> Dictionary::Lookup(const SyllableGraph& syllable_graph,
   }
   if (collector->empty())
     return nullptr;
-  // for each group of equal code length, sort it and filter words
-  for (auto& v : *collector) {
-    v.second.Sort();
-    if (blacklist && !blacklist->empty()) {
-      v.second.AddFilter([blacklist](an<DictEntry> entry) {
-        return entry && !blacklist->count(entry->text);
-      });
+  sort_and_filter(collector.get(), blacklist);
+  return collector;
+}
+
+an<DictEntryLattice> Dictionary::LookupLattice(
+    const SyllableGraph& syllable_graph,
+    const hash_set<string>* blacklist) {
+  if (!loaded())
+    return nullptr;
+  auto lattice = New<DictEntryLattice>();
+  for (const auto& table : tables_) {
+    if (!table->IsOpen())
+      continue;
+    TableQueryLattice result;
+    if (!table->QueryLattice(syllable_graph, &result))
+      continue;
+    for (auto& x : result) {
+      collect_entries(table.get(), &(*lattice)[x.first], syllable_graph,
+                      x.second, false, 0.0);
     }
   }
-  return collector;
+  if (lattice->empty())
+    return nullptr;
+  for (auto& x : *lattice) {
+    sort_and_filter(&x.second, blacklist);
+  }
+  return lattice;
 }
 
 size_t Dictionary::LookupWords(DictEntryIterator* result,
@@ -376,6 +415,13 @@ bool Dictionary::Remove() {
   return true;
 }
 
+// the file may be being loaded for another component on the preloader thread.
+template <class T>
+static bool load_shared(const an<T>& file) {
+  std::lock_guard<std::mutex> lock(file->load_mutex());
+  return file->IsOpen() || file->Load();
+}
+
 bool Dictionary::Load() {
   LOG(INFO) << "loading dictionary '" << name_ << "'.";
   if (tables_.empty()) {
@@ -384,17 +430,18 @@ bool Dictionary::Load() {
     return false;
   }
   auto& primary_table = tables_[0];
-  if (!primary_table || (!primary_table->IsOpen() && !primary_table->Load())) {
+  if (!primary_table || !load_shared(primary_table)) {
     LOG(ERROR) << "Error loading table for dictionary '" << name_ << "'.";
     return false;
   }
-  if (!prism_ || (!prism_->IsOpen() && !prism_->Load())) {
+  if (!prism_ || !load_shared(prism_)) {
     LOG(ERROR) << "Error loading prism for dictionary '" << name_ << "'.";
     return false;
   }
   // packs are optional
   for (int i = 1; i < tables_.size(); ++i) {
     const auto& table = tables_[i];
+    std::lock_guard<std::mutex> lock(table->load_mutex());
     if (!table->IsOpen() && table->Exists() && table->Load()) {
       LOG(INFO) << "loaded pack: " << packs_[i - 1];
     }
@@ -447,22 +494,47 @@ Dictionary* DictionaryComponent::Create(const Ticket& ticket) {
       }
     }
   }
-  return Create(std::move(dict_name), std::move(prism_name), std::move(packs));
+  int load_policy = MappedFile::kDefaultLoadPolicy;
+  if (auto hints = config->GetList(ticket.name_space + "/load_hints")) {
+    load_policy = 0;
+    for (const auto& item : *hints) {
+      auto value = As<ConfigValue>(item);
+      if (!value)
+        continue;
+      const string& hint = value->str();
+      if (hint == "advise_access")
+        load_policy |= MappedFile::kAdviseAccess;
+      else if (hint == "prefault_index")
+        load_policy |= MappedFile::kPrefaultIndex;
+      else if (hint == "replay_hot_pages")
+        load_policy |= MappedFile::kReplayHotPages;
+      else
+        LOG(WARNING) << "unknown load hint: " << hint;
+    }
+  }
+  return Create(std::move(dict_name), std::move(prism_name), std::move(packs),
+                load_policy);
 }
 
 Dictionary* DictionaryComponent::Create(string dict_name,
                                         string prism_name,
-                                        vector<string> packs) {
+                                        vector<string> packs,
+                                        int load_policy) {
+  std::lock_guard<std::mutex> lock(mutex_);
   // obtain prism and primary table objects
   auto primary_table = table_map_[dict_name].lock();
   if (!primary_table) {
     auto file_path = table_resource_resolver_->ResolvePath(dict_name);
     table_map_[dict_name] = primary_table = New<Table>(file_path);
+    primary_table->set_load_policy(load_policy);
+    primary_table->set_hot_pages_file_path(HotPagesFilePath(file_path));
   }
   auto prism = prism_map_[prism_name].lock();
   if (!prism) {
     auto file_path = prism_resource_resolver_->ResolvePath(prism_name);
     prism_map_[prism_name] = prism = New<Prism>(file_path);
+    prism->set_load_policy(load_policy);
+    prism->set_hot_pages_file_path(HotPagesFilePath(file_path));
   }
   vector<of<Table>> tables = {std::move(primary_table)};
   for (const auto& pack : packs) {
@@ -470,6 +542,8 @@ Dictionary* DictionaryComponent::Create(string dict_name,
     if (!table) {
       auto file_path = table_resource_resolver_->ResolvePath(pack);
       table_map_[pack] = table = New<Table>(file_path);
+      table->set_load_policy(load_policy);
+      table->set_hot_pages_file_path(HotPagesFilePath(file_path));
     }
     tables.push_back(std::move(table));
   }
@@ -477,4 +551,13 @@ Dictionary* DictionaryComponent::Create(string dict_name,
                         std::move(tables), std::move(prism));
 }
 
+path DictionaryComponent::HotPagesFilePath(const path& file_path) {
+  const path& staging_dir = Service::instance().deployer().staging_dir;
+  if (staging_dir.empty())
+    return path();
+  path file_name = file_path.filename();
+  file_name.replace_extension(".hotpages");
+  return staging_dir / file_name;
+}
+
 }  // namespace rime
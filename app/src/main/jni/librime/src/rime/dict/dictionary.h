@@ -7,6 +7,7 @@
 #ifndef RIME_DICTIONARY_H_
 #define RIME_DICTIONARY_H_
 
+#include <mutex>
 #include <rime_api.h>
 #include <rime/common.h>
 #include <rime/component.h>
@@ -52,6 +53,8 @@ class RIME_DLL DictEntryIterator : public DictEntryFilterBinder {
 };
 
 using DictEntryCollector = map<size_t, DictEntryIterator>;
+// entries by start position, then by end position.
+using DictEntryLattice = map<size_t, DictEntryCollector>;
 
 class Config;
 class Schema;
@@ -77,6 +80,10 @@ class Dictionary : public Class<Dictionary, const Ticket&> {
       const hash_set<string>* blacklist = nullptr,
       bool predict_word = false,
       double initial_credibility = 0.0);
+  // looks up words from every start position of the graph in one pass.
+  RIME_DLL an<DictEntryLattice> LookupLattice(
+      const SyllableGraph& syllable_graph,
+      const hash_set<string>* blacklist = nullptr);
   // if predictive is true, do an expand search with limit,
   // otherwise do an exact match.
   // return num of matching keys.
@@ -110,11 +117,22 @@ class DictionaryComponent : public Dictionary::Component {
   DictionaryComponent();
   ~DictionaryComponent() override;
   Dictionary* Create(const Ticket& ticket) override;
-  Dictionary* Create(string dict_name, string prism_name, vector<string> packs);
+  // load_policy applies to the table and prism files when first opened; it
+  // comes from `<name_space>/load_hints` in the schema, a list of
+  // advise_access, prefault_index and replay_hot_pages, all of them if unset.
+  Dictionary* Create(string dict_name,
+                     string prism_name,
+                     vector<string> packs,
+                     int load_policy = MappedFile::kDefaultLoadPolicy);
+  // where pages in use of a deployed file are recorded, eg.
+  // build/luna_pinyin.table.hotpages in the user data directory; the file
+  // itself may be in a shared directory the user cannot write to.
+  static path HotPagesFilePath(const path& file_path);
 
  private:
   map<string, weak<Prism>> prism_map_;
   map<string, weak<Table>> table_map_;
+  std::mutex mutex_;
   the<ResourceResolver> prism_resource_resolver_;
   the<ResourceResolver> table_resource_resolver_;
 };
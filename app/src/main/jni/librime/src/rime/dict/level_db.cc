@@ -5,6 +5,12 @@
 // 2014-12-04 Chen Gong <chen.sst@gmail.com>
 //
 
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <ctime>
+#include <random>
+#include <thread>
 #include <leveldb/db.h>
 #include <leveldb/write_batch.h>
 #include <rime/common.h>
@@ -15,41 +21,130 @@
 namespace rime {
 
 static const char* kMetaCharacter = "\x01";
+// the change log sorts between metadata and records, and is left out of
+// both, thus out of snapshots; "\x02" itself holds the log id.
+static const char* kChangeCharacter = "\x02";
+
+static string change_key(uint64_t sequence) {
+  char hex[17];
+  std::snprintf(hex, sizeof(hex), "%016llx", (unsigned long long)sequence);
+  return kChangeCharacter + string(hex);
+}
+
+static uint64_t change_sequence(const string& key) {
+  return key.length() > 1 ? std::strtoull(key.c_str() + 1, nullptr, 16) : 0;
+}
+
+// wakes the flusher before the interval is up.
+static const size_t kMaxPendingWrites = 256;
+
+struct PendingWrite {
+  bool erased = false;
+  string value;
+  uint64_t sequence = 0;
+};
+
+// writes not yet stored in the db. shared read-only with open cursors and
+// the flusher; copied before modifying if any of them holds it.
+using LevelDbJournal = map<string, PendingWrite>;
 
 struct LevelDbCursor {
   leveldb::Iterator* iterator = nullptr;
+  an<const LevelDbJournal> journal;
+  LevelDbJournal::const_iterator pending;
+  // whether the current record comes from the journal.
+  bool from_journal = false;
 
-  LevelDbCursor(leveldb::DB* db) {
+  LevelDbCursor(leveldb::DB* db, an<const LevelDbJournal> pending_writes)
+      : journal(pending_writes) {
     leveldb::ReadOptions options;
     options.fill_cache = false;
     iterator = db->NewIterator(options);
+    if (journal)
+      pending = journal->end();
   }
 
-  bool IsValid() const { return iterator && iterator->Valid(); }
+  bool IsValid() const { return from_journal || InDb(); }
 
-  string GetKey() const { return iterator->key().ToString(); }
+  string GetKey() const {
+    return from_journal ? pending->first : iterator->key().ToString();
+  }
 
-  string GetValue() const { return iterator->value().ToString(); }
+  string GetValue() const {
+    return from_journal ? pending->second.value : iterator->value().ToString();
+  }
 
-  void Next() { iterator->Next(); }
+  void Next() {
+    if (from_journal) {
+      // skip the stored record it replaces.
+      if (InDb() && iterator->key() == pending->first)
+        iterator->Next();
+      ++pending;
+    } else {
+      iterator->Next();
+    }
+    Merge();
+  }
 
   bool Jump(const string& key) {
     if (!iterator) {
       return false;
     }
     iterator->Seek(key);
+    if (journal)
+      pending = journal->lower_bound(key);
+    Merge();
     return true;
   }
 
   void Release() {
     delete iterator;
     iterator = nullptr;
+    journal.reset();
+    from_journal = false;
+  }
+
+ private:
+  bool InDb() const { return iterator && iterator->Valid(); }
+
+  // picks the lesser key of the db and the journal; pending writes shadow
+  // stored records, and pending erasures hide them.
+  void Merge() {
+    from_journal = false;
+    if (!journal)
+      return;
+    for (; pending != journal->end(); ++pending) {
+      int order = InDb() ? iterator->key().compare(pending->first) : 1;
+      if (order < 0)
+        return;
+      if (!pending->second.erased) {
+        from_journal = true;
+        return;
+      }
+      if (order == 0)
+        iterator->Next();
+    }
   }
 };
 
 struct LevelDbWrapper {
   leveldb::DB* ptr = nullptr;
   leveldb::WriteBatch batch;
+  // write-behind
+  bool write_behind = false;
+  // the transaction in progress, taking the place of the write batch.
+  LevelDbJournal staged;
+  an<LevelDbJournal> journal;
+  uint64_t sequence = 0;
+  bool stopping = false;
+  std::mutex journal_mutex;
+  std::condition_variable journal_cv;
+  // flushes are serialized so that an older snapshot never overwrites a
+  // newer one.
+  std::mutex flush_mutex;
+#ifndef RIME_NO_THREADING
+  std::thread flusher;
+#endif
 
   leveldb::Status Open(const path& file_path, bool readonly) {
     leveldb::Options options;
@@ -58,18 +153,58 @@ struct LevelDbWrapper {
   }
 
   void Release() {
+    StopWriteBehind();
     delete ptr;
     ptr = nullptr;
   }
 
-  LevelDbCursor* CreateCursor() { return new LevelDbCursor(ptr); }
+  LevelDbCursor* CreateCursor() {
+    an<const LevelDbJournal> pending;
+    if (write_behind) {
+      // taken before the db iterator, so that a write flushed in between is
+      // seen by at least one of them.
+      std::lock_guard<std::mutex> lock(journal_mutex);
+      pending = journal;
+    }
+    return new LevelDbCursor(ptr, pending);
+  }
+
+  // the sequence number of the latest change stored.
+  uint64_t LastChange() {
+    the<leveldb::Iterator> it(ptr->NewIterator(leveldb::ReadOptions()));
+    it->Seek("\x03");
+    if (it->Valid())
+      it->Prev();
+    else
+      it->SeekToLast();
+    if (!it->Valid() || !it->key().starts_with(kChangeCharacter))
+      return 0;
+    return change_sequence(it->key().ToString());
+  }
 
   bool Fetch(const string& key, string* value) {
+    if (write_behind) {
+      std::lock_guard<std::mutex> lock(journal_mutex);
+      auto found = journal->find(key);
+      if (found != journal->end()) {
+        if (found->second.erased)
+          return false;
+        *value = found->second.value;
+        return true;
+      }
+    }
     auto status = ptr->Get(leveldb::ReadOptions(), key, value);
     return status.ok();
   }
 
   bool Update(const string& key, const string& value, bool write_batch) {
+    if (write_behind) {
+      if (write_batch)
+        staged[key] = {false, value};
+      else
+        Record(key, &value);
+      return true;
+    }
     if (write_batch) {
       batch.Put(key, value);
       return true;
@@ -79,6 +214,13 @@ struct LevelDbWrapper {
   }
 
   bool Erase(const string& key, bool write_batch) {
+    if (write_behind) {
+      if (write_batch)
+        staged[key] = {true, string()};
+      else
+        Record(key, nullptr);
+      return true;
+    }
     if (write_batch) {
       batch.Delete(key);
       return true;
@@ -87,12 +229,124 @@ struct LevelDbWrapper {
     return status.ok();
   }
 
-  void ClearBatch() { batch.Clear(); }
+  void ClearBatch() {
+    batch.Clear();
+    staged.clear();
+  }
 
   bool CommitBatch() {
+    if (write_behind) {
+      for (const auto& w : staged) {
+        Record(w.first, w.second.erased ? nullptr : &w.second.value);
+      }
+      return true;
+    }
     auto status = ptr->Write(leveldb::WriteOptions(), &batch);
     return status.ok();
   }
+
+  // records a pending write; value is null for an erasure.
+  void Record(const string& key, const string* value) {
+    std::lock_guard<std::mutex> lock(journal_mutex);
+    PendingWrite& w = (*MutableJournal())[key];
+    w.erased = !value;
+    w.value = value ? *value : string();
+    w.sequence = ++sequence;
+    if (journal->size() >= kMaxPendingWrites)
+      journal_cv.notify_one();
+  }
+
+  // stores pending writes in a single batch.
+  bool Flush() {
+    if (!write_behind)
+      return true;
+    std::lock_guard<std::mutex> flush_lock(flush_mutex);
+    an<const LevelDbJournal> snapshot;
+    uint64_t flushed;
+    {
+      std::lock_guard<std::mutex> lock(journal_mutex);
+      if (journal->empty())
+        return true;
+      snapshot = journal;
+      flushed = sequence;
+    }
+    leveldb::WriteBatch writes;
+    for (const auto& w : *snapshot) {
+      if (w.second.erased)
+        writes.Delete(w.first);
+      else
+        writes.Put(w.first, w.second.value);
+    }
+    auto status = ptr->Write(leveldb::WriteOptions(), &writes);
+    if (!status.ok()) {
+      LOG(ERROR) << "error flushing " << snapshot->size()
+                 << " pending writes: " << status.ToString();
+      return false;
+    }
+    snapshot.reset();
+    std::lock_guard<std::mutex> lock(journal_mutex);
+    // keep only what has been written since.
+    auto* pending = MutableJournal();
+    for (auto it = pending->begin(); it != pending->end();) {
+      if (it->second.sequence <= flushed)
+        it = pending->erase(it);
+      else
+        ++it;
+    }
+    return true;
+  }
+
+  void StartWriteBehind(int flush_interval) {
+    journal = New<LevelDbJournal>();
+    stopping = false;
+    write_behind = true;
+#ifndef RIME_NO_THREADING
+    flusher = std::thread([this, flush_interval] {
+      const std::chrono::milliseconds interval(flush_interval);
+      std::unique_lock<std::mutex> lock(journal_mutex);
+      while (!stopping) {
+        journal_cv.wait_for(lock, interval, [this] {
+          return stopping || journal->size() >= kMaxPendingWrites;
+        });
+        if (stopping)
+          break;
+        lock.unlock();
+        bool ok = Flush();
+        lock.lock();
+        if (!ok) {
+          // try again later rather than spinning on a full journal.
+          journal_cv.wait_for(lock, interval, [this] { return stopping; });
+        }
+      }
+    });
+#endif
+  }
+
+  bool StopWriteBehind() {
+    if (!write_behind)
+      return true;
+    {
+      std::lock_guard<std::mutex> lock(journal_mutex);
+      stopping = true;
+    }
+    journal_cv.notify_one();
+#ifndef RIME_NO_THREADING
+    if (flusher.joinable())
+      flusher.join();
+#endif
+    bool ok = Flush();
+    write_behind = false;
+    journal.reset();
+    return ok;
+  }
+
+ private:
+  // called with journal_mutex held.
+  LevelDbJournal* MutableJournal() {
+    if (journal.use_count() > 1)
+      journal = New<LevelDbJournal>(*journal);
+    return journal.get();
+  }
 };
 
 // LevelDbAccessor members
@@ -180,6 +434,8 @@ bool LevelDb::Update(const string& key, const string& value) {
   if (!loaded() || readonly())
     return false;
   DLOG(INFO) << "update db entry: " << key << " => " << value;
+  std::lock_guard<std::mutex> lock(write_mutex_);
+  BumpGeneration();
   return db_->Update(key, value, in_transaction());
 }
 
@@ -187,6 +443,8 @@ bool LevelDb::Erase(const string& key) {
   if (!loaded() || readonly())
     return false;
   DLOG(INFO) << "erase db entry: " << key;
+  std::lock_guard<std::mutex> lock(write_mutex_);
+  BumpGeneration();
   return db_->Erase(key, in_transaction());
 }
 
@@ -248,6 +506,10 @@ bool LevelDb::Open() {
   loaded_ = status.ok();
 
   if (loaded_) {
+#ifndef RIME_NO_THREADING
+    if (flush_interval_ > 0)
+      db_->StartWriteBehind(flush_interval_);
+#endif
     string db_name;
     if (!MetaFetch("/db_name", &db_name)) {
       if (!CreateMetadata()) {
@@ -255,6 +517,8 @@ bool LevelDb::Open() {
         Close();
       }
     }
+    if (loaded_)
+      OpenChangeLog();
   } else {
     LOG(ERROR) << "Error opening db '" << name() << "': " << status.ToString();
   }
@@ -269,12 +533,26 @@ bool LevelDb::OpenReadOnly() {
   auto status = db_->Open(file_path(), readonly_);
   loaded_ = status.ok();
 
-  if (!loaded_) {
+  if (loaded_) {
+    OpenChangeLog();
+  } else {
     LOG(ERROR) << "Error opening db '" << name() << "' read-only.";
   }
   return loaded_;
 }
 
+void LevelDb::OpenChangeLog() {
+  log_id_.clear();
+  Fetch(kChangeCharacter, &log_id_);
+  last_change_ = db_->LastChange();
+  log_start_ = 0;
+  auto accessor = Query(kChangeCharacter);
+  string key, value;
+  if (accessor && accessor->Jump(change_key(1)) &&
+      accessor->GetNextRecord(&key, &value))
+    log_start_ = change_sequence(key) - 1;
+}
+
 bool LevelDb::Close() {
   if (!loaded())
     return false;
@@ -303,6 +581,7 @@ bool LevelDb::MetaUpdate(const string& key, const string& value) {
 bool LevelDb::BeginTransaction() {
   if (!loaded())
     return false;
+  std::lock_guard<std::mutex> lock(write_mutex_);
   db_->ClearBatch();
   in_transaction_ = true;
   return true;
@@ -311,6 +590,8 @@ bool LevelDb::BeginTransaction() {
 bool LevelDb::AbortTransaction() {
   if (!loaded() || !in_transaction())
     return false;
+  std::lock_guard<std::mutex> lock(write_mutex_);
+  BumpGeneration();
   db_->ClearBatch();
   in_transaction_ = false;
   return true;
@@ -319,12 +600,110 @@ bool LevelDb::AbortTransaction() {
 bool LevelDb::CommitTransaction() {
   if (!loaded() || !in_transaction())
     return false;
+  std::lock_guard<std::mutex> lock(write_mutex_);
+  BumpGeneration();
   bool ok = db_->CommitBatch();
   db_->ClearBatch();
   in_transaction_ = false;
   return ok;
 }
 
+void LevelDb::set_flush_interval(int milliseconds) {
+  flush_interval_ = (std::max)(0, milliseconds);
+}
+
+bool LevelDb::Flush() {
+  if (!loaded())
+    return false;
+  return db_->Flush();
+}
+
+string LevelDb::log_id() {
+  std::lock_guard<std::mutex> lock(write_mutex_);
+  return log_id_;
+}
+
+bool LevelDb::StartLog() {
+  if (!loaded() || readonly())
+    return false;
+  std::lock_guard<std::mutex> lock(write_mutex_);
+  if (!log_id_.empty())
+    return true;
+  std::random_device random;
+  std::mt19937_64 generator((uint64_t(random()) << 32) ^ random() ^
+                            uint64_t(time(nullptr)));
+  char hex[17];
+  std::snprintf(hex, sizeof(hex), "%016llx",
+                (unsigned long long)generator());
+  if (!db_->Update(kChangeCharacter, hex, in_transaction()))
+    return false;
+  log_id_ = hex;
+  return true;
+}
+
+bool LevelDb::LogChange(const string& key) {
+  if (!loaded() || readonly())
+    return false;
+  std::lock_guard<std::mutex> lock(write_mutex_);
+  // no peer to sync with; the change is in the snapshot of the first sync.
+  if (log_id_.empty())
+    return false;
+  if (!db_->Update(change_key(last_change_ + 1), key, in_transaction()))
+    return false;
+  ++last_change_;
+  return true;
+}
+
+uint64_t LevelDb::last_change() {
+  std::lock_guard<std::mutex> lock(write_mutex_);
+  return last_change_;
+}
+
+uint64_t LevelDb::log_start() {
+  std::lock_guard<std::mutex> lock(write_mutex_);
+  return log_start_;
+}
+
+bool LevelDb::GetChanges(uint64_t since, set<string>* keys) {
+  auto accessor = Query(kChangeCharacter);
+  if (!accessor || !keys)
+    return false;
+  accessor->Jump(change_key(since + 1));
+  string key, value;
+  while (accessor->GetNextRecord(&key, &value)) {
+    keys->insert(value);
+  }
+  return true;
+}
+
+bool LevelDb::TrimChanges(uint64_t until) {
+  if (!loaded() || readonly())
+    return false;
+  uint64_t last = last_change();
+  if (last == 0)
+    return true;
+  until = (std::min)(until, last - 1);
+  auto accessor = Query(kChangeCharacter);
+  if (!accessor || !accessor->Jump(change_key(1)))
+    return false;
+  vector<string> trimmed;
+  string key, value;
+  while (accessor->GetNextRecord(&key, &value) &&
+         change_sequence(key) <= until) {
+    trimmed.push_back(key);
+  }
+  accessor.reset();
+  for (const auto& k : trimmed) {
+    if (!Erase(k))
+      return false;
+  }
+  if (!trimmed.empty()) {
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    log_start_ = (std::max)(log_start_, change_sequence(trimmed.back()));
+  }
+  return true;
+}
+
 template <>
 RIME_DLL string UserDbComponent<LevelDb>::extension() const {
   return ".userdb";
@@ -7,6 +7,7 @@
 #ifndef RIME_LEVEL_DB_H_
 #define RIME_LEVEL_DB_H_
 
+#include <mutex>
 #include <rime/dict/db.h>
 
 namespace rime {
@@ -32,7 +33,11 @@ class LevelDbAccessor : public DbAccessor {
   bool is_metadata_query_ = false;
 };
 
-class LevelDb : public Db, public Recoverable, public Transactional {
+class LevelDb : public Db,
+                public Recoverable,
+                public Transactional,
+                public WriteBehind,
+                public ChangeLog {
  public:
   LevelDb(const path& file_path,
           const string& db_name,
@@ -66,11 +71,33 @@ class LevelDb : public Db, public Recoverable, public Transactional {
   bool AbortTransaction() override;
   bool CommitTransaction() override;
 
+  // WriteBehind
+  void set_flush_interval(int milliseconds) override;
+  bool Flush() override;
+  int flush_interval() const { return flush_interval_; }
+
+  // ChangeLog
+  string log_id() override;
+  bool StartLog() override;
+  bool LogChange(const string& key) override;
+  uint64_t last_change() override;
+  uint64_t log_start() override;
+  bool GetChanges(uint64_t since, set<string>* keys) override;
+  bool TrimChanges(uint64_t until) override;
+
  private:
   void Initialize();
+  void OpenChangeLog();
 
   the<LevelDbWrapper> db_;
   string db_type_;
+  int flush_interval_ = 0;
+  string log_id_;
+  uint64_t last_change_ = 0;
+  uint64_t log_start_ = 0;
+  // sessions on different threads share the db; leveldb serializes reads
+  // and writes of its own, but not those going into the write batch.
+  std::mutex write_mutex_;
 };
 
 }  // namespace rime
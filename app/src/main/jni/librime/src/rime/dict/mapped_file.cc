@@ -11,6 +11,10 @@
 #include <boost/interprocess/file_mapping.hpp>
 #include <boost/interprocess/mapped_region.hpp>
 #include <rime/dict/mapped_file.h>
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
 
 namespace rime {
 
@@ -43,12 +47,24 @@ class MappedFileImpl {
   the<boost::interprocess::mapped_region> region_;
 };
 
+#ifndef _WIN32
+static size_t page_size() {
+  static const size_t kPageSize = sysconf(_SC_PAGESIZE);
+  return kPageSize;
+}
+
+// a file with more of its pages resident, as right after it is built or
+// copied, tells little about the pages lookups touch; nor is it worth
+// reading in all again against the advice of random access.
+static bool mostly_resident(size_t hot_pages, size_t num_pages) {
+  return hot_pages * 10 >= num_pages * 9;
+}
+#endif
+
 MappedFile::MappedFile(const path& file_path) : file_path_(file_path) {}
 
 MappedFile::~MappedFile() {
-  if (file_) {
-    file_.reset();
-  }
+  Close();
 }
 
 bool MappedFile::Create(size_t capacity) {
@@ -80,6 +96,12 @@ bool MappedFile::OpenReadOnly() {
   }
   file_.reset(new MappedFileImpl(file_path_, MappedFileImpl::kOpenReadOnly));
   size_ = file_->get_size();
+  hinted_ = !(load_policy_ & kReplayHotPages) || LoadHotPages();
+  // before anything is read: the first fault may otherwise read ahead as far
+  // as the whole file.
+  if (hinted_ && (load_policy_ & kAdviseAccess)) {
+    Advise(kRandomAccess);
+  }
   return bool(file_);
 }
 
@@ -95,6 +117,12 @@ bool MappedFile::OpenReadWrite() {
 
 void MappedFile::Close() {
   if (file_) {
+    if (warm_ && (load_policy_ & kReplayHotPages)) {
+      RecordHotPages();
+    }
+    warm_ = false;
+    hinted_ = false;
+    hot_pages_.clear();
     file_.reset();
     size_ = 0;
   }
@@ -120,8 +148,13 @@ bool MappedFile::ShrinkToFit() {
 }
 
 bool MappedFile::Remove() {
+  warm_ = false;
   if (IsOpen())
     Close();
+  if (!hot_pages_file_path_.empty()) {
+    std::error_code ec;
+    std::filesystem::remove(hot_pages_file_path_, ec);
+  }
   return boost::interprocess::file_mapping::remove(file_path_.c_str());
 }
 
@@ -165,4 +198,129 @@ char* MappedFile::address() const {
   return reinterpret_cast<char*>(file_->get_address());
 }
 
+bool MappedFile::Advise(Access access, const void* start, size_t length) {
+  if (!file_)
+    return false;
+#ifndef _WIN32
+  char* begin = address();
+  char* end = begin + capacity();
+  if (start) {
+    // whole pages that cover the region.
+    const char* first = reinterpret_cast<const char*>(start);
+    end = (std::min)(end, const_cast<char*>(first) + length);
+    begin += (first - begin) / page_size() * page_size();
+  }
+  if (begin >= end)
+    return false;
+  int advice = access == kRandomAccess ? MADV_RANDOM
+               : access == kWillNeed   ? MADV_WILLNEED
+                                       : MADV_NORMAL;
+  return madvise(begin, end - begin, advice) == 0;
+#else
+  return false;
+#endif
+}
+
+void MappedFile::Warmup(const vector<Region>& index_regions) {
+  if (hinted_ && (load_policy_ & kPrefaultIndex)) {
+    for (const auto& region : index_regions) {
+      Advise(kWillNeed, region.start, region.length);
+    }
+  }
+  if (!hot_pages_.empty()) {
+    ReplayHotPages();
+  }
+  warm_ = true;
+}
+
+// the file records the size of the mapped file, and a bitmap of its pages.
+bool MappedFile::RecordHotPages() {
+#ifndef _WIN32
+  if (!file_ || hot_pages_file_path_.empty())
+    return false;
+  size_t num_pages = (capacity() + page_size() - 1) / page_size();
+  vector<unsigned char> resident(num_pages);
+#ifdef __APPLE__
+  auto* vec = reinterpret_cast<char*>(resident.data());
+#else
+  auto* vec = resident.data();
+#endif
+  if (mincore(address(), capacity(), vec) != 0)
+    return false;
+  vector<char> bitmap((num_pages + 7) / 8);
+  size_t hot_pages = 0;
+  for (size_t i = 0; i < num_pages; ++i) {
+    if (resident[i] & 1) {
+      bitmap[i / 8] |= 1 << (i % 8);
+      ++hot_pages;
+    }
+  }
+  // keeps the last record, if any.
+  if (mostly_resident(hot_pages, num_pages))
+    return false;
+  std::error_code ec;
+  std::filesystem::create_directories(hot_pages_file_path_.parent_path(), ec);
+  std::ofstream out(hot_pages_file_path_.c_str(), std::ios::binary);
+  uint64_t file_size = capacity();
+  out.write(reinterpret_cast<const char*>(&file_size), sizeof(file_size));
+  out.write(bitmap.data(), bitmap.size());
+  return bool(out);
+#else
+  return false;
+#endif
+}
+
+// reads in the record of the file, if any, leaving it in hot_pages_.
+bool MappedFile::LoadHotPages() {
+  hot_pages_.clear();
+#ifndef _WIN32
+  if (!file_ || hot_pages_file_path_.empty())
+    return false;
+  std::ifstream in(hot_pages_file_path_.c_str(), std::ios::binary);
+  uint64_t file_size = 0;
+  if (!in.read(reinterpret_cast<char*>(&file_size), sizeof(file_size)) ||
+      file_size != capacity())
+    return false;
+  size_t num_pages = (capacity() + page_size() - 1) / page_size();
+  vector<char> bitmap((num_pages + 7) / 8);
+  if (!in.read(bitmap.data(), bitmap.size()))
+    return false;
+  size_t hot_pages = 0;
+  for (size_t i = 0; i < num_pages; ++i) {
+    hot_pages += (bitmap[i / 8] >> (i % 8)) & 1;
+  }
+  if (mostly_resident(hot_pages, num_pages))
+    return false;
+  hot_pages_ = std::move(bitmap);
+  return true;
+#else
+  return false;
+#endif
+}
+
+bool MappedFile::ReplayHotPages() {
+#ifndef _WIN32
+  if (!file_ || hot_pages_.empty())
+    return false;
+  const auto& bitmap = hot_pages_;
+  size_t num_pages = (capacity() + page_size() - 1) / page_size();
+  // read in each run of hot pages with one hint.
+  for (size_t i = 0; i < num_pages;) {
+    if (!(bitmap[i / 8] & (1 << (i % 8)))) {
+      ++i;
+      continue;
+    }
+    size_t j = i + 1;
+    while (j < num_pages && (bitmap[j / 8] & (1 << (j % 8))))
+      ++j;
+    Advise(kWillNeed, address() + i * page_size(), (j - i) * page_size());
+    i = j;
+  }
+  hot_pages_.clear();
+  return true;
+#else
+  return false;
+#endif
+}
+
 }  // namespace rime
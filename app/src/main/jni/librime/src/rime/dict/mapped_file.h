@@ -10,6 +10,7 @@
 #include <stdint.h>
 #include <algorithm>
 #include <cstring>
+#include <mutex>
 #include <rime_api.h>
 #include <rime/common.h>
 
@@ -82,7 +83,40 @@ struct List {
 class MappedFileImpl;
 
 class RIME_DLL MappedFile {
+ public:
+  // hints given to the system when a file is loaded for lookups.
+  enum LoadPolicy {
+    // expect random access to the bulk of the file; no read-ahead.
+    kAdviseAccess = 1,
+    // read in index regions in the background ahead of the first lookups.
+    kPrefaultIndex = 2,
+    // record pages resident on closing the file, and read them in again on
+    // loading it next time. along with it, the hints above are given only
+    // when there is a record to replay: a cold file without one loads faster
+    // with the system's read-ahead.
+    kReplayHotPages = 4,
+    kDefaultLoadPolicy = kAdviseAccess | kPrefaultIndex | kReplayHotPages,
+  };
+  // takes effect on the next load.
+  void set_load_policy(int policy) { load_policy_ = policy; }
+  int load_policy() const { return load_policy_; }
+  // where pages in use are recorded for the file; no record is kept if empty.
+  void set_hot_pages_file_path(const path& file_path) {
+    hot_pages_file_path_ = file_path;
+  }
+  const path& hot_pages_file_path() const { return hot_pages_file_path_; }
+
  protected:
+  enum Access {
+    kNormalAccess,
+    kRandomAccess,
+    kWillNeed,
+  };
+  struct Region {
+    const void* start;
+    size_t length;
+  };
+
   explicit MappedFile(const path& file_path);
   virtual ~MappedFile();
 
@@ -104,6 +138,14 @@ class RIME_DLL MappedFile {
 
   size_t capacity() const;
   char* address() const;
+  // hints how a region of the file is going to be accessed; the whole file if
+  // no region is given. does nothing where the system takes no hints.
+  bool Advise(Access access, const void* start = nullptr, size_t length = 0);
+  // to be called once loaded read-only; applies the rest of the load policy.
+  void Warmup(const vector<Region>& index_regions);
+  bool RecordHotPages();
+  bool LoadHotPages();
+  bool ReplayHotPages();
 
  public:
   // noncpyable
@@ -120,11 +162,23 @@ class RIME_DLL MappedFile {
 
   const path& file_path() const { return file_path_; }
   size_t file_size() const { return size_; }
+  // held while checking and loading a file that components on different
+  // threads share.
+  std::mutex& load_mutex() { return load_mutex_; }
 
  private:
   path file_path_;
   size_t size_ = 0;
   the<MappedFileImpl> file_;
+  int load_policy_ = kDefaultLoadPolicy;
+  path hot_pages_file_path_;
+  // the record read on opening the file, to be replayed on warming up.
+  vector<char> hot_pages_;
+  // whether the hints of the load policy apply to this load.
+  bool hinted_ = false;
+  // loaded for lookups; pages resident on closing are worth recording.
+  bool warm_ = false;
+  std::mutex load_mutex_;
 };
 
 // member function definitions
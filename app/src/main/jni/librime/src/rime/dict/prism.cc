@@ -125,6 +125,9 @@ bool Prism::Load() {
   if (format_ > 1.0 - DBL_EPSILON) {
     spelling_map_ = metadata_->spelling_map.get();
   }
+  // every key walks the double array from its root.
+  Warmup({{metadata_, sizeof(prism::Metadata)},
+          {array, trie_->total_size()}});
   return true;
 }
 
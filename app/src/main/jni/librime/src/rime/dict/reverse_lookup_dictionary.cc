@@ -5,6 +5,7 @@
 // 2012-01-05 GONG Chen <chen.sst@gmail.com>
 // 2014-07-06 GONG Chen <chen.sst@gmail.com> redesigned binary file format.
 //
+#include <algorithm>
 #include <cfloat>
 #include <cstdlib>
 #include <sstream>
@@ -13,6 +14,8 @@
 #include <rime/schema.h>
 #include <rime/service.h>
 #include <rime/ticket.h>
+#include <rime/tracer.h>
+#include <rime/algo/algebra.h>
 #include <rime/dict/db_pool_impl.h>
 #include <rime/dict/dict_settings.h>
 #include <rime/dict/reverse_lookup_dictionary.h>
@@ -65,6 +68,8 @@ bool ReverseDb::Load() {
   value_trie_.reset(
       new StringTable(metadata_->value_trie.get(), metadata_->value_trie_size));
 
+  Warmup({{metadata_, sizeof(reverse::Metadata)},
+          {metadata_->key_trie.get(), metadata_->key_trie_size}});
   return true;
 }
 
@@ -81,6 +86,24 @@ bool ReverseDb::Lookup(const string& text, string* result) {
   return !result->empty();
 }
 
+size_t ReverseDb::Lookup(const vector<string>& texts,
+                         vector<string>* results) {
+  results->clear();
+  if (!key_trie_ || !value_trie_ || !metadata_->index.size) {
+    results->resize(texts.size());
+    return 0;
+  }
+  vector<StringId> ids;
+  key_trie_->Lookup(texts, &ids);
+  for (StringId& id : ids) {
+    if (id != kInvalidStringId)
+      id = metadata_->index.at[id];
+  }
+  value_trie_->GetStrings(ids, results);
+  return std::count_if(results->begin(), results->end(),
+                       [](const string& result) { return !result.empty(); });
+}
+
 bool ReverseDb::Build(DictSettings* settings,
                       const Syllabary& syllabary,
                       const Vocabulary& vocabulary,
@@ -205,7 +228,10 @@ uint32_t ReverseDb::dict_file_checksum() const {
 ReverseLookupDictionary::ReverseLookupDictionary(an<ReverseDb> db) : db_(db) {}
 
 bool ReverseLookupDictionary::Load() {
-  return db_ && (db_->IsOpen() || db_->Load());
+  if (!db_)
+    return false;
+  std::lock_guard<std::mutex> lock(db_->load_mutex());
+  return db_->IsOpen() || db_->Load();
 }
 
 bool ReverseLookupDictionary::ReverseLookup(const string& text,
@@ -213,6 +239,36 @@ bool ReverseLookupDictionary::ReverseLookup(const string& text,
   return db_->Lookup(text, result);
 }
 
+size_t ReverseLookupDictionary::ReverseLookup(const vector<string>& texts,
+                                              vector<string>* results) {
+  return db_->Lookup(texts, results);
+}
+
+bool ReverseLookupDictionary::ReverseLookup(const string& text,
+                                            Projection* formatter,
+                                            string* result) {
+  if (formatter != cached_formatter_) {
+    cache_.Clear();
+    cached_formatter_ = formatter;
+  }
+  const string* cached = cache_.Find(text);
+  TraceCacheLookup("reverse_lookup", cached);
+  if (cached) {
+    *result = *cached;
+    return !result->empty();
+  }
+  result->clear();
+  if (db_->Lookup(text, result) && formatter) {
+    formatter->Apply(result);
+  }
+  cache_.Insert(text, *result);
+  return !result->empty();
+}
+
+void ReverseLookupDictionary::set_cache_capacity(size_t capacity) {
+  cache_ = LruCache<string, string>(capacity);
+}
+
 bool ReverseLookupDictionary::LookupStems(const string& text, string* result) {
   return db_->Lookup(text + kStemKeySuffix, result);
 }
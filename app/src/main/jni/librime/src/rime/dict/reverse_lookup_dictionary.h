@@ -11,6 +11,7 @@
 #include <stdint.h>
 #include <rime/common.h>
 #include <rime/component.h>
+#include <rime/algo/lru_cache.h>
 #include <rime/dict/db_pool.h>
 #include <rime/dict/mapped_file.h>
 #include <rime/dict/string_table.h>
@@ -43,6 +44,9 @@ class ReverseDb : public MappedFile {
 
   bool Load();
   bool Lookup(const string& text, string* result);
+  // resolves a batch of texts at once, reusing the trie agents; texts not
+  // found get empty results. returns the number of texts found.
+  size_t Lookup(const vector<string>& texts, vector<string>* results);
 
   bool Build(DictSettings* settings,
              const Syllabary& syllabary,
@@ -60,17 +64,34 @@ class ReverseDb : public MappedFile {
   the<StringTable> value_trie_;
 };
 
+class Projection;
+
 class ReverseLookupDictionary
     : public Class<ReverseLookupDictionary, const Ticket&> {
  public:
+  static const size_t kDefaultCacheCapacity = 1024;
+
   explicit ReverseLookupDictionary(an<ReverseDb> db);
   bool Load();
   bool ReverseLookup(const string& text, string* result);
+  size_t ReverseLookup(const vector<string>& texts, vector<string>* results);
+  // looks up the codes of a text, formatted with the given projection.
+  // the formatted results are cached, as the same candidates come up again
+  // on every keystroke while the user is paging through them.
+  bool ReverseLookup(const string& text,
+                     Projection* formatter,
+                     string* result);
   bool LookupStems(const string& text, string* result);
   an<DictSettings> GetDictSettings();
 
+  void set_cache_capacity(size_t capacity);
+  const LruCache<string, string>& cache() const { return cache_; }
+
  protected:
   an<ReverseDb> db_;
+  LruCache<string, string> cache_{kDefaultCacheCapacity};
+  // the formatter that produced the cached results.
+  Projection* cached_formatter_ = nullptr;
 };
 
 class ResourceResolver;
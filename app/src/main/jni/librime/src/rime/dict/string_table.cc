@@ -31,6 +31,18 @@ StringId StringTable::Lookup(const string& key) {
   }
 }
 
+void StringTable::Lookup(const vector<string>& keys,
+                         vector<StringId>* result) {
+  marisa::Agent agent;
+  result->clear();
+  result->reserve(keys.size());
+  for (const string& key : keys) {
+    agent.set_query(key.c_str(), key.length());
+    result->push_back(trie_.lookup(agent) ? agent.key().id()
+                                          : kInvalidStringId);
+  }
+}
+
 void StringTable::CommonPrefixMatch(const string& query,
                                     vector<StringId>* result) {
   marisa::Agent agent;
@@ -62,6 +74,22 @@ string StringTable::GetString(StringId string_id) {
   return string(agent.key().ptr(), agent.key().length());
 }
 
+void StringTable::GetStrings(const vector<StringId>& string_ids,
+                             vector<string>* result) {
+  marisa::Agent agent;
+  result->clear();
+  result->reserve(string_ids.size());
+  for (StringId string_id : string_ids) {
+    if (string_id == kInvalidStringId || string_id >= trie_.size()) {
+      result->emplace_back();
+      continue;
+    }
+    agent.set_query(string_id);
+    trie_.reverse_lookup(agent);
+    result->emplace_back(agent.key().ptr(), agent.key().length());
+  }
+}
+
 size_t StringTable::NumKeys() const {
   return trie_.size();
 }
@@ -28,9 +28,15 @@ class RIME_DLL StringTable {
 
   bool HasKey(const string& key);
   StringId Lookup(const string& key);
+  // looks up a batch of keys with a single agent; keys not found are mapped
+  // to kInvalidStringId.
+  void Lookup(const vector<string>& keys, vector<StringId>* result);
   void CommonPrefixMatch(const string& query, vector<StringId>* result);
   void Predict(const string& query, vector<StringId>* result);
   string GetString(StringId string_id);
+  // gets a batch of strings with a single agent; invalid ids yield empty
+  // strings.
+  void GetStrings(const vector<StringId>& string_ids, vector<string>* result);
 
   size_t NumKeys() const;
   size_t BinarySize() const;
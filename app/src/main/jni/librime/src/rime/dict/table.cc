@@ -309,6 +309,14 @@ bool Table::Load() {
     return false;
   }
 
+  // lookups begin at the head index, and read entry text from the string
+  // table; entries are scattered throughout the rest of the file.
+  size_t index_size = sizeof(table::HeadIndex);
+  if (index_->size > 1)
+    index_size += sizeof(table::HeadIndexNode) * (index_->size - 1);
+  Warmup({{metadata_, sizeof(table::Metadata)},
+          {index_, index_size},
+          {metadata_->string_table.get(), metadata_->string_table_size}});
   return OnLoad();
 }
 
@@ -574,21 +582,55 @@ bool Table::Query(const SyllableGraph& syll_graph,
   if (!result || !index_ || start_pos >= syll_graph.interpreted_length)
     return false;
   result->clear();
-  std::queue<pair<size_t, TableQuery>> q;
-  TableQuery initial_state(index_);
-  q.push({start_pos, initial_state});
+  TableQueryLattice lattice;
+  QueryFrom(syll_graph, {start_pos}, &lattice);
+  if (!lattice.empty())
+    result->swap(lattice.begin()->second);
+  return !result->empty();
+}
+
+bool Table::QueryLattice(const SyllableGraph& syll_graph,
+                         TableQueryLattice* lattice) {
+  if (!lattice || !index_)
+    return false;
+  lattice->clear();
+  vector<size_t> start_positions;
+  for (const auto& x : syll_graph.edges) {
+    if (x.first < syll_graph.interpreted_length)
+      start_positions.push_back(x.first);
+  }
+  QueryFrom(syll_graph, start_positions, lattice);
+  return !lattice->empty();
+}
+
+void Table::QueryFrom(const SyllableGraph& syll_graph,
+                      const vector<size_t>& start_positions,
+                      TableQueryLattice* lattice) {
+  struct State {
+    size_t start_pos;
+    size_t current_pos;
+    TableQuery query;
+  };
+  // paths from all start positions share one queue; states are moved rather
+  // than copied in and out of it.
+  std::queue<State> q;
+  for (size_t start_pos : start_positions) {
+    q.push({start_pos, start_pos, TableQuery(index_)});
+  }
   while (!q.empty()) {
-    size_t current_pos = q.front().first;
-    TableQuery query(q.front().second);
+    State state(std::move(q.front()));
     q.pop();
+    size_t current_pos = state.current_pos;
+    TableQuery& query = state.query;
     auto index = syll_graph.indices.find(current_pos);
     if (index == syll_graph.indices.end()) {
       continue;
     }
+    TableQueryResult& result = (*lattice)[state.start_pos];
     if (query.level() == Code::kIndexCodeMaxLength) {
       TableAccessor accessor(query.Access(-1));
       if (!accessor.exhausted()) {
-        (*result)[current_pos].push_back(accessor);
+        result[current_pos].push_back(accessor);
       }
       continue;
     }
@@ -615,18 +657,23 @@ bool Table::Query(const SyllableGraph& syll_graph,
         TableAccessor accessor =
             query.Access(syll_id, next_credibility, delta_quality_len);
         if (!accessor.exhausted()) {
-          (*result)[end_pos].push_back(accessor);
+          result[end_pos].push_back(accessor);
         }
         if (end_pos < syll_graph.interpreted_length &&
             query.Advance(syll_id, next_credibility, delta_quality_len,
                           current_pos)) {
-          q.push({end_pos, query});
+          q.push({state.start_pos, end_pos, query});
           query.Backdate();
         }
       }
     }
   }
-  return !result->empty();
+  for (auto it = lattice->begin(); it != lattice->end();) {
+    if (it->second.empty())
+      it = lattice->erase(it);
+    else
+      ++it;
+  }
 }
 
 string Table::GetEntryText(const table::Entry& entry) {
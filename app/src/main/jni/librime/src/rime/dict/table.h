@@ -139,6 +139,8 @@ class TableAccessor {
 };
 
 using TableQueryResult = map<int, vector<TableAccessor>>;
+// query results by start position.
+using TableQueryLattice = map<size_t, TableQueryResult>;
 
 struct SyllableGraph;
 
@@ -207,6 +209,9 @@ class Table : public MappedFile {
   RIME_DLL bool Query(const SyllableGraph& syll_graph,
                       size_t start_pos,
                       TableQueryResult* result);
+  // queries from every start position of the graph in a single traversal.
+  RIME_DLL bool QueryLattice(const SyllableGraph& syll_graph,
+                             TableQueryLattice* lattice);
   RIME_DLL string GetEntryText(const table::Entry& entry);
 
   uint32_t dict_file_checksum() const;
@@ -232,6 +237,9 @@ class Table : public MappedFile {
   bool OnBuildStart();
   bool OnBuildFinish();
   bool OnLoad();
+  void QueryFrom(const SyllableGraph& syll_graph,
+                 const vector<size_t>& start_positions,
+                 TableQueryLattice* lattice);
 
  protected:
   table::Metadata* metadata_ = nullptr;
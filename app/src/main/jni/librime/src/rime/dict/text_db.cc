@@ -86,6 +86,7 @@ bool TextDb::Update(const string& key, const string& value) {
   DLOG(INFO) << "update db entry: " << key << " => " << value;
   data_[key] = value;
   modified_ = true;
+  BumpGeneration();
   return true;
 }
 
@@ -96,6 +97,7 @@ bool TextDb::Erase(const string& key) {
   if (data_.erase(key) == 0)
     return false;
   modified_ = true;
+  BumpGeneration();
   return true;
 }
 
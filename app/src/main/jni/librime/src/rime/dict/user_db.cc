@@ -6,6 +6,7 @@
 //
 #include <algorithm>
 #include <cstdlib>
+#include <fstream>
 #include <sstream>
 #include <boost/algorithm/string.hpp>
 #include <rime/service.h>
@@ -112,11 +113,62 @@ bool UserDbHelper::IsUniformFormat(const path& file_path) {
                           plain_userdb_extension);
 }
 
+// the metadata of a db followed by extra fields, and its records; only those
+// of the given keys if any.
+class SnapshotSource : public DbSource {
+ public:
+  SnapshotSource(Db* db,
+                 const map<string, string>& metadata,
+                 const set<string>* keys)
+      : DbSource(db), extra_metadata_(metadata), keys_(keys) {
+    extra_ = extra_metadata_.begin();
+    if (keys_)
+      key_ = keys_->begin();
+  }
+
+  bool MetaGet(string* key, string* value) override {
+    while (DbSource::MetaGet(key, value)) {
+      if (!extra_metadata_.count(*key))
+        return true;
+    }
+    if (extra_ == extra_metadata_.end())
+      return false;
+    *key = extra_->first;
+    *value = extra_->second;
+    ++extra_;
+    return true;
+  }
+
+  bool Get(string* key, string* value) override {
+    if (!keys_)
+      return DbSource::Get(key, value);
+    for (; key_ != keys_->end(); ++key_) {
+      if (db_->Fetch(*key_, value)) {
+        *key = *key_++;
+        return true;
+      }
+    }
+    return false;
+  }
+
+ private:
+  const map<string, string>& extra_metadata_;
+  map<string, string>::const_iterator extra_;
+  const set<string>* keys_;
+  set<string>::const_iterator key_;
+};
+
 bool UserDbHelper::UniformBackup(const path& snapshot_file) {
+  return UniformBackup(snapshot_file, map<string, string>(), nullptr);
+}
+
+bool UserDbHelper::UniformBackup(const path& snapshot_file,
+                                 const map<string, string>& metadata,
+                                 const set<string>* keys) {
   LOG(INFO) << "backing up userdb '" << db_->name() << "' to " << snapshot_file;
   TsvWriter writer(snapshot_file, plain_userdb_format.formatter);
   writer.file_description = plain_userdb_format.file_description;
-  DbSource source(db_);
+  SnapshotSource source(db_, metadata, keys);
   try {
     writer << source;
   } catch (std::exception& ex) {
@@ -140,6 +192,45 @@ bool UserDbHelper::UniformRestore(const path& snapshot_file) {
   return true;
 }
 
+bool UserDbHelper::MergeSnapshot(const path& snapshot_file) {
+  LOG(INFO) << "merging snapshot " << snapshot_file << " into userdb '"
+            << db_->name() << "'.";
+  TsvReader reader(snapshot_file, plain_userdb_format.parser);
+  // written sorted by key, so the batch goes into the db in order.
+  auto* transactional = dynamic_cast<Transactional*>(db_);
+  bool batched = transactional && transactional->BeginTransaction();
+  try {
+    UserDbMerger merger(db_);
+    reader >> merger;
+  } catch (std::exception& ex) {
+    LOG(ERROR) << ex.what();
+    if (batched)
+      transactional->AbortTransaction();
+    return false;
+  }
+  return !batched || transactional->CommitTransaction();
+}
+
+bool UserDbHelper::ReadSnapshotMetadata(const path& snapshot_file,
+                                        map<string, string>* metadata) {
+  std::ifstream fin(snapshot_file.c_str());
+  if (!fin)
+    return false;
+  string line;
+  while (std::getline(fin, line)) {
+    boost::algorithm::trim_right(line);
+    if (line.empty())
+      continue;
+    if (line[0] != '#')
+      break;
+    size_t tab = line.find('\t');
+    if (boost::starts_with(line, "#@") && tab != string::npos) {
+      (*metadata)[line.substr(2, tab - 2)] = line.substr(tab + 1);
+    }
+  }
+  return true;
+}
+
 bool UserDbHelper::IsUserDb() {
   string db_type;
   return db_->MetaFetch("/db_type", &db_type) && (db_type == "userdb");
@@ -180,7 +271,7 @@ static TickCount get_tick_count(Db* db) {
   return 1;
 }
 
-UserDbMerger::UserDbMerger(Db* db) : db_(db) {
+UserDbMerger::UserDbMerger(Db* db) : db_(db), merged_entries_(0) {
   our_tick_ = get_tick_count(db);
   their_tick_ = 0;
   max_tick_ = our_tick_;
@@ -260,7 +351,12 @@ bool UserDbImporter::Put(const string& key, const string& value) {
   } else if (v.commits < 0) {  // mark as deleted
     o.commits = (std::min)(v.commits, -std::abs(o.commits));
   }
-  return db_->Update(key, o.Pack());
+  if (!db_->Update(key, o.Pack()))
+    return false;
+  // imported entries are ours to sync, unlike those merged from peers.
+  if (auto* change_log = dynamic_cast<ChangeLog*>(db_))
+    change_log->LogChange(key);
+  return true;
 }
 
 }  // namespace rime
@@ -64,7 +64,17 @@ class UserDbHelper {
   RIME_DLL bool UpdateUserInfo();
   RIME_DLL static bool IsUniformFormat(const path& file_path);
   RIME_DLL bool UniformBackup(const path& snapshot_file);
+  // backs up only the records of the given keys, or all if null, with extra
+  // metadata in the header.
+  RIME_DLL bool UniformBackup(const path& snapshot_file,
+                              const map<string, string>& metadata,
+                              const set<string>* keys);
   RIME_DLL bool UniformRestore(const path& snapshot_file);
+  // merges a snapshot from another device in a single transaction.
+  RIME_DLL bool MergeSnapshot(const path& snapshot_file);
+  // reads the header of a snapshot, leaving the records.
+  RIME_DLL static bool ReadSnapshotMetadata(const path& snapshot_file,
+                                            map<string, string>* metadata);
 
   bool IsUserDb();
   string GetDbName();
@@ -169,6 +169,7 @@ void UserDictionary::Attach(const an<Table>& table, const an<Prism>& prism) {
 bool UserDictionary::Load() {
   if (!db_ || db_->disabled())
     return false;
+  std::unique_lock<std::mutex> lock(db_->load_mutex());
   if (!db_->loaded() && !db_->Open()) {
     // try to recover managed db in available work thread
     Deployer& deployer(Service::instance().deployer());
@@ -179,6 +180,7 @@ bool UserDictionary::Load() {
     }
     return false;
   }
+  lock.unlock();
   return FetchTickCount() || Initialize();
 }
 
@@ -311,6 +313,29 @@ static an<UserDictEntryCollector> collect(
   return result;
 }
 
+// sorts each group of homophones by weight.
+static an<UserDictEntryCollector> collect_sorted(DfsState* state) {
+  for (auto& v : state->query_result) {
+    auto& entries = v.second;
+    entries.Sort();
+    if (state->predict_word_from_depth) {
+      if (!entries.empty() && entries.front()->IsPredictiveMatch()) {
+        DLOG(INFO) << "front entry is predictive match: "
+                   << entries.front()->text;
+        auto found =
+            std::find_if(entries.begin(), entries.end(),
+                         [](const auto& e) { return e->IsExactMatch(); });
+        if (found != entries.end()) {
+          DLOG(INFO) << "rotating exact match entry to front: "
+                     << (*found)->text;
+          std::rotate(entries.begin(), found, found + 1);
+        }
+      }
+    }
+  }
+  return collect(&state->query_result);
+}
+
 an<UserDictEntryCollector> UserDictionary::Lookup(
     const SyllableGraph& syll_graph,
     size_t start_pos,
@@ -333,26 +358,40 @@ an<UserDictEntryCollector> UserDictionary::Lookup(
   DfsLookup(syll_graph, start_pos, prefix, &state);
   if (state.query_result.empty())
     return nullptr;
-  // sort each group of homophones by weight
-  for (auto& v : state.query_result) {
-    auto& entries = v.second;
-    entries.Sort();
-    if (state.predict_word_from_depth) {
-      if (!entries.empty() && entries.front()->IsPredictiveMatch()) {
-        DLOG(INFO) << "front entry is predictive match: "
-                   << entries.front()->text;
-        auto found =
-            std::find_if(entries.begin(), entries.end(),
-                         [](const auto& e) { return e->IsExactMatch(); });
-        if (found != entries.end()) {
-          DLOG(INFO) << "rotating exact match entry to front: "
-                     << (*found)->text;
-          std::rotate(entries.begin(), found, found + 1);
-        }
-      }
-    }
+  return collect_sorted(&state);
+}
+
+an<UserDictEntryLattice> UserDictionary::LookupLattice(
+    const SyllableGraph& syll_graph,
+    size_t depth_limit,
+    double initial_credibility) {
+  if (!table_ || !prism_ || !loaded())
+    return nullptr;
+  DfsState state;
+  state.depth_limit = depth_limit;
+  state.predict_word_from_depth = 0;
+  FetchTickCount();
+  state.present_tick = tick_ + 1;
+  state.credibility.push_back(initial_credibility);
+  state.quality_len.push_back(0.0);
+  state.accessor = db_->Query("");
+  auto lattice = New<UserDictEntryLattice>();
+  for (const auto& x : syll_graph.edges) {
+    size_t start_pos = x.first;
+    if (start_pos >= syll_graph.interpreted_length)
+      continue;
+    // the cursor jumps back to the first prefix from this position.
+    state.key.clear();
+    state.value.clear();
+    DfsLookup(syll_graph, start_pos, string(), &state);
+    if (state.query_result.empty())
+      continue;
+    (*lattice)[start_pos] = std::move(*collect_sorted(&state));
+    state.query_result.clear();
   }
-  return collect(&state.query_result);
+  if (lattice->empty())
+    return nullptr;
+  return lattice;
 }
 
 size_t UserDictionary::LookupWords(UserDictEntryIterator* result,
@@ -429,6 +468,7 @@ bool UserDictionary::UpdateEntry(const DictEntry& entry,
   if (code_str.empty() && !TranslateCodeToString(entry.code, &code_str))
     return false;
   string key(code_str + '\t' + entry.text);
+  CommitForeignTransaction();
   string value;
   UserDbValue v;
   if (db_->Fetch(key, &value)) {
@@ -453,10 +493,16 @@ bool UserDictionary::UpdateEntry(const DictEntry& entry,
     v.dee = algo::formula_d(0.0, (double)tick_, v.dee, (double)v.tick);
   }
   v.tick = tick_;
-  return db_->Update(key, v.Pack());
+  if (!db_->Update(key, v.Pack()))
+    return false;
+  // picked up by the next sync.
+  if (auto change_log = As<ChangeLog>(db_))
+    change_log->LogChange(key);
+  return true;
 }
 
 bool UserDictionary::UpdateTickCount(TickCount increment) {
+  CommitForeignTransaction();
   tick_ += increment;
   try {
     return db_->MetaUpdate("/tick", std::to_string(tick_));
@@ -483,18 +529,26 @@ bool UserDictionary::FetchTickCount() {
   }
 }
 
+// the db is shared by the user dictionaries of all sessions; a transaction
+// belongs to the one that began it, and writes of the others stay out of it.
+
 bool UserDictionary::NewTransaction() {
   auto db = As<Transactional>(db_);
   if (!db)
     return false;
-  CommitPendingTransaction();
+  // a pending transaction, whoever began it, ends here.
+  if (db->in_transaction())
+    db->CommitTransaction();
   transaction_time_ = time(NULL);
-  return db->BeginTransaction();
+  if (!db->BeginTransaction())
+    return false;
+  db->set_transaction_owner(this);
+  return true;
 }
 
 bool UserDictionary::RevertRecentTransaction() {
   auto db = As<Transactional>(db_);
-  if (!db || !db->in_transaction())
+  if (!db || !db->in_transaction() || db->transaction_owner() != this)
     return false;
   if (time(NULL) - transaction_time_ > 3 /*seconds*/)
     return false;
@@ -503,12 +557,18 @@ bool UserDictionary::RevertRecentTransaction() {
 
 bool UserDictionary::CommitPendingTransaction() {
   auto db = As<Transactional>(db_);
-  if (db && db->in_transaction()) {
+  if (db && db->in_transaction() && db->transaction_owner() == this) {
     return db->CommitTransaction();
   }
   return false;
 }
 
+void UserDictionary::CommitForeignTransaction() {
+  auto db = As<Transactional>(db_);
+  if (db && db->in_transaction() && db->transaction_owner() != this)
+    db->CommitTransaction();
+}
+
 bool UserDictionary::TranslateCodeToString(const Code& code, string* result) {
   if (!table_ || !result)
     return false;
@@ -571,7 +631,9 @@ an<DictEntry> UserDictionary::CreateDictEntry(const string& key,
 UserDictionaryComponent::UserDictionaryComponent() {}
 
 UserDictionary* UserDictionaryComponent::Create(const string& dict_name,
-                                                const string& db_class) {
+                                                const string& db_class,
+                                                int flush_interval) {
+  std::lock_guard<std::mutex> lock(mutex_);
   auto db = db_pool_[dict_name].lock();
   if (!db) {
     auto component = Db::Require(db_class);
@@ -580,6 +642,10 @@ UserDictionary* UserDictionaryComponent::Create(const string& dict_name,
       return NULL;
     }
     db.reset(component->Create(dict_name));
+    if (flush_interval > 0) {
+      if (auto write_behind = As<WriteBehind>(db))
+        write_behind->set_flush_interval(flush_interval);
+    }
     db_pool_[dict_name] = db;
   }
   return new UserDictionary(dict_name, db);
@@ -608,8 +674,13 @@ UserDictionary* UserDictionaryComponent::Create(const Ticket& ticket) {
   if (config->GetString(ticket.name_space + "/db_class", &db_class)) {
     // user specified db class
   }
+  // write-behind is opt-in; it bounds how much learning is lost should the
+  // process crash, in milliseconds.
+  int flush_interval = 0;
+  config->GetInt(ticket.name_space + "/user_dict_flush_interval",
+                 &flush_interval);
   // obtain userdb object
-  return Create(dict_name, db_class);
+  return Create(dict_name, db_class, flush_interval);
 }
 
 }  // namespace rime
@@ -8,6 +8,7 @@
 #define RIME_USER_DICTIONARY_H_
 
 #include <time.h>
+#include <mutex>
 #include <rime/common.h>
 #include <rime/component.h>
 #include <rime/dict/user_db.h>
@@ -37,6 +38,8 @@ class UserDictEntryIterator : public DictEntryFilterBinder {
 };
 
 using UserDictEntryCollector = map<size_t, UserDictEntryIterator>;
+// entries by start position, then by end position.
+using UserDictEntryLattice = map<size_t, UserDictEntryCollector>;
 
 class Schema;
 class Table;
@@ -61,6 +64,11 @@ class UserDictionary : public Class<UserDictionary, const Ticket&> {
                                     size_t depth_limit = 0,
                                     size_t predict_word_from_depth = 0,
                                     double initial_credibility = 0.0);
+  // looks up phrases from every start position of the graph, sharing one
+  // db cursor.
+  an<UserDictEntryLattice> LookupLattice(const SyllableGraph& syllable_graph,
+                                         size_t depth_limit = 0,
+                                         double initial_credibility = 0.0);
   size_t LookupWords(UserDictEntryIterator* result,
                      const string& input,
                      bool predictive,
@@ -89,6 +97,8 @@ class UserDictionary : public Class<UserDictionary, const Ticket&> {
  protected:
   bool Initialize();
   bool FetchTickCount();
+  // commits the transaction another dictionary has left pending on the db.
+  void CommitForeignTransaction();
   bool TranslateCodeToString(const Code& code, string* result);
   void DfsLookup(const SyllableGraph& syll_graph,
                  size_t current_pos,
@@ -110,10 +120,15 @@ class UserDictionaryComponent : public UserDictionary::Component {
  public:
   UserDictionaryComponent();
   UserDictionary* Create(const Ticket& ticket);
-  UserDictionary* Create(const string& dict_name, const string& db_class);
+  // with a positive flush_interval, a db that supports it stores learning in
+  // the background; the db is shared, and the dictionary creating it decides.
+  UserDictionary* Create(const string& dict_name,
+                         const string& db_class,
+                         int flush_interval = 0);
 
  private:
   hash_map<string, weak<Db>> db_pool_;
+  std::mutex mutex_;
 };
 
 }  // namespace rime
@@ -4,7 +4,9 @@
 //
 // 2011-04-24 GONG Chen <chen.sst@gmail.com>
 //
+#include <algorithm>
 #include <cctype>
+#include <mutex>
 #include <rime/common.h>
 #include <rime/composition.h>
 #include <rime/context.h>
@@ -13,18 +15,27 @@
 #include <rime/formatter.h>
 #include <rime/key_event.h>
 #include <rime/menu.h>
+#include <rime/preloader.h>
 #include <rime/processor.h>
+#include <rime/registry.h>
 #include <rime/schema.h>
 #include <rime/segmentation.h>
 #include <rime/segmentor.h>
+#include <rime/service.h>
 #include <rime/switcher.h>
 #include <rime/switches.h>
 #include <rime/ticket.h>
+#include <rime/tracer.h>
 #include <rime/translation.h>
 #include <rime/translator.h>
+#include <rime/algo/lru_cache.h>
+#include <rime/dict/db.h>
 
 namespace rime {
 
+static const Atom kPlaceholderTag = AtomTable::tags().Intern("placeholder");
+static const Atom kAutoCommit = AtomTable::options().Intern("_auto_commit");
+
 class ConcreteEngine : public Engine {
  public:
   ConcreteEngine();
@@ -37,8 +48,11 @@ class ConcreteEngine : public Engine {
  protected:
   void InitializeComponents();
   void InitializeOptions();
+  void PreloadResources(Config* config);
+  const string* trace_label(const void* component) const;
   void CalculateSegmentation(Segmentation* segments);
-  void TranslateSegments(Segmentation* segments);
+  void TranslateSegments(Composition* comp);
+  void InvalidateTranslations();
   void FormatText(string* text);
   void OnCommit(Context* ctx);
   void OnSelect(Context* ctx);
@@ -51,8 +65,24 @@ class ConcreteEngine : public Engine {
   vector<of<Translator>> translators_;
   vector<of<Filter>> filters_;
   vector<of<Formatter>> formatters_;
+  // resources of the schema being loaded in the background.
+  Preloader::Handles preloaded_;
   vector<of<Processor>> post_processors_;
   an<Switcher> switcher_;
+  // names of the components in traces, by the prescriptions in the schema.
+  hash_map<const void*, string> trace_labels_;
+
+  // recent translations of segments, reused when a segment is translated
+  // again with the same input, tags and preceding text.
+  struct CachedTranslation {
+    an<Menu> menu;
+    string prompt;  // may have been set by translators
+  };
+  static constexpr int kDefaultMenuCacheSize = 32;
+  LruCache<string, CachedTranslation> menu_cache_{kDefaultMenuCacheSize};
+  // of user dbs when the cached menus were made; other sessions sharing a
+  // user dictionary may have updated it since.
+  uint64_t menu_cache_generation_ = 0;
 };
 
 // implementations
@@ -83,6 +113,9 @@ ConcreteEngine::ConcreteEngine() {
       [this](Context* ctx, const string& property) {
         OnPropertyUpdate(ctx, property);
       });
+  // deleting a candidate updates the user dictionary.
+  context_->delete_notifier().connect(
+      [this](Context* ctx) { InvalidateTranslations(); });
 
   switcher_ = New<Switcher>(this);
   // saved options should be loaded only once per input session
@@ -96,10 +129,22 @@ ConcreteEngine::~ConcreteEngine() {
   LOG(INFO) << "engine disposed.";
 }
 
+const string* ConcreteEngine::trace_label(const void* component) const {
+  static const string kUnknown("unknown");
+  auto found = trace_labels_.find(component);
+  return found != trace_labels_.end() ? &found->second : &kUnknown;
+}
+
 bool ConcreteEngine::ProcessKey(const KeyEvent& key_event) {
   DLOG(INFO) << "process key: " << key_event;
+  static const string kKey("key");
+  const bool tracing = Tracer::enabled();
+  const string key_repr = tracing ? key_event.repr() : string();
+  TraceScope key_scope("engine", tracing ? &kKey : nullptr, &key_repr);
   ProcessResult ret = kNoop;
   for (auto& processor : processors_) {
+    TraceScope scope("processor",
+                     tracing ? trace_label(processor.get()) : nullptr);
     ret = processor->ProcessKeyEvent(key_event);
     if (ret == kRejected)
       break;
@@ -108,8 +153,11 @@ bool ConcreteEngine::ProcessKey(const KeyEvent& key_event) {
   }
   // record unhandled keys, eg. spaces, numbers, bksp's.
   context_->commit_history().Push(key_event);
+  InvalidateTranslations();
   // post-processing
   for (auto& processor : post_processors_) {
+    TraceScope scope("processor",
+                     tracing ? trace_label(processor.get()) : nullptr);
     ret = processor->ProcessKeyEvent(key_event);
     if (ret == kRejected)
       break;
@@ -124,6 +172,10 @@ bool ConcreteEngine::ProcessKey(const KeyEvent& key_event) {
 void ConcreteEngine::OnContextUpdate(Context* ctx) {
   if (!ctx)
     return;
+  if (ctx->input().empty()) {
+    // cached menus only live through one composition.
+    InvalidateTranslations();
+  }
   Compose(ctx);
 }
 
@@ -131,6 +183,7 @@ void ConcreteEngine::OnOptionUpdate(Context* ctx, const string& option) {
   if (!ctx)
     return;
   LOG(INFO) << "updated option: " << option;
+  InvalidateTranslations();
   // apply new option to active segment
   if (ctx->IsComposing()) {
     ctx->RefreshNonConfirmedComposition();
@@ -145,6 +198,7 @@ void ConcreteEngine::OnPropertyUpdate(Context* ctx, const string& property) {
   if (!ctx)
     return;
   LOG(INFO) << "updated property: " << property;
+  InvalidateTranslations();
   // notification
   string value = ctx->get_property(property);
   string msg(property + "=" + value);
@@ -177,7 +231,10 @@ void ConcreteEngine::CalculateSegmentation(Segmentation* segments) {
     DLOG(INFO) << "start pos: " << start_pos;
     DLOG(INFO) << "end pos: " << end_pos;
     // recognize a segment by calling the segmentors in turn
+    const bool tracing = Tracer::enabled();
     for (auto& segmentor : segmentors_) {
+      TraceScope scope("segmentor",
+                       tracing ? trace_label(segmentor.get()) : nullptr);
       if (!segmentor->Proceed(segments))
         break;
     }
@@ -194,54 +251,95 @@ void ConcreteEngine::CalculateSegmentation(Segmentation* segments) {
       segments->Forward();
   }
   // start an empty segment only at the end of a confirmed composition.
-  if (!segments->empty() && !segments->back().HasTag("placeholder"))
+  if (!segments->empty() && !segments->back().HasTag(kPlaceholderTag))
     segments->Trim();
   if (!segments->empty() && segments->back().status >= Segment::kSelected)
     segments->Forward();
 }
 
-void ConcreteEngine::TranslateSegments(Segmentation* segments) {
-  DLOG(INFO) << "TranslateSegments: " << *segments;
-  for (Segment& segment : *segments) {
+void ConcreteEngine::TranslateSegments(Composition* comp) {
+  DLOG(INFO) << "TranslateSegments: " << *comp;
+  uint64_t generation = Db::generation();
+  if (generation != menu_cache_generation_) {
+    menu_cache_.Clear();
+    menu_cache_generation_ = generation;
+  }
+  for (Segment& segment : *comp) {
     DLOG(INFO) << "segment [" << segment.start << ", " << segment.end
                << "), status: " << segment.status;
     if (segment.status >= Segment::kGuess)
       continue;
     size_t len = segment.end - segment.start;
-    string input = segments->input().substr(segment.start, len);
+    string input = comp->input().substr(segment.start, len);
+    // translators may look at the whole input and the text before segment.
+    string cache_key = std::to_string(segment.start) + ',' +
+                       std::to_string(segment.end) + '\t' + comp->input() +
+                       '\t' + comp->GetTextBefore(segment.start);
+    for (const string& tag : segment.tags) {
+      cache_key += '\t' + tag;
+    }
+    const auto* cached = menu_cache_.Find(cache_key);
+    TraceCacheLookup("menu", cached);
+    if (cached) {
+      DLOG(INFO) << "reusing translation of segment: [" << input << "]";
+      segment.status = Segment::kGuess;
+      segment.menu = cached->menu;
+      segment.prompt = cached->prompt;
+      segment.selected_index = 0;
+      continue;
+    }
     DLOG(INFO) << "translating segment: [" << input << "]";
     auto menu = New<Menu>();
+    const bool tracing = Tracer::enabled();
     for (auto& translator : translators_) {
-      auto translation = translator->Query(input, segment);
+      const string* label = tracing ? trace_label(translator.get()) : nullptr;
+      an<Translation> translation;
+      {
+        TraceScope scope("translator", label);
+        translation = translator->Query(input, segment);
+      }
       if (!translation)
         continue;
       if (translation->exhausted()) {
         DLOG(INFO) << translator->name_space() << " made a futile translation.";
         continue;
       }
-      menu->AddTranslation(translation);
+      // candidates are made as the menu pages through them.
+      menu->AddTranslation(
+          label ? TraceTranslation(translation, "translator", *label)
+                : translation);
     }
     for (auto& filter : filters_) {
       if (filter->AppliesToSegment(&segment)) {
-        menu->AddFilter(filter.get());
+        menu->AddFilter(filter.get(),
+                        tracing ? trace_label(filter.get()) : nullptr);
       }
     }
     segment.status = Segment::kGuess;
     segment.menu = menu;
     segment.selected_index = 0;
+    menu_cache_.Insert(cache_key, {menu, segment.prompt});
   }
 }
 
+void ConcreteEngine::InvalidateTranslations() {
+  menu_cache_.Clear();
+}
+
 void ConcreteEngine::FormatText(string* text) {
   if (formatters_.empty())
     return;
   DLOG(INFO) << "applying formatters.";
+  const bool tracing = Tracer::enabled();
   for (auto& formatter : formatters_) {
+    TraceScope scope("formatter",
+                     tracing ? trace_label(formatter.get()) : nullptr);
     formatter->Format(text);
   }
 }
 
 void ConcreteEngine::CommitText(string text) {
+  InvalidateTranslations();
   context_->commit_history().Push(CommitRecord{"raw", text});
   FormatText(&text);
   DLOG(INFO) << "committing text: " << text;
@@ -249,6 +347,8 @@ void ConcreteEngine::CommitText(string text) {
 }
 
 void ConcreteEngine::OnCommit(Context* ctx) {
+  // committing updates the user dictionary and the commit history.
+  InvalidateTranslations();
   context_->commit_history().Push(ctx->composition(), ctx->input());
   string text = ctx->GetCommitText();
   FormatText(&text);
@@ -257,6 +357,7 @@ void ConcreteEngine::OnCommit(Context* ctx) {
 }
 
 void ConcreteEngine::OnSelect(Context* ctx) {
+  InvalidateTranslations();
   Segment& seg(ctx->composition().back());
   seg.Close();
   if (seg.end == ctx->input().length()) {
@@ -264,7 +365,7 @@ void ConcreteEngine::OnSelect(Context* ctx) {
     seg.status = Segment::kConfirmed;
     // strategy one: commit directly;
     // strategy two: continue composing with another empty segment.
-    if (ctx->get_option("_auto_commit"))
+    if (ctx->get_option(kAutoCommit))
       ctx->Commit();
     else
       ctx->composition().Forward();
@@ -299,7 +400,8 @@ inline void CreateComponentsFromList(Engine* engine,
                                      Config* config,
                                      const string& config_key,
                                      const string& component_type,
-                                     vector<an<T>>& target_collection) {
+                                     vector<an<T>>& target_collection,
+                                     hash_map<const void*, string>& labels) {
   if (auto component_list = config->GetList(config_key)) {
     size_t n = component_list->size();
     for (size_t i = 0; i < n; ++i) {
@@ -321,20 +423,30 @@ inline void CreateComponentsFromList(Engine* engine,
       }
       an<T> instance(component);
       target_collection.push_back(instance);
+      labels[component] = prescription->str();
     }
   }
 }
 
+std::recursive_mutex& Engine::shared_mutex() {
+  static std::recursive_mutex mutex;
+  return mutex;
+}
+
 void ConcreteEngine::InitializeComponents() {
+  std::lock_guard<std::recursive_mutex> lock(shared_mutex());
+  InvalidateTranslations();
   processors_.clear();
   segmentors_.clear();
   translators_.clear();
   filters_.clear();
   formatters_.clear();
   post_processors_.clear();
+  trace_labels_.clear();
 
   if (switcher_) {
     processors_.push_back(switcher_);
+    trace_labels_[switcher_.get()] = "switcher";
     if (schema_->schema_id() == ".default") {
       if (Schema* schema = switcher_->CreateSchema()) {
         schema_.reset(schema);
@@ -346,20 +458,29 @@ void ConcreteEngine::InitializeComponents() {
   if (!config)
     return;
 
+  int menu_cache_size = kDefaultMenuCacheSize;
+  config->GetInt("menu/cache_size", &menu_cache_size);
+  menu_cache_ =
+      LruCache<string, CachedTranslation>((std::max)(0, menu_cache_size));
+
+  PreloadResources(config);
+
   // Create components using inline template function
   CreateComponentsFromList<Processor>(this, config, "engine/processors",
-                                      "processor", processors_);
+                                      "processor", processors_, trace_labels_);
   CreateComponentsFromList<Segmentor>(this, config, "engine/segmentors",
-                                      "segmentor", segmentors_);
+                                      "segmentor", segmentors_, trace_labels_);
   CreateComponentsFromList<Translator>(this, config, "engine/translators",
-                                       "translator", translators_);
+                                       "translator", translators_,
+                                       trace_labels_);
   CreateComponentsFromList<Filter>(this, config, "engine/filters", "filter",
-                                   filters_);
+                                   filters_, trace_labels_);
   // create formatters
   auto c_formatter = Formatter::Require("shape_formatter");
   if (c_formatter) {
     an<Formatter> f(c_formatter->Create(Ticket(this)));
     formatters_.push_back(f);
+    trace_labels_[f.get()] = "shape_formatter";
   } else {
     LOG(WARNING) << "shape_formatter not available.";
   }
@@ -368,11 +489,38 @@ void ConcreteEngine::InitializeComponents() {
   if (c_processor) {
     an<Processor> p(c_processor->Create(Ticket(this)));
     post_processors_.push_back(p);
+    trace_labels_[p.get()] = "shape_processor";
   } else {
     LOG(WARNING) << "shape_processor not available.";
   }
 }
 
+// the loader thread gets on with the dictionaries while the components are
+// being created; lazy ones find them loaded at the first key event.
+void ConcreteEngine::PreloadResources(Config* config) {
+  Preloader& preloader(Service::instance().preloader());
+  Preloader::Handles handles;
+  auto preload = [&](const string& config_key, const string& component_type) {
+    auto component_list = config->GetList(config_key);
+    if (!component_list)
+      return;
+    for (size_t i = 0; i < component_list->size(); ++i) {
+      auto prescription = As<ConfigValue>(component_list->GetAt(i));
+      if (!prescription)
+        continue;
+      Ticket ticket{this, component_type, prescription->str()};
+      if (auto* component = dynamic_cast<Preloadable*>(
+              Registry::instance().Find(ticket.klass))) {
+        component->Preload(ticket, &preloader, &handles);
+      }
+    }
+  };
+  preload("engine/translators", "translator");
+  preload("engine/filters", "filter");
+  // resources shared with the previous schema stay loaded.
+  preloaded_.swap(handles);
+}
+
 void ConcreteEngine::InitializeOptions() {
   LOG(INFO) << "ConcreteEngine::InitializeOptions";
   // reset custom switches
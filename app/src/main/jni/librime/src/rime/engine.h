@@ -7,6 +7,7 @@
 #ifndef RIME_ENGINE_H_
 #define RIME_ENGINE_H_
 
+#include <mutex>
 #include <rime_api.h>
 #include <rime/common.h>
 #include <rime/messenger.h>
@@ -36,6 +37,14 @@ class Engine : public Messenger {
 
   RIME_DLL static Engine* Create();
 
+  // engines of all sessions share components: dictionaries and user dbs, and
+  // in plugins, the Lua state and prediction engines. none of them is safe to
+  // use from several threads, so engines work one at a time under this lock;
+  // it is held while building components and while driving a session.
+  // recursive, as the switcher creates schemas and notification handlers may
+  // call back into the session.
+  RIME_DLL static std::recursive_mutex& shared_mutex();
+
  protected:
   Engine();
 
@@ -15,6 +15,8 @@
 
 namespace rime {
 
+static const Atom kAsciiMode = AtomTable::options().Intern("ascii_mode");
+
 static struct AsciiModeSwitchStyleDefinition {
   const char* repr;
   AsciiModeSwitchStyle style;
@@ -126,7 +128,7 @@ ProcessResult AsciiComposer::ProcessKeyEvent(const KeyEvent& key_event) {
     return kNoop;
   }
   Context* ctx = engine_->context();
-  bool ascii_mode = ctx->get_option("ascii_mode");
+  bool ascii_mode = ctx->get_option(kAsciiMode);
   if (ascii_mode) {
     if (!ctx->IsComposing()) {
       return kRejected;  // direct commit
@@ -150,7 +152,7 @@ ProcessResult AsciiComposer::ProcessCapsLock(const KeyEvent& key_event) {
       // in case the user switched to ascii mode with other keys, eg. with Shift
       if (good_old_caps_lock_ && !toggle_with_caps_) {
         Context* ctx = engine_->context();
-        bool ascii_mode = ctx->get_option("ascii_mode");
+        bool ascii_mode = ctx->get_option(kAsciiMode);
         if (ascii_mode) {
           return kRejected;
         }
@@ -228,7 +230,7 @@ bool AsciiComposer::ToggleAsciiModeWithKey(int key_code) {
     return false;
   AsciiModeSwitchStyle style = it->second;
   Context* ctx = engine_->context();
-  bool old_mode = ctx->get_option("ascii_mode");
+  bool old_mode = ctx->get_option(kAsciiMode);
   bool new_mode = (style == kAsciiModeSet)     ? true
                   : (style == kAsciiModeUnset) ? false
                                                : !old_mode;
@@ -14,10 +14,12 @@
 
 namespace rime {
 
+static const Atom kAsciiMode = AtomTable::options().Intern("ascii_mode");
+
 AsciiSegmentor::AsciiSegmentor(const Ticket& ticket) : Segmentor(ticket) {}
 
 bool AsciiSegmentor::Proceed(Segmentation* segmentation) {
-  if (!engine_->context()->get_option("ascii_mode"))
+  if (!engine_->context()->get_option(kAsciiMode))
     return true;
   const string& input = segmentation->input();
   size_t j = segmentation->GetCurrentStartPosition();
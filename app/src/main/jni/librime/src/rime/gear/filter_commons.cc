@@ -19,6 +19,7 @@ TagMatching::TagMatching(const Ticket& ticket) {
     for (auto it = tags->begin(); it != tags->end(); ++it) {
       if (Is<ConfigValue>(*it)) {
         tags_.push_back(As<ConfigValue>(*it)->str());
+        tag_set_.insert(tags_.back());
       }
     }
   }
@@ -29,11 +30,7 @@ bool TagMatching::TagsMatch(Segment* segment) {
     return false;
   if (tags_.empty())  // match any
     return true;
-  for (const string& tag : tags_) {
-    if (segment->HasTag(tag))
-      return true;
-  }
-  return false;
+  return segment->HasAnyTagIn(tag_set_);
 }
 
 }  // namespace rime
@@ -7,9 +7,10 @@
 #ifndef RIME_FILTER_COMMONS_H_
 #define RIME_FILTER_COMMONS_H_
 
+#include <rime/segmentation.h>
+
 namespace rime {
 
-struct Segment;
 struct Ticket;
 
 class TagMatching {
@@ -19,6 +20,7 @@ class TagMatching {
 
  protected:
   vector<string> tags_;
+  TagSet tag_set_;
 };
 
 }  // namespace rime
@@ -33,6 +33,7 @@
 #include <rime/gear/switch_translator.h>
 #include <rime/gear/table_translator.h>
 #include <rime/gear/uniquifier.h>
+#include <rime/preloader.h>
 #include <rime/registry.h>
 #include <rime_api.h>
 
@@ -67,11 +68,12 @@ static void rime_gears_initialize() {
   // translators
   r.Register("echo_translator", new Component<EchoTranslator>);
   r.Register("punct_translator", new Component<PunctTranslator>);
-  r.Register("table_translator", new Component<TableTranslator>);
-  r.Register("script_translator", new Component<ScriptTranslator>);
-  r.Register("r10n_translator", new Component<ScriptTranslator>);  // alias
+  r.Register("table_translator", new PreloadingComponent<TableTranslator>);
+  r.Register("script_translator", new PreloadingComponent<ScriptTranslator>);
+  r.Register("r10n_translator",
+             new PreloadingComponent<ScriptTranslator>);  // alias
   r.Register("reverse_lookup_translator",
-             new Component<ReverseLookupTranslator>);
+             new PreloadingComponent<ReverseLookupTranslator>);
   r.Register("schema_list_translator", new Component<SchemaListTranslator>);
   r.Register("switch_translator", new Component<SwitchTranslator>);
   r.Register("history_translator", new Component<HistoryTranslator>);
@@ -83,7 +85,8 @@ static void rime_gears_initialize() {
     r.Register("charset_filter", new Component<CharsetFilter>);
   }
   r.Register("cjk_minifier", new Component<CharsetFilter>);  // alias
-  r.Register("reverse_lookup_filter", new Component<ReverseLookupFilter>);
+  r.Register("reverse_lookup_filter",
+             new PreloadingComponent<ReverseLookupFilter>);
   r.Register("single_char_filter", new Component<SingleCharFilter>);
 
   // formatters
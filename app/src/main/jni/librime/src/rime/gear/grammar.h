@@ -11,6 +11,8 @@ class Config;
 class Grammar : public Class<Grammar, Config*> {
  public:
   virtual ~Grammar() {}
+  // loads the data ahead of the first query, which loads it otherwise.
+  virtual bool Load() { return true; }
   virtual double Query(const string& context,
                        const string& word,
                        bool is_rear) = 0;
@@ -61,17 +61,10 @@ Memory::Memory(const Ticket& ticket) {
 
   if (auto dictionary = Dictionary::Require("dictionary")) {
     dict_.reset(dictionary->Create(ticket));
-    if (dict_)
-      dict_->Load();
   }
 
   if (auto user_dictionary = UserDictionary::Require("user_dictionary")) {
     user_dict_.reset(user_dictionary->Create(ticket));
-    if (user_dict_) {
-      user_dict_->Load();
-      if (dict_)
-        user_dict_->Attach(dict_->primary_table(), dict_->prism());
-    }
   }
 
   // user dictionary is named after language; dictionary name may have an
@@ -90,6 +83,35 @@ Memory::Memory(const Ticket& ticket) {
       [this](Context* ctx, const KeyEvent& key) { OnUnhandledKey(ctx, key); });
 }
 
+void Memory::Preload(const Ticket& ticket,
+                     Preloader* preloader,
+                     Preloader::Handles* handles) {
+  an<Dictionary> dict;
+  if (auto dictionary = Dictionary::Require("dictionary")) {
+    dict.reset(dictionary->Create(ticket));
+  }
+  // the user db first, while the engine thread is still on the dictionary.
+  if (auto user_dictionary = UserDictionary::Require("user_dictionary")) {
+    an<UserDictionary> user_dict(user_dictionary->Create(ticket));
+    if (user_dict)
+      handles->push_back(preloader->Load(user_dict));
+  }
+  if (dict)
+    handles->push_back(preloader->Load(dict));
+}
+
+void Memory::LoadDictionaries() {
+  std::call_once(dictionaries_loaded_, [this] {
+    if (dict_)
+      dict_->Load();
+    if (user_dict_) {
+      user_dict_->Load();
+      if (dict_)
+        user_dict_->Attach(dict_->primary_table(), dict_->prism());
+    }
+  });
+}
+
 Memory::~Memory() {
   commit_connection_.disconnect();
   delete_connection_.disconnect();
@@ -126,6 +148,7 @@ bool Memory::ProcessSegmentOnCommit(CommitEntry& commit_entry,
 }
 
 void Memory::OnCommit(Context* ctx) {
+  LoadDictionaries();
   if (!user_dict_ || user_dict_->readonly())
     return;
   StartSession();
@@ -136,6 +159,7 @@ void Memory::OnCommit(Context* ctx) {
 }
 
 void Memory::OnDeleteEntry(Context* ctx) {
+  LoadDictionaries();
   if (!user_dict_ || user_dict_->readonly() || !ctx || !ctx->HasMenu())
     return;
   auto phrase =
@@ -149,6 +173,7 @@ void Memory::OnDeleteEntry(Context* ctx) {
 }
 
 void Memory::OnUnhandledKey(Context* ctx, const KeyEvent& key) {
+  LoadDictionaries();
   if (!user_dict_ || user_dict_->readonly())
     return;
   if ((key.modifier() & ~kShiftMask) == 0) {
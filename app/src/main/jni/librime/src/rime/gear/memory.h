@@ -7,7 +7,9 @@
 #ifndef RIME_MEMORY_H_
 #define RIME_MEMORY_H_
 
+#include <mutex>
 #include <rime/common.h>
+#include <rime/preloader.h>
 #include <rime/dict/vocabulary.h>
 
 namespace rime {
@@ -38,6 +40,15 @@ class Memory {
   Memory(const Ticket& ticket);
   virtual ~Memory();
 
+  // starts loading the dictionaries of a memory to be created from the ticket.
+  static void Preload(const Ticket& ticket,
+                      Preloader* preloader,
+                      Preloader::Handles* handles);
+
+  // loads the dictionaries on first use, which is the first query rather than
+  // schema selection; waits for the preloader if it is at them.
+  void LoadDictionaries();
+
   virtual bool Memorize(const CommitEntry& commit_entry) = 0;
   virtual bool ProcessSegmentOnCommit(CommitEntry& commit_entry,
                                       const Segment& seg);
@@ -63,6 +74,7 @@ class Memory {
   connection commit_connection_;
   connection delete_connection_;
   connection unhandled_key_connection_;
+  std::once_flag dictionaries_loaded_;
 };
 
 }  // namespace rime
@@ -10,6 +10,8 @@
 #include <functional>
 #include <rime/candidate.h>
 #include <rime/config.h>
+#include <rime/preloader.h>
+#include <rime/tracer.h>
 #include <rime/dict/vocabulary.h>
 #include <rime/gear/grammar.h>
 #include <rime/gear/poet.h>
@@ -84,6 +86,20 @@ Poet::Poet(const Language* language, Config* config, Compare compare)
 
 Poet::~Poet() {}
 
+void Poet::Preload(Config* config, Preloader* preloader) {
+  auto* grammar = Grammar::Require("grammar");
+  if (!grammar || !config || !config->GetMap("grammar"))
+    return;
+  // the loader thread reads its own copy of the settings.
+  auto settings = New<Config>();
+  settings->SetItem("grammar", config->GetItem("grammar"));
+  preloader->Post([grammar, settings] {
+    the<Grammar> loaded(grammar->Create(settings.get()));
+    if (loaded)
+      loaded->Load();
+  });
+}
+
 bool Poet::CompareWeight(const Line& one, const Line& other) {
   return one.weight < other.weight;
 }
@@ -245,6 +261,9 @@ an<Sentence> Poet::MakeSentenceWithStrategy(const WordGraph& graph,
 an<Sentence> Poet::MakeSentence(const WordGraph& graph,
                                 size_t total_length,
                                 const string& preceding_text) {
+  // mostly the scoring of the grammar, such as octagram.
+  static const string kMakeSentence("make_sentence");
+  TraceScope scope("poet", Tracer::enabled() ? &kMakeSentence : nullptr);
   return grammar_ ? MakeSentenceWithStrategy<BeamSearch>(graph, total_length,
                                                          preceding_text)
                   : MakeSentenceWithStrategy<DynamicProgramming>(
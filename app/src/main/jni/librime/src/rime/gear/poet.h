@@ -21,6 +21,7 @@ using WordGraph = map<int, map<int, DictEntryList>>;
 
 class Grammar;
 class Language;
+class Preloader;
 struct Line;
 
 class Poet {
@@ -36,6 +37,9 @@ class Poet {
        Compare compare = CompareWeight);
   ~Poet();
 
+  // starts loading the grammar, which is kept for poets created later.
+  static void Preload(Config* config, Preloader* preloader);
+
   an<Sentence> MakeSentence(const WordGraph& graph,
                             size_t total_length,
                             const string& preceding_text);
@@ -34,6 +34,42 @@ static void load_patterns(RecognizerPatterns* patterns, an<ConfigMap> map) {
 
 void RecognizerPatterns::LoadConfig(Config* config, const string& name_space) {
   load_patterns(this, config->GetMap(name_space + "/patterns"));
+  Compile();
+}
+
+// back-references and recursions refer to groups by number, which changes
+// once the pattern is part of another; comments in free-spacing mode and
+// quoted sequences may run past the end of the pattern.
+static bool combinable(const string& pattern) {
+  static const boost::regex kNotCombinable(
+      R"(\\[1-9gkKQ]|\(\?([0-9+&R-]|P[=>]|[a-zA-Z-]*x))");
+  return !boost::regex_search(pattern, kNotCombinable);
+}
+
+void RecognizerPatterns::Compile() {
+  combined_ = boost::regex();
+  compiled_size_ = 0;
+  standalone_.clear();
+  string combined;
+  for (const auto& v : *this) {
+    const string& pattern = v.second.str();
+    if (!combinable(pattern)) {
+      standalone_.insert(v.first);
+      continue;
+    }
+    if (!combined.empty())
+      combined += '|';
+    combined += "(?:" + pattern + ")";
+  }
+  if (combined.empty())
+    return;
+  try {
+    combined_.assign(combined);
+    compiled_size_ = size();
+  } catch (boost::regex_error& e) {
+    LOG(ERROR) << "error combining recognizer patterns: " << e.what();
+    combined_ = boost::regex();
+  }
 }
 
 RecognizerMatch RecognizerPatterns::GetMatch(
@@ -43,13 +79,13 @@ RecognizerMatch RecognizerPatterns::GetMatch(
   size_t k = segmentation.GetConfirmedPosition();
   string active_input = input.substr(k);
   DLOG(INFO) << "matching active input '" << active_input << "' at pos " << k;
-  for (const auto& v : *this) {
+  auto match = [&](const value_type& v) -> RecognizerMatch {
     boost::smatch m;
     if (boost::regex_search(active_input, m, v.second)) {
       size_t start = k + m.position();
       size_t end = start + m.length();
       if (end != input.length())
-        continue;
+        return {};
       if (start == j) {
         DLOG(INFO) << "input [" << start << ", " << end << ") '" << m.str()
                    << "' matches pattern: " << v.first;
@@ -65,6 +101,30 @@ RecognizerMatch RecognizerPatterns::GetMatch(
         }
       }
     }
+    return {};
+  };
+  // while no pattern matches at all, which is what usually happens, only the
+  // patterns left out of the combined regex need a search of their own.
+  if (compiled_size_ == size() && compiled_size_ > 0 &&
+      !boost::regex_search(active_input, combined_, boost::match_any)) {
+    for (const auto& name : standalone_) {
+      auto found = find(name);
+      if (found == end())
+        continue;
+      auto result = match(*found);
+      if (result.found())
+        return result;
+    }
+    return RecognizerMatch();
+  }
+  // once anything matches, each pattern is searched on its own: what counts
+  // is the leftmost match of every pattern in turn, while the combined regex
+  // only tells the leftmost of all, which may come from a pattern whose match
+  // is rejected, with an earlier one matching further right.
+  for (const auto& v : *this) {
+    auto result = match(v);
+    if (result.found())
+      return result;
   }
   return RecognizerMatch();
 }
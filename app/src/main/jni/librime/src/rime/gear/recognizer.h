@@ -30,8 +30,20 @@ struct RecognizerMatch {
 class RecognizerPatterns : public map<string, boost::regex> {
  public:
   void LoadConfig(Config* config, const string& name_space);
+  // combines the patterns into one regex, which tells in a single search
+  // whether any of them matches, so that input matching none is rejected
+  // early; called by LoadConfig().
+  void Compile();
   RecognizerMatch GetMatch(const string& input,
                            const Segmentation& segmentation) const;
+
+ private:
+  boost::regex combined_;
+  // number of patterns when compiled; the combined regex is not used once
+  // patterns are added or removed.
+  size_t compiled_size_ = 0;
+  // patterns that cannot be combined, such as those with back-references.
+  set<string> standalone_;
 };
 
 class Recognizer : public Processor {
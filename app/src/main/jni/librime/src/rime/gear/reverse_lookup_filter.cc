@@ -40,6 +40,21 @@ ReverseLookupFilter::ReverseLookupFilter(const Ticket& ticket)
   }
 }
 
+void ReverseLookupFilter::Preload(const Ticket& ticket,
+                                  Preloader* preloader,
+                                  Preloader::Handles* handles) {
+  if (!ticket.engine)
+    return;
+  string name_space =
+      ticket.name_space == "filter" ? "reverse_lookup" : ticket.name_space;
+  if (auto c = ReverseLookupDictionary::Require("reverse_lookup_dictionary")) {
+    an<ReverseLookupDictionary> rev_dict(
+        c->Create(Ticket(ticket.engine, name_space)));
+    if (rev_dict)
+      handles->push_back(preloader->Load(rev_dict));
+  }
+}
+
 void ReverseLookupFilter::Initialize() {
   initialized_ = true;
   if (!engine_)
@@ -76,14 +91,11 @@ void ReverseLookupFilter::Process(const an<Candidate>& cand) {
   if (!phrase)
     return;
   string codes;
-  if (rev_dict_->ReverseLookup(phrase->text(), &codes)) {
-    comment_formatter_.Apply(&codes);
-    if (!codes.empty()) {
-      if (overwrite_comment_ || cand->comment().empty()) {
-        phrase->set_comment(codes);
-      } else {
-        phrase->set_comment(cand->comment() + " " + codes);
-      }
+  if (rev_dict_->ReverseLookup(phrase->text(), &comment_formatter_, &codes)) {
+    if (overwrite_comment_ || cand->comment().empty()) {
+      phrase->set_comment(codes);
+    } else {
+      phrase->set_comment(cand->comment() + " " + codes);
     }
   }
 }
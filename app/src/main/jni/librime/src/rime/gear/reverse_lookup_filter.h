@@ -9,6 +9,7 @@
 
 #include <rime/common.h>
 #include <rime/filter.h>
+#include <rime/preloader.h>
 #include <rime/algo/algebra.h>
 #include <rime/gear/filter_commons.h>
 
@@ -20,6 +21,10 @@ class ReverseLookupFilter : public Filter, TagMatching {
  public:
   explicit ReverseLookupFilter(const Ticket& ticket);
 
+  static void Preload(const Ticket& ticket,
+                      Preloader* preloader,
+                      Preloader::Handles* handles);
+
   virtual an<Translation> Apply(an<Translation> translation,
                                 CandidateList* candidates);
 
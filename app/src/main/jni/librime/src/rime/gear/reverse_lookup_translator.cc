@@ -59,10 +59,9 @@ an<Candidate> ReverseLookupTranslation::Peek() {
   const auto& entry(iter_.Peek());
   string tips;
   if (dict_) {
-    dict_->ReverseLookup(entry->text, &tips);
-    if (options_) {
-      options_->comment_formatter().Apply(&tips);
-    }
+    dict_->ReverseLookup(
+        entry->text, options_ ? &options_->comment_formatter() : nullptr,
+        &tips);
     // if (!tips.empty()) {
     //   boost::algorithm::replace_all(tips, " ", separator);
     // }
@@ -100,6 +99,31 @@ ReverseLookupTranslator::ReverseLookupTranslator(const Ticket& ticket)
   config->GetString(name_space_ + "/tag", &tag_);
 }
 
+// loaded lazily at the first query, unless preloaded by then.
+void ReverseLookupTranslator::Preload(const Ticket& ticket,
+                                      Preloader* preloader,
+                                      Preloader::Handles* handles) {
+  if (!ticket.engine || !ticket.schema)
+    return;
+  string name_space = ticket.name_space == "translator" ? "reverse_lookup"
+                                                        : ticket.name_space;
+  if (auto component = Dictionary::Require("dictionary")) {
+    an<Dictionary> dict(component->Create(Ticket(ticket.engine, name_space)));
+    if (!dict)
+      return;
+    handles->push_back(preloader->Load(dict));
+  }
+  if (auto rev_component =
+          ReverseLookupDictionary::Require("reverse_lookup_dictionary")) {
+    string rev_target("translator");
+    ticket.schema->config()->GetString(name_space + "/target", &rev_target);
+    an<ReverseLookupDictionary> rev_dict(
+        rev_component->Create(Ticket(ticket.engine, rev_target)));
+    if (rev_dict)
+      handles->push_back(preloader->Load(rev_dict));
+  }
+}
+
 void ReverseLookupTranslator::Initialize() {
   initialized_ = true;  // no retry
   if (!engine_)
@@ -8,6 +8,7 @@
 #define RIME_REVERSE_LOOKUP_TRANSLATOR_H_
 
 #include <rime/common.h>
+#include <rime/preloader.h>
 #include <rime/translator.h>
 #include <rime/algo/algebra.h>
 
@@ -21,6 +22,10 @@ class ReverseLookupTranslator : public Translator {
  public:
   ReverseLookupTranslator(const Ticket& ticket);
 
+  static void Preload(const Ticket& ticket,
+                      Preloader* preloader,
+                      Preloader::Handles* handles);
+
   virtual an<Translation> Query(const string& input, const Segment& segment);
 
  protected:
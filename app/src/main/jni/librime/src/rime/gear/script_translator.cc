@@ -135,7 +135,7 @@ class ScriptTranslation : public Translation {
   bool PrepareCandidate();
   template <class QueryResult>
   void EnrollEntries(map<int, DictEntryList>& entries_by_end_pos,
-                     const an<QueryResult>& query_result);
+                     QueryResult& query_result);
   an<Sentence> MakeSentence(Dictionary* dict, UserDictionary* user_dict);
 
   ScriptTranslator* translator_;
@@ -169,6 +169,16 @@ class ScriptTranslation : public Translation {
 
 // ScriptTranslator implementation
 
+void ScriptTranslator::Preload(const Ticket& ticket,
+                               Preloader* preloader,
+                               Preloader::Handles* handles) {
+  if (!ticket.schema)
+    return;
+  // the loader takes on the grammar first, as the translator needs it last.
+  Poet::Preload(ticket.schema->config(), preloader);
+  Memory::Preload(ticket, preloader, handles);
+}
+
 ScriptTranslator::ScriptTranslator(const Ticket& ticket)
     : Translator(ticket), Memory(ticket), TranslatorOptions(ticket) {
   if (!engine_)
@@ -196,9 +206,10 @@ ScriptTranslator::ScriptTranslator(const Ticket& ticket)
 
 an<Translation> ScriptTranslator::Query(const string& input,
                                         const Segment& segment) {
-  if (!dict_ || !dict_->loaded())
+  if (!segment.HasAnyTagIn(tag_set_))
     return nullptr;
-  if (!segment.HasAnyTagIn(tags_))
+  LoadDictionaries();
+  if (!dict_ || !dict_->loaded())
     return nullptr;
   DLOG(INFO) << "input = '" << input << "', [" << segment.start << ", "
              << segment.end << ")";
@@ -656,16 +667,14 @@ bool ScriptTranslation::CheckEmpty() {
 template <class QueryResult>
 void ScriptTranslation::EnrollEntries(
     map<int, DictEntryList>& entries_by_end_pos,
-    const an<QueryResult>& query_result) {
-  if (query_result) {
-    for (auto& y : *query_result) {
-      DictEntryList& homophones = entries_by_end_pos[y.first];
-      while (homophones.size() < translator_->max_homophones() &&
-             !y.second.exhausted()) {
-        homophones.push_back(y.second.Peek());
-        if (!y.second.Next())
-          break;
-      }
+    QueryResult& query_result) {
+  for (auto& y : query_result) {
+    DictEntryList& homophones = entries_by_end_pos[y.first];
+    while (homophones.size() < translator_->max_homophones() &&
+           !y.second.exhausted()) {
+      homophones.push_back(y.second.Peek());
+      if (!y.second.Next())
+        break;
     }
   }
 }
@@ -675,16 +684,26 @@ an<Sentence> ScriptTranslation::MakeSentence(Dictionary* dict,
   const int kMaxSyllablesForUserPhraseQuery = 5;
   const auto& syllable_graph = syllabifier_->syllable_graph();
   WordGraph graph;
+  // look up all start positions at once rather than one by one.
+  auto user_phrases =
+      user_dict ? user_dict->LookupLattice(syllable_graph,
+                                           kMaxSyllablesForUserPhraseQuery)
+                : nullptr;
+  auto phrases =
+      dict->LookupLattice(syllable_graph, &translator_->blacklist());
   for (const auto& x : syllable_graph.edges) {
     auto& same_start_pos = graph[x.first];
-    if (user_dict) {
-      EnrollEntries(same_start_pos,
-                    user_dict->Lookup(syllable_graph, x.first,
-                                      kMaxSyllablesForUserPhraseQuery));
+    if (user_phrases) {
+      auto found = user_phrases->find(x.first);
+      if (found != user_phrases->end())
+        EnrollEntries(same_start_pos, found->second);
     }
     // merge lookup results
-    EnrollEntries(same_start_pos, dict->Lookup(syllable_graph, x.first,
-                                               &translator_->blacklist()));
+    if (phrases) {
+      auto found = phrases->find(x.first);
+      if (found != phrases->end())
+        EnrollEntries(same_start_pos, found->second);
+    }
   }
   if (auto sentence =
           poet_->MakeSentence(graph, syllable_graph.interpreted_length,
@@ -30,6 +30,10 @@ class ScriptTranslator : public Translator,
  public:
   ScriptTranslator(const Ticket& ticket);
 
+  static void Preload(const Ticket& ticket,
+                      Preloader* preloader,
+                      Preloader::Handles* handles);
+
   virtual an<Translation> Query(const string& input,
                                 const Segment& segment) override;
   virtual bool Memorize(const CommitEntry& commit_entry) override;
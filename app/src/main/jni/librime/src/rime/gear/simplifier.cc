@@ -7,6 +7,7 @@
 #include <boost/algorithm/string.hpp>
 #include <stdint.h>
 #include <utf8.h>
+#include <mutex>
 #include <utility>
 #include <rime/candidate.h>
 #include <rime/common.h>
@@ -15,7 +16,9 @@
 #include <rime/engine.h>
 #include <rime/schema.h>
 #include <rime/service.h>
+#include <rime/tracer.h>
 #include <rime/translation.h>
+#include <rime/algo/lru_cache.h>
 #include <rime/gear/simplifier.h>
 #include <opencc/Config.hpp>  // Place OpenCC #includes here to avoid VS2015 compilation errors
 #include <opencc/Converter.hpp>
@@ -32,39 +35,68 @@ namespace rime {
 class Opencc {
  public:
   Opencc(const path& config_path)
-      : initialized_(false), config_path_(config_path) {}
+      : config_path_(config_path), cache_(kMaxCachedConversions) {}
 
+  // sessions on different threads may share the converter.
   void Initialize() {
-    if (initialized_)
-      return;
-    initialized_ = true;
+    std::call_once(initialized_, [this] { Load(); });
+  }
+
+  void Load() {
     opencc::Config config;
     try {
       // opencc accepts file path encoded in UTF-8.
       converter_ = config.NewFromFile(config_path_.u8string());
 
-      const list<opencc::ConversionPtr> conversions =
-          converter_->GetConversionChain()->GetConversions();
-      dict_ = conversions.front()->GetDict();
+      for (const auto& conversion :
+           converter_->GetConversionChain()->GetConversions()) {
+        opencc::DictPtr dict = conversion->GetDict();
+        if (dict == nullptr) {
+          dicts_.clear();
+          break;
+        }
+        dicts_.push_back(dict);
+      }
     } catch (...) {
       LOG(ERROR) << "opencc config not found: " << config_path_;
     }
   }
 
+  // Converts a candidate text to its word forms, or failing that, to the
+  // converted text. Results are memoized as the same candidates come up
+  // again and again while the user is typing.
+  bool Convert(const string& text, vector<string>* forms) {
+    {
+      std::lock_guard<std::mutex> lock(cache_mutex_);
+      const vector<string>* cached = cache_.Find(text);
+      TraceCacheLookup("simplifier", cached);
+      if (cached) {
+        *forms = *cached;
+        return !forms->empty();
+      }
+    }
+    vector<string> converted_forms;
+    string converted_text;
+    if (!ConvertWord(text, &converted_forms) &&
+        ConvertText(text, &converted_text)) {
+      converted_forms.push_back(converted_text);
+    }
+    {
+      std::lock_guard<std::mutex> lock(cache_mutex_);
+      cache_.Insert(text, converted_forms);
+    }
+    *forms = std::move(converted_forms);
+    return !forms->empty();
+  }
+
   bool ConvertWord(const string& text, vector<string>* forms) {
     Initialize();
-    if (converter_ == nullptr) {
+    if (converter_ == nullptr || dicts_.empty()) {
       return false;
     }
-    const list<opencc::ConversionPtr> conversions =
-        converter_->GetConversionChain()->GetConversions();
     vector<string> original_words{text};
     bool matched = false;
-    for (auto conversion : conversions) {
-      opencc::DictPtr dict = conversion->GetDict();
-      if (dict == nullptr) {
-        return false;
-      }
+    for (const auto& dict : dicts_) {
       set<string> word_set;
       vector<string> converted_words;
       for (const auto& original_word : original_words) {
@@ -118,16 +150,10 @@ class Opencc {
 
   bool RandomConvertText(const string& text, string* simplified) {
     Initialize();
-    if (dict_ == nullptr)
+    if (dicts_.empty())
       return false;
-    const list<opencc::ConversionPtr> conversions =
-        converter_->GetConversionChain()->GetConversions();
     const char* phrase = text.c_str();
-    for (auto conversion : conversions) {
-      opencc::DictPtr dict = conversion->GetDict();
-      if (dict == nullptr) {
-        return false;
-      }
+    for (const auto& dict : dicts_) {
       std::ostringstream buffer;
       for (const char* pstr = phrase; *pstr != '\0';) {
         opencc::Optional<const opencc::DictEntry*> matched =
@@ -158,10 +184,14 @@ class Opencc {
   }
 
  private:
-  bool initialized_;
+  std::once_flag initialized_;
   path config_path_;
   opencc::ConverterPtr converter_;
-  opencc::DictPtr dict_;
+  vector<opencc::DictPtr> dicts_;
+  // shared by all simplifiers using the same opencc config.
+  static constexpr size_t kMaxCachedConversions = 4096;
+  LruCache<string, vector<string>> cache_;
+  std::mutex cache_mutex_;
 };
 
 // Simplifier
@@ -275,7 +305,7 @@ bool Simplifier::Convert(const an<Candidate>& original,
     }
   } else {  //! random_
     vector<string> forms;
-    success = opencc_->ConvertWord(original->text(), &forms);
+    success = opencc_->Convert(original->text(), &forms);
     if (success) {
       for (size_t i = 0; i < forms.size(); ++i) {
         if (forms[i] == original->text()) {
@@ -284,12 +314,6 @@ bool Simplifier::Convert(const an<Candidate>& original,
           PushBack(original, result, forms[i]);
         }
       }
-    } else {
-      string simplified;
-      success = opencc_->ConvertText(original->text(), &simplified);
-      if (success) {
-        PushBack(original, result, simplified);
-      }
     }
   }
   return success;
@@ -310,6 +334,7 @@ Simplifier* SimplifierComponent::Create(const Ticket& ticket) {
   if (opencc_config.empty()) {
     opencc_config = "t2s.json";  // default opencc config file
   }
+  std::lock_guard<std::mutex> lock(mutex_);
   opencc = opencc_map_[opencc_config].lock();
   if (opencc) {
     return new Simplifier(ticket, opencc);
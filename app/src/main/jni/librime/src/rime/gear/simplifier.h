@@ -7,6 +7,7 @@
 #ifndef RIME_SIMPLIFIER_H_
 #define RIME_SIMPLIFIER_H_
 
+#include <mutex>
 #include <rime/filter.h>
 #include <rime/algo/algebra.h>
 #include <rime/gear/filter_commons.h>
@@ -51,6 +52,7 @@ class SimplifierComponent : public Simplifier::Component {
 
  private:
   hash_map<string, weak<Opencc>> opencc_map_;
+  std::mutex mutex_;
 };
 
 }  // namespace rime
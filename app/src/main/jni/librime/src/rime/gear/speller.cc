@@ -21,6 +21,8 @@ static const char kRimeAlphabet[] = "zyxwvutsrqponmlkjihgfedcba";
 
 namespace rime {
 
+static const Atom kAutoCommit = AtomTable::options().Intern("_auto_commit");
+
 static inline bool belongs_to(char ch, const string& charset) {
   return charset.find(ch) != string::npos;
 }
@@ -205,7 +207,7 @@ bool Speller::AutoSelectPreviousMatch(Context* ctx, Segment* previous_segment) {
     ctx->composition().pop_back();
     ctx->composition().push_back(std::move(*previous_segment));
     ctx->ConfirmCurrentSelection();
-    if (ctx->get_option("_auto_commit")) {
+    if (ctx->get_option(kAutoCommit)) {
       ctx->set_input(converted);
       ctx->Commit();
       string rest = input.substr(end);
@@ -240,7 +242,7 @@ bool Speller::FindEarlierMatch(Context* ctx, size_t start, size_t end) {
     if (is_auto_selectable(segment.GetSelectedCandidate(), converted,
                            delimiters_)) {
       // select previous match
-      if (ctx->get_option("_auto_commit")) {
+      if (ctx->get_option(kAutoCommit)) {
         ctx->Commit();
         string rest = input.substr(end);
         ctx->set_input(rest);
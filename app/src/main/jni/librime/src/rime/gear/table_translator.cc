@@ -208,6 +208,16 @@ bool LazyTableTranslation::FetchMoreTableEntries() {
 
 // TableTranslator
 
+void TableTranslator::Preload(const Ticket& ticket,
+                              Preloader* preloader,
+                              Preloader::Handles* handles) {
+  if (!ticket.schema)
+    return;
+  // the loader takes on the grammar first, as the translator needs it last.
+  Poet::Preload(ticket.schema->config(), preloader);
+  Memory::Preload(ticket, preloader, handles);
+}
+
 TableTranslator::TableTranslator(const Ticket& ticket)
     : Translator(ticket), Memory(ticket), TranslatorOptions(ticket) {
   if (!engine_)
@@ -243,8 +253,9 @@ static bool starts_with_completion(an<Translation> translation) {
 
 an<Translation> TableTranslator::Query(const string& input,
                                        const Segment& segment) {
-  if (!segment.HasAnyTagIn(tags_))
+  if (!segment.HasAnyTagIn(tag_set_))
     return nullptr;
+  LoadDictionaries();
   DLOG(INFO) << "input = '" << input << "', [" << segment.start << ", "
              << segment.end << ")";
 
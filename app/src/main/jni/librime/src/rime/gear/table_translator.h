@@ -28,6 +28,10 @@ class TableTranslator : public Translator,
  public:
   TableTranslator(const Ticket& ticket);
 
+  static void Preload(const Ticket& ticket,
+                      Preloader* preloader,
+                      Preloader::Handles* handles);
+
   virtual an<Translation> Query(const string& input, const Segment& segment);
   virtual bool Memorize(const CommitEntry& commit_entry);
 
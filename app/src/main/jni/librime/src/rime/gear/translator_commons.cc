@@ -145,6 +145,7 @@ TranslatorOptions::TranslatorOptions(const Ticket& ticket) {
           tags_.push_back(value->str());
     if (tags_.empty())
       tags_.push_back("abc");
+    UpdateTagSet();
 
     // blacklist
     if (auto blacklist =
@@ -11,6 +11,7 @@
 #include <rime/common.h>
 #include <rime/config.h>
 #include <rime/candidate.h>
+#include <rime/segmentation.h>
 #include <rime/translation.h>
 #include <rime/algo/algebra.h>
 #include <rime/algo/syllabifier.h>
@@ -152,9 +153,13 @@ class TranslatorOptions {
     if (tags_.size() == 0) {
       tags_.push_back("abc");
     }
+    UpdateTagSet();
   }
   const string& tag() const { return tags_[0]; }
-  void set_tag(const string& tag) { tags_[0] = tag; }
+  void set_tag(const string& tag) {
+    tags_[0] = tag;
+    UpdateTagSet();
+  }
   bool contextual_suggestions() const { return contextual_suggestions_; }
   void set_contextual_suggestions(bool enabled) {
     contextual_suggestions_ = enabled;
@@ -170,8 +175,12 @@ class TranslatorOptions {
   const hash_set<string>& blacklist() { return blacklist_; }
 
  protected:
+  void UpdateTagSet() { tag_set_ = TagSet(tags_.begin(), tags_.end()); }
+
   string delimiters_;
   vector<string> tags_{"abc"};  // invariant: non-empty
+  // the same tags, matched against segments with a bitwise and.
+  TagSet tag_set_{"abc"};
   bool contextual_suggestions_ = false;
   bool enable_completion_ = true;
   bool strict_spelling_ = false;
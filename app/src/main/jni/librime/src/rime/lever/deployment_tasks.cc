@@ -188,22 +188,19 @@ bool WorkspaceUpdate::Run(Deployer* deployer) {
   }
 
   LOG(INFO) << "updating schemas.";
-  int success = 0;
   int failure = 0;
-  map<string, path> schemas;
+  // schemas are built on the worker pool; the index of the job building
+  // each schema, or -1 if there is no input for it.
+  map<string, int> schemas;
+  vector<DeploymentJob> jobs;
   the<ResourceResolver> resolver(Service::instance().CreateResourceResolver(
       {"schema_source_file", "", ".schema.yaml"}));
   auto build_schema = [&](const string& schema_id, bool as_dependency = false) {
-    if (schemas.find(schema_id) != schemas.end())  // already built
-      return;
+    auto found = schemas.find(schema_id);
+    if (found != schemas.end())  // already scheduled
+      return found->second;
     LOG(INFO) << "schema: " << schema_id;
-    path schema_path;
-    if (schemas.find(schema_id) == schemas.end()) {
-      schema_path = resolver->ResolvePath(schema_id);
-      schemas[schema_id] = schema_path;
-    } else {
-      schema_path = schemas[schema_id];
-    }
+    path schema_path = resolver->ResolvePath(schema_id);
     if (schema_path.empty() || !fs::exists(schema_path)) {
       if (as_dependency) {
         LOG(WARNING) << "missing input schema; skipped unsatisfied dependency: "
@@ -212,13 +209,10 @@ bool WorkspaceUpdate::Run(Deployer* deployer) {
         LOG(ERROR) << "missing input schema: " << schema_id;
         ++failure;
       }
-      return;
+      return schemas[schema_id] = -1;
     }
-    the<DeploymentTask> t(new SchemaUpdate(schema_path));
-    if (t->Run(deployer))
-      ++success;
-    else
-      ++failure;
+    jobs.push_back({New<SchemaUpdate>(schema_path), {}});
+    return schemas[schema_id] = int(jobs.size() - 1);
   };
   auto schema_component = Config::Require("schema");
   for (auto it = schema_list->begin(); it != schema_list->end(); ++it) {
@@ -229,7 +223,7 @@ bool WorkspaceUpdate::Run(Deployer* deployer) {
     if (!schema_property)
       continue;
     const string& schema_id = schema_property->str();
-    build_schema(schema_id);
+    int job = build_schema(schema_id);
     the<Config> schema_config(schema_component->Create(schema_id));
     if (!schema_config)
       continue;
@@ -240,12 +234,17 @@ bool WorkspaceUpdate::Run(Deployer* deployer) {
           continue;
         const string& dependency_id = dependency->str();
         bool as_dependency = true;
-        build_schema(dependency_id, as_dependency);
+        int dependency_job = build_schema(dependency_id, as_dependency);
+        // a dependency scheduled earlier is built before the schema.
+        if (job >= 0 && dependency_job >= 0 && dependency_job < job)
+          jobs[job].dependencies.push_back(dependency_job);
       }
     }
   }
-  LOG(INFO) << "finished updating schemas: " << success << " success, "
-            << failure << " failure.";
+  if (!deployer->RunJobs(jobs))
+    ++failure;
+  LOG(INFO) << "finished updating " << jobs.size() << " schemas"
+            << (failure ? " with failures." : ".");
 
   the<Config> user_config(Config::Require("user_config")->Create("user"));
   // TODO: store as 64-bit number to avoid the year 2038 problem
@@ -359,6 +358,8 @@ bool SchemaUpdate::Run(Deployer* deployer) {
     return false;
   }
 
+  // schemas sharing the dictionary are built one after another.
+  auto output_lock = deployer->LockOutput("dictionary/" + dict_name);
   LOG(INFO) << "preparing dictionary '" << dict_name << "'.";
   const path& user_data_path(deployer->user_data_dir);
   if (!MaybeCreateDirectory(deployer->staging_dir)) {
@@ -456,17 +457,15 @@ bool PrebuildAllSchemas::Run(Deployer* deployer) {
   const path user_data_path(deployer->user_data_dir);
   if (!fs::exists(shared_data_path) || !fs::is_directory(shared_data_path))
     return false;
-  bool success = true;
+  vector<DeploymentJob> jobs;
   for (fs::directory_iterator iter(shared_data_path), end; iter != end;
        ++iter) {
     path entry(iter->path());
     if (boost::ends_with(entry.filename().u8string(), ".schema.yaml")) {
-      the<DeploymentTask> t(new SchemaUpdate(entry));
-      if (!t->Run(deployer))
-        success = false;
+      jobs.push_back({New<SchemaUpdate>(entry), {}});
     }
   }
-  return success;
+  return deployer->RunJobs(jobs);
 }
 
 bool SymlinkingPrebuiltDictionaries::Run(Deployer* deployer) {
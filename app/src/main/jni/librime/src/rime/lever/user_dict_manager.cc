@@ -4,6 +4,8 @@
 //
 // 2012-03-23 GONG Chen <chen.sst@gmail.com>
 //
+#include <algorithm>
+#include <cstdlib>
 #include <fstream>
 #include <boost/algorithm/string.hpp>
 #include <filesystem>
@@ -175,6 +177,180 @@ bool UserDictManager::UpgradeUserDict(const string& dict_name) {
          legacy_db->Remove() && Restore(snapshot_path);
 }
 
+// a delta holds the records changed since "/delta_from" of the change log
+// "/change_log_id", up to "/last_change"; a snapshot, all records as of its
+// "/last_change". each device also records how far it has merged those of
+// every peer, as "/synced/<user_id>" in the same header.
+static const string kDeltaExtension = ".userdb.delta.txt";
+
+// beyond which a full snapshot is cheaper for peers to merge.
+static const size_t kMaxDeltaEntries = 10000;
+
+static uint64_t to_sequence(const map<string, string>& metadata,
+                            const string& key) {
+  auto found = metadata.find(key);
+  return found != metadata.end()
+             ? std::strtoull(found->second.c_str(), nullptr, 10)
+             : 0;
+}
+
+static string sync_point(const string& log_id, uint64_t sequence) {
+  return log_id + ":" + std::to_string(sequence);
+}
+
+// false if the sync point is of another change log.
+static bool parse_sync_point(const string& value,
+                             const string& log_id,
+                             uint64_t* sequence) {
+  if (log_id.empty() || value.length() <= log_id.length() ||
+      value.compare(0, log_id.length(), log_id) != 0 ||
+      value[log_id.length()] != ':')
+    return false;
+  *sequence = std::strtoull(value.c_str() + log_id.length() + 1, nullptr, 10);
+  return true;
+}
+
+bool UserDictManager::SynchronizeChanges(const string& dict_name) {
+  the<Db> db(user_db_component_->Create(dict_name));
+  auto* change_log = dynamic_cast<ChangeLog*>(db.get());
+  if (!change_log || !db->Open())
+    return false;
+  BOOST_SCOPE_EXIT((&db)) {
+    db->Close();
+  }
+  BOOST_SCOPE_EXIT_END
+  UserDbHelper helper(db);
+  if (!helper.IsUserDb())
+    return false;
+  const string& user_id = deployer_->user_id;
+  if (helper.GetUserId() != user_id)
+    helper.UpdateUserInfo();
+  // changes are logged from the first sync on; earlier ones are in the
+  // snapshot it writes.
+  if (!change_log->StartLog())
+    return false;
+  const string log_id = change_log->log_id();
+  const uint64_t last_change = change_log->last_change();
+  // the oldest changes are dropped here rather than as they are logged;
+  // peers behind them take the snapshot.
+  if (last_change - change_log->log_start() > ChangeLog::kMaxLoggedChanges)
+    change_log->TrimChanges(last_change - ChangeLog::kMaxLoggedChanges);
+  const uint64_t log_start = change_log->log_start();
+  const string snapshot_file = dict_name + UserDb::snapshot_extension();
+  const string delta_file = dict_name + kDeltaExtension;
+  bool success = true;
+  // the least of what peers have merged of ours, by those that have.
+  uint64_t merged_by_peers = last_change;
+  for (fs::directory_iterator it(path(deployer_->sync_dir)), end; it != end;
+       ++it) {
+    string peer_id = it->path().filename().u8string();
+    if (!fs::is_directory(it->path()) || peer_id == user_id)
+      continue;
+    path snapshot_path = it->path() / snapshot_file;
+    path delta_path = it->path() / delta_file;
+    map<string, string> snapshot, delta;
+    bool has_snapshot =
+        UserDbHelper::ReadSnapshotMetadata(snapshot_path, &snapshot);
+    bool has_delta = UserDbHelper::ReadSnapshotMetadata(delta_path, &delta);
+    if (!has_snapshot && !has_delta)
+      continue;
+    const auto& header = has_delta ? delta : snapshot;
+    auto ours = header.find("/synced/" + user_id);
+    uint64_t merged = 0;
+    if (ours != header.end() &&
+        parse_sync_point(ours->second, log_id, &merged) &&
+        merged <= last_change) {
+      merged_by_peers = (std::min)(merged_by_peers, merged);
+    }
+    // merge what is new of theirs.
+    const string their_log = has_delta ? delta["/change_log_id"] : string();
+    const uint64_t delta_from = to_sequence(delta, "/delta_from");
+    const uint64_t their_last = to_sequence(delta, "/last_change");
+    string value;
+    uint64_t synced = 0;
+    bool known = db->MetaFetch("/synced/" + peer_id, &value) &&
+                 parse_sync_point(value, their_log, &synced) &&
+                 synced <= their_last;
+    if (known && synced >= delta_from) {
+      if (synced == their_last)
+        continue;
+      LOG(INFO) << "merging changes from " << peer_id << ": " << delta_path;
+      if (!helper.MergeSnapshot(delta_path)) {
+        success = false;
+        continue;
+      }
+      synced = their_last;
+    } else if (has_snapshot && snapshot["/db_type"] == "userdb") {
+      LOG(INFO) << "merging snapshot from " << peer_id << ": "
+                << snapshot_path;
+      if (!helper.MergeSnapshot(snapshot_path)) {
+        success = false;
+        continue;
+      }
+      // a peer without a change log takes a full merge every time.
+      if (their_log.empty() || snapshot["/change_log_id"] != their_log)
+        continue;
+      synced = to_sequence(snapshot, "/last_change");
+      if (synced < their_last && synced >= delta_from) {
+        if (!helper.MergeSnapshot(delta_path)) {
+          success = false;
+          continue;
+        }
+        synced = their_last;
+      }
+    } else {
+      continue;
+    }
+    db->MetaUpdate("/synced/" + peer_id, sync_point(their_log, synced));
+  }
+
+  // export what is new of ours.
+  path dir(deployer_->user_data_sync_dir());
+  std::error_code ec;
+  if (!fs::exists(dir) && !fs::create_directories(dir, ec)) {
+    LOG(ERROR) << "error creating directory '" << dir << "'.";
+    return false;
+  }
+  map<string, string> header;
+  bool has_snapshot =
+      UserDbHelper::ReadSnapshotMetadata(dir / snapshot_file, &header) &&
+      header["/change_log_id"] == log_id;
+  uint64_t snapshot_last =
+      has_snapshot ? to_sequence(header, "/last_change") : last_change;
+  has_snapshot = has_snapshot && snapshot_last <= last_change;
+  // peers that have not merged ours yet, or that are behind the log, start
+  // from the snapshot.
+  uint64_t delta_from =
+      (std::max)((std::min)(merged_by_peers, snapshot_last), log_start);
+  set<string> changes;
+  change_log->GetChanges(delta_from, &changes);
+  header = {{"/change_log_id", log_id},
+            {"/last_change", std::to_string(last_change)}};
+  // the snapshot is rarely rewritten; it is, once it falls behind the
+  // delta, as when old changes are dropped from the log.
+  if (!has_snapshot || snapshot_last < delta_from ||
+      changes.size() > kMaxDeltaEntries) {
+    if (!helper.UniformBackup(dir / snapshot_file, header, nullptr)) {
+      LOG(ERROR) << "error backing up user dict '" << dict_name << "'.";
+      return false;
+    }
+    if (changes.size() > kMaxDeltaEntries) {
+      delta_from = last_change;
+      changes.clear();
+    }
+  }
+  header["/delta_from"] = std::to_string(delta_from);
+  LOG(INFO) << "exporting " << changes.size() << " changes of user dict '"
+            << dict_name << "' since " << delta_from << ".";
+  if (!helper.UniformBackup(dir / delta_file, header, &changes)) {
+    LOG(ERROR) << "error exporting changes of user dict '" << dict_name
+               << "'.";
+    return false;
+  }
+  change_log->TrimChanges(delta_from);
+  return success;
+}
+
 bool UserDictManager::Synchronize(const string& dict_name) {
   LOG(INFO) << "synchronize user dict '" << dict_name << "'.";
   bool success = true;
@@ -186,6 +362,11 @@ bool UserDictManager::Synchronize(const string& dict_name) {
       return false;
     }
   }
+  {
+    the<Db> db(user_db_component_->Create(dict_name));
+    if (dynamic_cast<ChangeLog*>(db.get()))
+      return SynchronizeChanges(dict_name);
+  }
   // *.userdb.txt
   string snapshot_file = dict_name + UserDb::snapshot_extension();
   for (fs::directory_iterator it(sync_dir), end; it != end; ++it) {
@@ -37,6 +37,10 @@ class RIME_DLL UserDictManager {
   bool SynchronizeAll();
 
  protected:
+  // exchanges changes since the last sync with peers, falling back to full
+  // snapshots; for user dbs that keep a change log.
+  bool SynchronizeChanges(const string& dict_name);
+
   Deployer* deployer_;
   path path_;
   UserDb::Component* user_db_component_;
@@ -8,6 +8,7 @@
 #include <iterator>
 #include <rime/filter.h>
 #include <rime/menu.h>
+#include <rime/tracer.h>
 #include <rime/translation.h>
 
 namespace rime {
@@ -19,8 +20,16 @@ void Menu::AddTranslation(an<Translation> translation) {
   DLOG(INFO) << merged_->size() << " translations added.";
 }
 
-void Menu::AddFilter(Filter* filter) {
-  result_ = filter->Apply(result_, &candidates_);
+void Menu::AddFilter(Filter* filter, const string* trace_label) {
+  if (!trace_label) {
+    result_ = filter->Apply(result_, &candidates_);
+    return;
+  }
+  {
+    TraceScope scope("filter", trace_label);
+    result_ = filter->Apply(result_, &candidates_);
+  }
+  result_ = TraceTranslation(result_, "filter", *trace_label);
 }
 
 size_t Menu::Prepare(size_t requested) {
@@ -29,7 +29,8 @@ class Menu {
   RIME_DLL Menu();
 
   RIME_DLL void AddTranslation(an<Translation> translation);
-  void AddFilter(Filter* filter);
+  // with a trace label, times the filter under that name while tracing.
+  void AddFilter(Filter* filter, const string* trace_label = nullptr);
 
   RIME_DLL size_t Prepare(size_t candidate_count);
   RIME_DLL Page* CreatePage(size_t page_size, size_t page_no);
@@ -0,0 +1,73 @@
+//
+// Copyright RIME Developers
+// Distributed under the BSD License
+//
+#include <rime/preloader.h>
+
+namespace rime {
+
+Preloader::Preloader() {}
+
+Preloader::~Preloader() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+    pending_tasks_.clear();
+  }
+  cv_.notify_all();
+#ifndef RIME_NO_THREADING
+  if (worker_.joinable()) {
+    worker_.join();
+  }
+#endif
+}
+
+void Preloader::Post(Task task) {
+#ifndef RIME_NO_THREADING
+  if (!task)
+    return;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (stopping_)
+      return;
+    pending_tasks_.push_back(std::move(task));
+    // started with the first task, as most processes never select a schema.
+    if (!worker_.joinable()) {
+      worker_ = std::thread([this] { Work(); });
+    }
+  }
+  cv_.notify_all();
+#endif
+}
+
+void Preloader::Flush() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  cv_.wait(lock, [this] { return pending_tasks_.empty() && !running_; });
+}
+
+void Preloader::Cancel() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  pending_tasks_.clear();
+  cv_.wait(lock, [this] { return !running_; });
+}
+
+void Preloader::Work() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    cv_.wait(lock, [this] { return stopping_ || !pending_tasks_.empty(); });
+    if (stopping_)
+      break;
+    Task task = std::move(pending_tasks_.front());
+    pending_tasks_.pop_front();
+    running_ = true;
+    lock.unlock();
+    task();
+    // releases what the task holds before the loader reports idle.
+    task = nullptr;
+    lock.lock();
+    running_ = false;
+    cv_.notify_all();
+  }
+}
+
+}  // namespace rime
@@ -0,0 +1,86 @@
+//
+// Copyright RIME Developers
+// Distributed under the BSD License
+//
+#ifndef RIME_PRELOADER_H_
+#define RIME_PRELOADER_H_
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <rime/common.h>
+#include <rime/component.h>
+
+namespace rime {
+
+struct Ticket;
+
+// loads shared resources, such as dictionaries and user dbs, on a background
+// thread as soon as a schema is selected, ahead of the components that use
+// them.
+//
+// resources load themselves at most once, under a lock of their own; a
+// component that needs a resource before the loader gets to it just loads it
+// on its own thread, or waits for the loader to finish with it.
+class Preloader {
+ public:
+  using Task = function<void()>;
+  // resource objects kept loaded for the components created later.
+  using Handles = vector<an<void>>;
+
+  Preloader();
+  ~Preloader();
+
+  // queues a task to run on the loader thread.
+  void Post(Task task);
+  // queues loading the resource, unless the returned handle is gone by then.
+  template <class T>
+  an<void> Load(an<T> resource) {
+    Post([weak_resource = weak<T>(resource)] {
+      if (auto resource = weak_resource.lock())
+        resource->Load();
+    });
+    return resource;
+  }
+  // blocks until the tasks posted so far have run.
+  void Flush();
+  // drops pending tasks and waits for the running one to return.
+  void Cancel();
+
+ private:
+  void Work();
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  list<Task> pending_tasks_;
+  bool running_ = false;
+  bool stopping_ = false;
+#ifndef RIME_NO_THREADING
+  std::thread worker_;
+#endif
+};
+
+// implemented by the components of engines that use shared resources.
+class Preloadable {
+ public:
+  virtual ~Preloadable() = default;
+  // posts loading the resources that a component created from the ticket
+  // would use, and holds them on to the handles.
+  virtual void Preload(const Ticket& ticket,
+                       Preloader* preloader,
+                       Preloader::Handles* handles) = 0;
+};
+
+template <class T>
+struct PreloadingComponent : public Component<T>, public Preloadable {
+ public:
+  void Preload(const Ticket& ticket,
+               Preloader* preloader,
+               Preloader::Handles* handles) override {
+    T::Preload(ticket, preloader, handles);
+  }
+};
+
+}  // namespace rime
+
+#endif  // RIME_PRELOADER_H_
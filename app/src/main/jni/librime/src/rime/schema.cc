@@ -35,6 +35,12 @@ void Schema::FetchUsefulConfigItems() {
   }
   config_->GetString("menu/alternative_select_keys", &select_keys_);
   config_->GetBool("menu/page_down_cycle", &page_down_cycle_);
+  if (auto labels = config_->GetList("menu/alternative_select_labels")) {
+    for (size_t i = 0; i < labels->size(); ++i) {
+      auto value = labels->GetValueAt(i);
+      select_labels_.push_back(value ? value->str() : string());
+    }
+  }
 }
 
 Config* SchemaComponent::Create(const string& schema_id) {
@@ -29,6 +29,7 @@ class Schema {
   bool page_down_cycle() const { return page_down_cycle_; }
   const string& select_keys() const { return select_keys_; }
   void set_select_keys(const string& keys) { select_keys_ = keys; }
+  const vector<string>& select_labels() const { return select_labels_; }
 
  private:
   void FetchUsefulConfigItems();
@@ -40,6 +41,7 @@ class Schema {
   int page_size_ = 5;
   bool page_down_cycle_ = false;
   string select_keys_;
+  vector<string> select_labels_;
 };
 
 class SchemaComponent : public Config::Component {
@@ -102,10 +102,7 @@ bool Segmentation::AddSegment(Segment segment) {
     last = segment;
   } else {
     // rule three: with segments equal in length, merge their tags
-    set<string> result;
-    set_union(last.tags.begin(), last.tags.end(), segment.tags.begin(),
-              segment.tags.end(), std::inserter(result, result.begin()));
-    last.tags.swap(result);
+    last.tags.insert(segment.tags);
   }
   return true;
 }
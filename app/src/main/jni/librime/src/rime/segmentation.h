@@ -7,7 +7,9 @@
 #ifndef RIME_SEGMENTATION_H_
 #define RIME_SEGMENTATION_H_
 
+#include <iterator>
 #include <rime_api.h>
+#include <rime/atom.h>
 #include <rime/common.h>
 
 namespace rime {
@@ -15,6 +17,81 @@ namespace rime {
 class Candidate;
 class Menu;
 
+// tags of a segment, held as a bitmap of atoms. the string interface of
+// set<string> is kept, but iteration follows the order of atoms.
+class TagSet {
+ public:
+  class const_iterator {
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = string;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const string*;
+    using reference = const string&;
+
+    const_iterator(const AtomSet* atoms, Atom atom)
+        : atoms_(atoms), atom_(atom) {}
+    reference operator*() const { return AtomTable::tags().NameOf(atom_); }
+    pointer operator->() const { return &**this; }
+    const_iterator& operator++() {
+      atom_ = atoms_->Next(atom_ + 1);
+      return *this;
+    }
+    bool operator==(const const_iterator& other) const {
+      return atom_ == other.atom_;
+    }
+    bool operator!=(const const_iterator& other) const {
+      return atom_ != other.atom_;
+    }
+
+   private:
+    const AtomSet* atoms_;
+    Atom atom_;
+  };
+
+  TagSet() = default;
+  TagSet(std::initializer_list<string> tags)
+      : TagSet(tags.begin(), tags.end()) {}
+  template <class Iter>
+  TagSet(Iter first, Iter last) {
+    for (; first != last; ++first) {
+      insert(*first);
+    }
+  }
+
+  bool insert(Atom tag) { return atoms_.Insert(tag); }
+  bool insert(const string& tag) {
+    return insert(AtomTable::tags().Intern(tag));
+  }
+  void insert(const TagSet& other) { atoms_.Merge(other.atoms_); }
+  size_t erase(Atom tag) { return atoms_.Erase(tag); }
+  size_t erase(const string& tag) {
+    Atom atom = AtomTable::tags().Find(tag);
+    return atom != AtomTable::kNone && erase(atom);
+  }
+  size_t count(Atom tag) const { return atoms_.Contains(tag); }
+  size_t count(const string& tag) const {
+    Atom atom = AtomTable::tags().Find(tag);
+    return atom != AtomTable::kNone && count(atom);
+  }
+  bool Intersects(const TagSet& other) const {
+    return atoms_.Intersects(other.atoms_);
+  }
+  void clear() { atoms_.Clear(); }
+  bool empty() const { return atoms_.empty(); }
+  size_t size() const { return atoms_.size(); }
+  void swap(TagSet& other) { std::swap(atoms_, other.atoms_); }
+
+  const_iterator begin() const { return {&atoms_, atoms_.Next(0)}; }
+  const_iterator end() const { return {&atoms_, AtomTable::kNone}; }
+
+  bool operator==(const TagSet& other) const { return atoms_ == other.atoms_; }
+  bool operator!=(const TagSet& other) const { return atoms_ != other.atoms_; }
+
+ private:
+  AtomSet atoms_;
+};
+
 struct Segment {
   enum Status {
     kVoid,
@@ -26,7 +103,7 @@ struct Segment {
   size_t start = 0;
   size_t end = 0;
   size_t length = 0;
-  set<string> tags;
+  TagSet tags;
   an<Menu> menu;
   size_t selected_index = 0;
   string prompt;
@@ -47,11 +124,15 @@ struct Segment {
   void Close();
   bool Reopen(size_t caret_pos);
 
-  bool HasTag(const string& tag) const { return tags.find(tag) != tags.end(); }
+  bool HasTag(const string& tag) const { return tags.count(tag) != 0; }
+  bool HasTag(Atom tag) const { return tags.count(tag) != 0; }
   bool HasAnyTagIn(const vector<string>& tags) const {
     return std::any_of(tags.begin(), tags.end(),
                        [this](const string& tag) { return HasTag(tag); });
   }
+  bool HasAnyTagIn(const TagSet& tags) const {
+    return this->tags.Intersects(tags);
+  }
 
   an<Candidate> GetCandidateAt(size_t index) const;
   an<Candidate> GetSelectedCandidate() const;
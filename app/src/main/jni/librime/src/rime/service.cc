@@ -4,11 +4,15 @@
 //
 // 2011-08-08 GONG Chen <chen.sst@gmail.com>
 //
+#include <condition_variable>
+#include <thread>
 #include <rime/context.h>
 #include <rime/engine.h>
+#include <rime/preloader.h>
 #include <rime/resource.h>
 #include <rime/schema.h>
 #include <rime/service.h>
+#include <rime/algo/ring_buffer.h>
 
 using namespace std::placeholders;
 
@@ -64,7 +68,123 @@ Schema* Session::schema() const {
   return engine_ ? engine_->active_engine()->schema() : NULL;
 }
 
-Service::Service() {
+struct Notification {
+  SessionId session_id = 0;
+  string type;
+  string value;
+};
+
+// drains queued notifications on a thread of its own.
+class NotificationDispatcher {
+ public:
+  explicit NotificationDispatcher(Service* service)
+      : service_(service), queue_(Service::kNotificationQueueSize) {
+#ifndef RIME_NO_THREADING
+    worker_ = std::thread([this] { Run(); });
+#endif
+  }
+
+  ~NotificationDispatcher() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stopping_ = true;
+    }
+    cv_.notify_one();
+#ifndef RIME_NO_THREADING
+    if (worker_.joinable())
+      worker_.join();
+#endif
+    // deliver whatever is left.
+    Drain();
+  }
+
+  // never waits for the handler, which may be calling back into a session
+  // whose engine is the one notifying; drops the message if the handler has
+  // fallen a whole queue behind.
+  bool Post(Notification notification) {
+    if (!queue_.TryPush(std::move(notification)))
+      return false;
+    // the lock is taken only to wake the dispatcher up when it is idle.
+    // pairs with the fence in Run(): either the dispatcher sees the message
+    // before going idle, or we see it idle.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (idle_.load()) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      cv_.notify_one();
+    }
+    return true;
+  }
+
+ private:
+  void Run() {
+    while (true) {
+      Drain();
+      std::unique_lock<std::mutex> lock(mutex_);
+      idle_.store(true);
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      cv_.wait(lock, [this] { return stopping_ || !queue_.empty(); });
+      idle_.store(false);
+      if (stopping_)
+        return;
+    }
+  }
+
+  void Drain() {
+    vector<Notification> batch;
+    Notification notification;
+    while (queue_.TryPop(&notification)) {
+      batch.push_back(std::move(notification));
+    }
+    Coalesce(&batch);
+    for (const auto& n : batch) {
+      service_->DispatchNotification(n.session_id, n.type, n.value);
+    }
+  }
+
+  // of a batch of updates of the same option or property in a session,
+  // only the last one is delivered.
+  static void Coalesce(vector<Notification>* batch) {
+    if (batch->size() < 2)
+      return;
+    auto key_of = [](const Notification& n) -> string {
+      if (n.type == "option") {
+        // "!ascii_mode" switches the same option as "ascii_mode".
+        return n.value.substr(!n.value.empty() && n.value[0] == '!');
+      }
+      if (n.type == "property") {
+        return n.value.substr(0, n.value.find('='));
+      }
+      return string();
+    };
+    set<pair<SessionId, string>> seen;
+    vector<bool> redundant(batch->size());
+    for (size_t i = batch->size(); i-- > 0;) {
+      const auto& n = (*batch)[i];
+      if (n.type != "option" && n.type != "property")
+        continue;
+      if (!seen.insert({n.session_id, n.type + ":" + key_of(n)}).second)
+        redundant[i] = true;
+    }
+    size_t j = 0;
+    for (size_t i = 0; i < batch->size(); ++i) {
+      if (!redundant[i])
+        (*batch)[j++] = std::move((*batch)[i]);
+    }
+    batch->resize(j);
+  }
+
+  Service* service_;
+  RingBuffer<Notification> queue_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::atomic<bool> idle_{false};
+  bool stopping_ = false;
+#ifndef RIME_NO_THREADING
+  std::thread worker_;
+#endif
+};
+
+Service::Service() : preloader_(new Preloader) {
   deployer_.message_sink().connect(
       [this](auto type, auto value) { Notify(0, type, value); });
 }
@@ -80,6 +200,10 @@ void Service::StartService() {
 void Service::StopService() {
   started_ = false;
   CleanupAllSessions();
+  // tasks may refer to components, which go with the modules.
+  preloader_->Cancel();
+  // delivers what is left while the handler is still there.
+  set_async_notifications(false);
 }
 
 SessionId Service::CreateSession() {
@@ -87,10 +211,13 @@ SessionId Service::CreateSession() {
   if (disabled())
     return id;
   try {
+    std::lock_guard<std::recursive_mutex> engine_lock(Engine::shared_mutex());
     auto session = New<Session>();
     session->Activate();
     id = reinterpret_cast<uintptr_t>(session.get());
-    sessions_[id] = session;
+    SessionShard& s = shard(id);
+    std::lock_guard<std::mutex> lock(s.mutex);
+    s.sessions[id] = session;
   } catch (const std::exception& ex) {
     LOG(ERROR) << "Error creating session: " << ex.what();
   } catch (const string& ex) {
@@ -105,11 +232,18 @@ SessionId Service::CreateSession() {
   return id;
 }
 
+Service::SessionShard& Service::shard(SessionId session_id) {
+  // ids are addresses of sessions; the lowest bits are always the same.
+  return shards_[(session_id >> 4) % kNumSessionShards];
+}
+
 an<Session> Service::GetSession(SessionId session_id) {
   if (disabled())
     return nullptr;
-  SessionMap::iterator it = sessions_.find(session_id);
-  if (it != sessions_.end()) {
+  SessionShard& s = shard(session_id);
+  std::lock_guard<std::mutex> lock(s.mutex);
+  SessionMap::iterator it = s.sessions.find(session_id);
+  if (it != s.sessions.end()) {
     auto& session = it->second;
     session->Activate();
     return session;
@@ -118,24 +252,43 @@ an<Session> Service::GetSession(SessionId session_id) {
 }
 
 bool Service::DestroySession(SessionId session_id) {
-  auto it = sessions_.find(session_id);
-  if (it == sessions_.end())
-    return false;
-  sessions_.erase(it);
+  an<Session> session;
+  {
+    SessionShard& s = shard(session_id);
+    std::lock_guard<std::mutex> lock(s.mutex);
+    auto it = s.sessions.find(session_id);
+    if (it == s.sessions.end())
+      return false;
+    session = std::move(it->second);
+    s.sessions.erase(it);
+  }
+  // released out of the shard lock, as tearing down the engine takes a while,
+  // but under the engines' lock, since components are shared.
+  std::lock_guard<std::recursive_mutex> engine_lock(Engine::shared_mutex());
+  session.reset();
   return true;
 }
 
 void Service::CleanupStaleSessions() {
   time_t now = time(NULL);
   int count = 0;
-  for (auto it = sessions_.begin(); it != sessions_.end();) {
-    if (it->second &&
-        it->second->last_active_time() < now - Session::kLifeSpan) {
-      sessions_.erase(it++);
-      ++count;
-    } else {
-      ++it;
+  for (SessionShard& s : shards_) {
+    vector<an<Session>> stale;
+    {
+      std::lock_guard<std::mutex> lock(s.mutex);
+      for (auto it = s.sessions.begin(); it != s.sessions.end();) {
+        if (it->second &&
+            it->second->last_active_time() < now - Session::kLifeSpan) {
+          stale.push_back(std::move(it->second));
+          s.sessions.erase(it++);
+        } else {
+          ++it;
+        }
+      }
     }
+    count += stale.size();
+    std::lock_guard<std::recursive_mutex> engine_lock(Engine::shared_mutex());
+    stale.clear();
   }
   if (count > 0) {
     LOG(INFO) << "Recycled " << count << " stale sessions.";
@@ -143,22 +296,74 @@ void Service::CleanupStaleSessions() {
 }
 
 void Service::CleanupAllSessions() {
-  sessions_.clear();
+  for (SessionShard& s : shards_) {
+    SessionMap sessions;
+    {
+      std::lock_guard<std::mutex> lock(s.mutex);
+      sessions.swap(s.sessions);
+    }
+    std::lock_guard<std::recursive_mutex> engine_lock(Engine::shared_mutex());
+    sessions.clear();
+  }
 }
 
 void Service::SetNotificationHandler(const NotificationHandler& handler) {
+  std::lock_guard<std::mutex> lock(mutex_);
   notification_handler_ = handler;
 }
 
 void Service::ClearNotificationHandler() {
+  std::lock_guard<std::mutex> lock(mutex_);
   notification_handler_ = nullptr;
 }
 
 void Service::Notify(SessionId session_id,
                      const string& message_type,
                      const string& message_value) {
+  {
+    std::shared_lock<std::shared_mutex> lock(dispatcher_mutex_);
+    if (dispatcher_) {
+      if (!dispatcher_->Post({session_id, message_type, message_value})) {
+        if (dropped_notifications_++ == 0)
+          LOG(WARNING) << "notification queue is full; dropping messages.";
+      }
+      return;
+    }
+  }
+  DispatchNotification(session_id, message_type, message_value);
+}
+
+void Service::set_async_notifications(bool async) {
+#ifndef RIME_NO_THREADING
+  the<NotificationDispatcher> stopped;
+  {
+    std::unique_lock<std::shared_mutex> lock(dispatcher_mutex_);
+    if (async && !dispatcher_) {
+      dispatcher_.reset(new NotificationDispatcher(this));
+    } else if (!async) {
+      stopped = std::move(dispatcher_);
+    }
+  }
+  // no one posts to it any more; delivers the pending notifications before
+  // returning, outside the lock since handlers may notify in turn.
+  stopped.reset();
+#endif
+}
+
+size_t Service::dropped_notifications() const {
+  return dropped_notifications_.load();
+}
+
+bool Service::async_notifications() const {
+  std::shared_lock<std::shared_mutex> lock(dispatcher_mutex_);
+  return bool(dispatcher_);
+}
+
+void Service::DispatchNotification(SessionId session_id,
+                                   const string& message_type,
+                                   const string& message_value) {
+  std::lock_guard<std::mutex> lock(mutex_);
   if (notification_handler_) {
-    std::lock_guard<std::mutex> lock(mutex_);
     notification_handler_(session_id, message_type.c_str(),
                           message_value.c_str());
   }
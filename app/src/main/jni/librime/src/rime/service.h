@@ -9,9 +9,12 @@
 
 #include <stdint.h>
 #include <time.h>
+#include <atomic>
 #include <mutex>
+#include <shared_mutex>
 #include <rime/common.h>
 #include <rime/deployer.h>
+#include <rime/engine.h>
 
 namespace rime {
 
@@ -24,7 +27,6 @@ using NotificationHandler = function<void(SessionId session_id,
                                           const char* message_value)>;
 
 class Context;
-class Engine;
 class KeyEvent;
 class Schema;
 
@@ -49,10 +51,29 @@ class Session {
   void OnCommit(const string& commit_text);
 
   the<Engine> engine_;
-  time_t last_active_time_ = 0;
+  std::atomic<time_t> last_active_time_{0};
   string commit_text_;
 };
 
+// a session driven with the engines' shared lock held for the lifetime of this
+// object; see Engine::shared_mutex().
+class LockedSession {
+ public:
+  explicit LockedSession(an<Session> session)
+      : lock_(Engine::shared_mutex()), session_(std::move(session)) {}
+
+  explicit operator bool() const { return bool(session_); }
+  Session* operator->() const { return session_.get(); }
+  Session& operator*() const { return *session_; }
+
+ private:
+  std::unique_lock<std::recursive_mutex> lock_;
+  // released before the lock, in case this is the last reference.
+  an<Session> session_;
+};
+
+class NotificationDispatcher;
+class Preloader;
 class ResourceResolver;
 struct ResourceType;
 
@@ -65,6 +86,10 @@ class RIME_DLL Service {
 
   SessionId CreateSession();
   an<Session> GetSession(SessionId session_id);
+  // gets the session and holds its lock until the result goes out of scope.
+  LockedSession LockSession(SessionId session_id) {
+    return LockedSession(GetSession(session_id));
+  }
   bool DestroySession(SessionId session_id);
   void CleanupStaleSessions();
   void CleanupAllSessions();
@@ -74,6 +99,20 @@ class RIME_DLL Service {
   void Notify(SessionId session_id,
               const string& message_type,
               const string& message_value);
+  // calls the notification handler directly on the notifying thread.
+  void DispatchNotification(SessionId session_id,
+                            const string& message_type,
+                            const string& message_value);
+  // when enabled, notifications are queued and delivered to the handler on
+  // a dispatcher thread, so that a slow handler does not hold up the engine;
+  // redundant option and property updates are coalesced on the way.
+  // StopService() turns it off after delivering what is queued.
+  void set_async_notifications(bool async);
+  bool async_notifications() const;
+  // notifications queued for the handler; when it falls that far behind,
+  // Notify() drops further messages rather than wait, and counts them.
+  static constexpr size_t kNotificationQueueSize = 1024;
+  size_t dropped_notifications() const;
 
   ResourceResolver* CreateResourceResolver(const ResourceType& type);
   ResourceResolver* CreateUserSpecificResourceResolver(
@@ -81,6 +120,9 @@ class RIME_DLL Service {
   ResourceResolver* CreateDeployedResourceResolver(const ResourceType& type);
   ResourceResolver* CreateStagingResourceResolver(const ResourceType& type);
 
+  // loads the resources of selected schemas in the background.
+  Preloader& preloader() { return *preloader_; }
+
   Deployer& deployer() { return deployer_; }
   bool disabled() { return !started_ || deployer_.IsMaintenanceMode(); }
 
@@ -90,11 +132,25 @@ class RIME_DLL Service {
   Service();
 
   using SessionMap = map<SessionId, an<Session>>;
-  SessionMap sessions_;
+  // sessions are spread over shards with a lock each, so that threads
+  // driving different sessions rarely wait for one another.
+  struct SessionShard {
+    std::mutex mutex;
+    SessionMap sessions;
+  };
+  static constexpr size_t kNumSessionShards = 16;
+  SessionShard& shard(SessionId session_id);
+
+  SessionShard shards_[kNumSessionShards];
   Deployer deployer_;
   NotificationHandler notification_handler_;
   std::mutex mutex_;
-  bool started_ = false;
+  // held shared while posting to the dispatcher, exclusively to replace it.
+  mutable std::shared_mutex dispatcher_mutex_;
+  the<NotificationDispatcher> dispatcher_;
+  std::atomic<size_t> dropped_notifications_{0};
+  the<Preloader> preloader_;
+  std::atomic<bool> started_{false};
 };
 
 }  // namespace rime
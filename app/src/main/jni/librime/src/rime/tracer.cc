@@ -0,0 +1,177 @@
+//
+// Copyright RIME Developers
+// Distributed under the BSD License
+//
+#include <algorithm>
+#include <functional>
+#include <thread>
+#include <rime/translation.h>
+#include <rime/tracer.h>
+
+namespace rime {
+
+using Clock = std::chrono::steady_clock;
+
+std::atomic<bool> Tracer::enabled_{false};
+
+// the innermost scope being timed on this thread.
+static thread_local TraceScope* current_scope = nullptr;
+
+Tracer& Tracer::instance() {
+  static Tracer tracer;
+  return tracer;
+}
+
+bool Tracer::Start(const path& trace_event_file) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (trace_events_.is_open()) {
+    trace_events_ << "\n]\n";
+    trace_events_.close();
+  }
+  if (!trace_event_file.empty()) {
+    trace_events_.open(trace_event_file, std::ios::out | std::ios::trunc);
+    if (!trace_events_) {
+      LOG(ERROR) << "error opening trace event file: " << trace_event_file;
+      return false;
+    }
+    trace_events_ << "[";
+    num_trace_events_ = 0;
+  }
+  counters_.clear();
+  epoch_ = Clock::now();
+  enabled_ = true;
+  return true;
+}
+
+void Tracer::Stop() {
+  enabled_ = false;
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (trace_events_.is_open()) {
+    trace_events_ << "\n]\n";
+    trace_events_.close();
+  }
+}
+
+map<string, Tracer::Counter> Tracer::counters(bool reset) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!reset)
+    return counters_;
+  map<string, Counter> result;
+  result.swap(counters_);
+  return result;
+}
+
+static void write_json_string(std::ostream& out, const string& str) {
+  out << '"';
+  for (char c : str) {
+    if (c == '"' || c == '\\') {
+      out << '\\' << c;
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      out << ' ';
+    } else {
+      out << c;
+    }
+  }
+  out << '"';
+}
+
+void Tracer::Record(const char* stage,
+                    const string& name,
+                    const string* detail,
+                    Clock::time_point start,
+                    double total_us,
+                    double self_us) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  Counter& counter = counters_[string(stage) + '/' + name];
+  ++counter.count;
+  counter.total_us += total_us;
+  counter.self_us += self_us;
+  counter.max_us = (std::max)(counter.max_us, total_us);
+  if (!trace_events_.is_open())
+    return;
+  // complete events, in microseconds since tracing started.
+  trace_events_ << (num_trace_events_++ ? ",\n" : "\n") << "{\"name\": ";
+  write_json_string(trace_events_, name);
+  trace_events_ << ", \"cat\": \"" << stage << "\", \"ph\": \"X\", \"ts\": "
+                << std::chrono::duration<double, std::micro>(start - epoch_)
+                       .count()
+                << ", \"dur\": " << total_us << ", \"pid\": 1, \"tid\": "
+                << std::hash<std::thread::id>()(std::this_thread::get_id()) %
+                       100000;
+  if (detail) {
+    trace_events_ << ", \"args\": {\"detail\": ";
+    write_json_string(trace_events_, *detail);
+    trace_events_ << "}";
+  }
+  trace_events_ << "}";
+}
+
+void Tracer::CountLookup(const char* cache, bool hit) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  Counter& counter = counters_[string("cache/") + cache];
+  ++counter.count;
+  if (hit)
+    ++counter.hits;
+}
+
+void TraceScope::Begin() {
+  parent_ = current_scope;
+  current_scope = this;
+  start_ = Clock::now();
+}
+
+void TraceScope::End() {
+  double total_us =
+      std::chrono::duration<double, std::micro>(Clock::now() - start_).count();
+  current_scope = parent_;
+  if (parent_)
+    parent_->children_us_ += total_us;
+  if (Tracer::enabled()) {
+    Tracer::instance().Record(stage_, *name_, detail_, start_, total_us,
+                              total_us - children_us_);
+  }
+}
+
+class TracedTranslation : public Translation {
+ public:
+  TracedTranslation(an<Translation> translation,
+                    const char* stage,
+                    const string& name)
+      : translation_(translation), stage_(stage), name_(name) {
+    set_exhausted(translation_->exhausted());
+  }
+
+  bool Next() override {
+    TraceScope scope(stage_, Tracer::enabled() ? &name_ : nullptr);
+    bool result = translation_->Next();
+    set_exhausted(translation_->exhausted());
+    return result;
+  }
+
+  an<Candidate> Peek() override {
+    TraceScope scope(stage_, Tracer::enabled() ? &name_ : nullptr);
+    auto candidate = translation_->Peek();
+    set_exhausted(translation_->exhausted());
+    return candidate;
+  }
+
+  int Compare(an<Translation> other,
+              const CandidateList& candidates) override {
+    return translation_->Compare(other, candidates);
+  }
+
+ private:
+  an<Translation> translation_;
+  const char* stage_;
+  string name_;
+};
+
+an<Translation> TraceTranslation(an<Translation> translation,
+                                 const char* stage,
+                                 const string& name) {
+  if (!translation)
+    return translation;
+  return New<TracedTranslation>(translation, stage, name);
+}
+
+}  // namespace rime
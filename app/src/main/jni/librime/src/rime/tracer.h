@@ -0,0 +1,112 @@
+//
+// Copyright RIME Developers
+// Distributed under the BSD License
+//
+#ifndef RIME_TRACER_H_
+#define RIME_TRACER_H_
+
+#include <stdint.h>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <mutex>
+#include <rime_api.h>
+#include <rime/common.h>
+
+namespace rime {
+
+class Translation;
+
+// times the stages of the engine, component by component, and counts the
+// lookups of caches, for all sessions of the process.
+//
+// off by default; call sites check enabled() before doing anything else, so
+// that tracing costs one relaxed load when off.
+class RIME_DLL Tracer {
+ public:
+  struct Counter {
+    uint64_t count = 0;
+    // of cache lookups, those served from the cache.
+    uint64_t hits = 0;
+    // in microseconds; self time excludes that of the stages nested within.
+    double total_us = 0;
+    double self_us = 0;
+    double max_us = 0;
+  };
+
+  static Tracer& instance();
+  static bool enabled() { return enabled_.load(std::memory_order_relaxed); }
+
+  // with a file path, also writes the stages as trace events, which can be
+  // viewed in chrome://tracing or Perfetto, until stopped.
+  bool Start(const path& trace_event_file = path());
+  void Stop();
+
+  // counters by "stage/component", such as "filter/lua_filter@*my_filter",
+  // and "cache/<name>" for caches.
+  map<string, Counter> counters(bool reset = false);
+
+  void Record(const char* stage,
+              const string& name,
+              const string* detail,
+              std::chrono::steady_clock::time_point start,
+              double total_us,
+              double self_us);
+  void CountLookup(const char* cache, bool hit);
+
+ private:
+  Tracer() = default;
+
+  static std::atomic<bool> enabled_;
+  std::mutex mutex_;
+  map<string, Counter> counters_;
+  std::ofstream trace_events_;
+  size_t num_trace_events_ = 0;
+  std::chrono::steady_clock::time_point epoch_;
+};
+
+// times the enclosed stage on this thread while tracing is on.
+class RIME_DLL TraceScope {
+ public:
+  // does nothing without a name, which callers pass only when tracing.
+  TraceScope(const char* stage,
+             const string* name,
+             const string* detail = nullptr)
+      : stage_(stage), name_(name), detail_(detail) {
+    if (name_)
+      Begin();
+  }
+  ~TraceScope() {
+    if (name_)
+      End();
+  }
+
+  TraceScope(const TraceScope&) = delete;
+  TraceScope& operator=(const TraceScope&) = delete;
+
+ private:
+  void Begin();
+  void End();
+
+  const char* stage_;
+  const string* name_;
+  const string* detail_;
+  TraceScope* parent_ = nullptr;
+  std::chrono::steady_clock::time_point start_;
+  double children_us_ = 0;
+};
+
+// counts a lookup of the named cache while tracing is on.
+inline void TraceCacheLookup(const char* cache, bool hit) {
+  if (Tracer::enabled())
+    Tracer::instance().CountLookup(cache, hit);
+}
+
+// times the candidates that the translation yields under the given name.
+RIME_DLL an<Translation> TraceTranslation(an<Translation> translation,
+                                          const char* stage,
+                                          const string& name);
+
+}  // namespace rime
+
+#endif  // RIME_TRACER_H_
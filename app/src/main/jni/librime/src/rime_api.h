@@ -208,6 +208,24 @@ typedef struct rime_schema_list_t {
   RimeSchemaListItem* list;
 } RimeSchemaList;
 
+//! time spent in a stage of the engine by a component, such as
+//! "translator/script_translator", or lookups of a cache, such as "cache/menu"
+typedef struct rime_trace_counter_t {
+  const char* name;
+  unsigned long long count;
+  //! of cache lookups, those served from the cache
+  unsigned long long hits;
+  //! in microseconds; self time excludes that of the stages nested within
+  double total_us;
+  double self_us;
+  double max_us;
+} RimeTraceCounter;
+
+typedef struct rime_trace_counters_t {
+  size_t size;
+  RimeTraceCounter* list;
+} RimeTraceCounters;
+
 typedef struct rime_string_slice_t {
   const char* str;
   size_t length;
@@ -425,7 +443,8 @@ typedef struct RIME_FLAVORED(rime_api_t) {
   //! get raw input
   /*!
    *  NULL is returned if session does not exist.
-   *  the returned pointer to input string will become invalid upon editing.
+   *  the returned string is a copy owned by the calling thread, which stays
+   *  valid until the next call to get_input on the same thread.
    */
   const char* (*get_input)(RimeSessionId session_id);
 
@@ -505,6 +524,27 @@ typedef struct RIME_FLAVORED(rime_api_t) {
                                               size_t index);
 
   Bool (*change_page)(RimeSessionId session_id, Bool backward);
+
+  //! like get_context, but lays out the strings and arrays of the context in
+  //! a buffer owned by the caller, which can be reused for every key.
+  //! the context stays valid as long as the buffer, and must not be passed to
+  //! free_context.
+  //! *buffer_size is the size of the buffer on input, and the size used on
+  //! output. if the buffer is too small, returns False and sets *buffer_size
+  //! to the size needed.
+  Bool (*get_context_in_buffer)(RimeSessionId session_id,
+                                RIME_FLAVORED(RimeContext) * context,
+                                char* buffer,
+                                size_t* buffer_size);
+
+  //! times the stages of the engine per component and counts cache lookups,
+  //! for all sessions. with a file path, also writes trace events in the
+  //! chrome trace event format, which can be opened in Perfetto, until
+  //! tracing is disabled.
+  Bool (*set_tracing)(Bool enabled, const char* trace_event_file);
+  //! counters collected since tracing was enabled or last reset
+  Bool (*get_trace_counters)(RimeTraceCounters* counters, Bool reset);
+  void (*free_trace_counters)(RimeTraceCounters* counters);
 } RIME_FLAVORED(RimeApi);
 
 //! API entry
@@ -3,6 +3,8 @@
 
 #include "rime_api.h"
 
+#include <cstddef>
+#include <cstring>
 #include <rime/common.h>
 #include <rime/composition.h>
 #include <rime/config.h>
@@ -17,6 +19,7 @@
 #include <rime/setup.h>
 #include <rime/signature.h>
 #include <rime/switches.h>
+#include <rime/tracer.h>
 
 using namespace rime;
 
@@ -171,21 +174,21 @@ RIME_DEPRECATED void RimeCleanupAllSessions() {
 RIME_DEPRECATED Bool RimeProcessKey(RimeSessionId session_id,
                                     int keycode,
                                     int mask) {
-  an<Session> session(Service::instance().GetSession(session_id));
+  auto session = Service::instance().LockSession(session_id);
   if (!session)
     return False;
   return Bool(session->ProcessKey(KeyEvent(keycode, mask)));
 }
 
 RIME_DEPRECATED Bool RimeCommitComposition(RimeSessionId session_id) {
-  an<Session> session(Service::instance().GetSession(session_id));
+  auto session = Service::instance().LockSession(session_id);
   if (!session)
     return False;
   return Bool(session->CommitComposition());
 }
 
 RIME_DEPRECATED void RimeClearComposition(RimeSessionId session_id) {
-  an<Session> session(Service::instance().GetSession(session_id));
+  auto session = Service::instance().LockSession(session_id);
   if (!session)
     return;
   session->ClearComposition();
@@ -193,25 +196,82 @@ RIME_DEPRECATED void RimeClearComposition(RimeSessionId session_id) {
 
 // output
 
-static void rime_candidate_copy(RimeCandidate* dest, const an<Candidate>& src) {
-  dest->text = new char[src->text().length() + 1];
-  std::strcpy(dest->text, src->text().c_str());
-  string comment(src->comment());
-  if (!comment.empty()) {
-    dest->comment = new char[comment.length() + 1];
-    std::strcpy(dest->comment, comment.c_str());
-  } else {
-    dest->comment = nullptr;
+// allocates strings and arrays of the context on the heap, to be released by
+// RimeFreeContext.
+class ContextHeap {
+ public:
+  char* CopyString(const string& str) {
+    char* copy = new char[str.length() + 1];
+    std::strcpy(copy, str.c_str());
+    return copy;
+  }
+  template <class T>
+  T* NewArray(size_t size) {
+    return new T[size];
+  }
+};
+
+// lays out strings and arrays of the context in a buffer owned by the client.
+// once out of room, returns nullptr but keeps counting the size needed.
+class ContextArena {
+ public:
+  ContextArena(char* buffer, size_t capacity)
+      : buffer_(buffer), capacity_(capacity) {}
+
+  char* CopyString(const string& str) {
+    char* copy = Allocate(str.length() + 1, 1);
+    if (copy)
+      std::memcpy(copy, str.c_str(), str.length() + 1);
+    return copy;
   }
+  template <class T>
+  T* NewArray(size_t size) {
+    return reinterpret_cast<T*>(Allocate(sizeof(T) * size, alignof(T)));
+  }
+
+  bool exhausted() const { return size_ > capacity_; }
+  // the size used, or the size needed to fit in if exhausted.
+  size_t size() const {
+    // arrays in a different buffer may need more padding.
+    return exhausted() ? size_ + 2 * alignof(std::max_align_t) : size_;
+  }
+
+ private:
+  char* Allocate(size_t size, size_t alignment) {
+    uintptr_t address = reinterpret_cast<uintptr_t>(buffer_) + size_;
+    size_ += (alignment - address % alignment) % alignment;
+    char* result = size_ + size <= capacity_ ? buffer_ + size_ : nullptr;
+    size_ += size;
+    return result;
+  }
+
+  char* buffer_;
+  size_t capacity_;
+  size_t size_ = 0;
+};
+
+template <class Storage>
+static void rime_candidate_copy(RimeCandidate* dest,
+                                const an<Candidate>& src,
+                                Storage* storage) {
+  char* text = storage->CopyString(src->text());
+  string comment(src->comment());
+  char* comment_copy = comment.empty() ? nullptr : storage->CopyString(comment);
+  if (!dest)
+    return;
+  dest->text = text;
+  dest->comment = comment_copy;
   dest->reserved = nullptr;
 }
 
-RIME_DEPRECATED Bool RimeGetContext(RimeSessionId session_id,
-                                    RIME_FLAVORED(RimeContext) * context) {
+template <class Storage>
+static Bool rime_get_context(RimeSessionId session_id,
+                             RIME_FLAVORED(RimeContext) * context,
+                             Storage* storage) {
   if (!context || context->data_size <= 0)
     return False;
   RIME_STRUCT_CLEAR(*context);
-  an<Session> session(Service::instance().GetSession(session_id));
+  auto session = Service::instance().LockSession(session_id);
   if (!session)
     return False;
   Context* ctx = session->context();
@@ -220,16 +280,14 @@ RIME_DEPRECATED Bool RimeGetContext(RimeSessionId session_id,
   if (ctx->IsComposing()) {
     Preedit preedit = ctx->GetPreedit();
     context->composition.length = preedit.text.length();
-    context->composition.preedit = new char[preedit.text.length() + 1];
-    std::strcpy(context->composition.preedit, preedit.text.c_str());
+    context->composition.preedit = storage->CopyString(preedit.text);
     context->composition.cursor_pos = preedit.caret_pos;
     context->composition.sel_start = preedit.sel_start;
     context->composition.sel_end = preedit.sel_end;
     if (RIME_STRUCT_HAS_MEMBER(*context, context->commit_text_preview)) {
       string commit_text(ctx->GetCommitText());
       if (!commit_text.empty()) {
-        context->commit_text_preview = new char[commit_text.length() + 1];
-        std::strcpy(context->commit_text_preview, commit_text.c_str());
+        context->commit_text_preview = storage->CopyString(commit_text);
       }
     }
   }
@@ -249,31 +307,35 @@ RIME_DEPRECATED Bool RimeGetContext(RimeSessionId session_id,
       context->menu.highlighted_candidate_index = selected_index % page_size;
       int i = 0;
       context->menu.num_candidates = page->candidates.size();
-      if (ctx->get_option("_hide_candidate")) {
+      static const Atom kHideCandidate =
+          AtomTable::options().Intern("_hide_candidate");
+      if (ctx->get_option(kHideCandidate)) {
         context->menu.num_candidates = 0;
         return True;
       }
-      context->menu.candidates = new RimeCandidate[page->candidates.size()];
+      context->menu.candidates =
+          storage->template NewArray<RimeCandidate>(page->candidates.size());
       for (const an<Candidate>& cand : page->candidates) {
-        RimeCandidate* dest = &context->menu.candidates[i++];
-        rime_candidate_copy(dest, cand);
+        RimeCandidate* dest = context->menu.candidates
+                                  ? &context->menu.candidates[i++]
+                                  : nullptr;
+        rime_candidate_copy(dest, cand, storage);
       }
       if (schema) {
         const string& select_keys(schema->select_keys());
         if (!select_keys.empty()) {
-          context->menu.select_keys = new char[select_keys.length() + 1];
-          std::strcpy(context->menu.select_keys, select_keys.c_str());
+          context->menu.select_keys = storage->CopyString(select_keys);
         }
-        Config* config = schema->config();
-        an<ConfigList> select_labels =
-            config->GetList("menu/alternative_select_labels");
-        if (select_labels && (size_t)page_size <= select_labels->size()) {
-          context->select_labels = new char*[page_size];
+        // read from the schema once, when it is loaded.
+        const auto& select_labels = schema->select_labels();
+        if ((size_t)page_size <= select_labels.size() &&
+            RIME_STRUCT_HAS_MEMBER(*context, context->select_labels)) {
+          context->select_labels =
+              storage->template NewArray<char*>(page_size);
           for (size_t i = 0; i < (size_t)page_size; ++i) {
-            an<ConfigValue> value = select_labels->GetValueAt(i);
-            string label = value->str();
-            context->select_labels[i] = new char[label.length() + 1];
-            std::strcpy(context->select_labels[i], label.c_str());
+            char* label = storage->CopyString(select_labels[i]);
+            if (context->select_labels)
+              context->select_labels[i] = label;
           }
         }
       }
@@ -282,6 +344,74 @@ RIME_DEPRECATED Bool RimeGetContext(RimeSessionId session_id,
   return True;
 }
 
+RIME_DEPRECATED Bool RimeGetContext(RimeSessionId session_id,
+                                    RIME_FLAVORED(RimeContext) * context) {
+  ContextHeap heap;
+  return rime_get_context(session_id, context, &heap);
+}
+
+static Bool RimeGetContextInBuffer(RimeSessionId session_id,
+                                   RIME_FLAVORED(RimeContext) * context,
+                                   char* buffer,
+                                   size_t* buffer_size) {
+  if (!buffer_size)
+    return False;
+  ContextArena arena(buffer, buffer ? *buffer_size : 0);
+  if (!rime_get_context(session_id, context, &arena))
+    return False;
+  *buffer_size = arena.size();
+  if (arena.exhausted()) {
+    RIME_STRUCT_CLEAR(*context);
+    return False;
+  }
+  return True;
+}
+
+static Bool RimeSetTracing(Bool enabled, const char* trace_event_file) {
+  if (!enabled) {
+    Tracer::instance().Stop();
+    return True;
+  }
+  return Bool(Tracer::instance().Start(trace_event_file ? path(trace_event_file)
+                                                        : path()));
+}
+
+static Bool RimeGetTraceCounters(RimeTraceCounters* output, Bool reset) {
+  if (!output)
+    return False;
+  output->size = 0;
+  output->list = NULL;
+  auto counters = Tracer::instance().counters(reset);
+  if (counters.empty())
+    return False;
+  output->list = new RimeTraceCounter[counters.size()];
+  for (const auto& entry : counters) {
+    RimeTraceCounter& x(output->list[output->size++]);
+    char* name = new char[entry.first.length() + 1];
+    strcpy(name, entry.first.c_str());
+    x.name = name;
+    x.count = entry.second.count;
+    x.hits = entry.second.hits;
+    x.total_us = entry.second.total_us;
+    x.self_us = entry.second.self_us;
+    x.max_us = entry.second.max_us;
+  }
+  return True;
+}
+
+static void RimeFreeTraceCounters(RimeTraceCounters* counters) {
+  if (!counters)
+    return;
+  if (counters->list) {
+    for (size_t i = 0; i < counters->size; ++i) {
+      delete[] counters->list[i].name;
+    }
+    delete[] counters->list;
+  }
+  counters->size = 0;
+  counters->list = NULL;
+}
+
 RIME_DEPRECATED Bool RimeFreeContext(RIME_FLAVORED(RimeContext) * context) {
   if (!context || context->data_size <= 0)
     return False;
@@ -311,7 +441,7 @@ RIME_DEPRECATED Bool RimeGetCommit(RimeSessionId session_id,
   if (!commit)
     return False;
   RIME_STRUCT_CLEAR(*commit);
-  an<Session> session(Service::instance().GetSession(session_id));
+  auto session = Service::instance().LockSession(session_id);
   if (!session)
     return False;
   const string& commit_text(session->commit_text());
@@ -337,7 +467,7 @@ RIME_DEPRECATED Bool RimeGetStatus(RimeSessionId session_id,
   if (!status || status->data_size <= 0)
     return False;
   RIME_STRUCT_CLEAR(*status);
-  an<Session> session(Service::instance().GetSession(session_id));
+  auto session = Service::instance().LockSession(session_id);
   if (!session)
     return False;
   Schema* schema = session->schema();
@@ -375,7 +505,7 @@ RimeCandidateListFromIndex(RimeSessionId session_id,
                            int index) {
   if (!iterator)
     return False;
-  an<Session> session(Service::instance().GetSession(session_id));
+  auto session = Service::instance().LockSession(session_id);
   if (!session)
     return False;
   Context* ctx = session->context();
@@ -404,7 +534,8 @@ RimeCandidateListNext(RimeCandidateListIterator* iterator) {
   if (auto cand = menu->GetCandidateAt((size_t)iterator->index)) {
     delete[] iterator->candidate.text;
     delete[] iterator->candidate.comment;
-    rime_candidate_copy(&iterator->candidate, cand);
+    ContextHeap heap;
+    rime_candidate_copy(&iterator->candidate, cand, &heap);
     return True;
   }
   return False;
@@ -423,7 +554,7 @@ RIME_DEPRECATED void RimeCandidateListEnd(RimeCandidateListIterator* iterator) {
 RIME_DEPRECATED void RimeSetOption(RimeSessionId session_id,
                                    const char* option,
                                    Bool value) {
-  an<Session> session(Service::instance().GetSession(session_id));
+  auto session = Service::instance().LockSession(session_id);
   if (!session)
     return;
   Context* ctx = session->context();
@@ -434,7 +565,7 @@ RIME_DEPRECATED void RimeSetOption(RimeSessionId session_id,
 
 RIME_DEPRECATED Bool RimeGetOption(RimeSessionId session_id,
                                    const char* option) {
-  an<Session> session(Service::instance().GetSession(session_id));
+  auto session = Service::instance().LockSession(session_id);
   if (!session)
     return False;
   Context* ctx = session->context();
@@ -446,7 +577,7 @@ RIME_DEPRECATED Bool RimeGetOption(RimeSessionId session_id,
 RIME_DEPRECATED void RimeSetProperty(RimeSessionId session_id,
                                      const char* prop,
                                      const char* value) {
-  an<Session> session(Service::instance().GetSession(session_id));
+  auto session = Service::instance().LockSession(session_id);
   if (!session)
     return;
   Context* ctx = session->context();
@@ -459,7 +590,7 @@ RIME_DEPRECATED Bool RimeGetProperty(RimeSessionId session_id,
                                      const char* prop,
                                      char* value,
                                      size_t buffer_size) {
-  an<Session> session(Service::instance().GetSession(session_id));
+  auto session = Service::instance().LockSession(session_id);
   if (!session)
     return False;
   Context* ctx = session->context();
@@ -527,7 +658,7 @@ RIME_DEPRECATED void RimeFreeSchemaList(RimeSchemaList* schema_list) {
 RIME_DEPRECATED Bool RimeGetCurrentSchema(RimeSessionId session_id,
                                           char* schema_id,
                                           size_t buffer_size) {
-  an<Session> session(Service::instance().GetSession(session_id));
+  auto session = Service::instance().LockSession(session_id);
   if (!session)
     return False;
   Schema* schema = session->schema();
@@ -541,7 +672,7 @@ RIME_DEPRECATED Bool RimeSelectSchema(RimeSessionId session_id,
                                       const char* schema_id) {
   if (!schema_id)
     return False;
-  an<Session> session(Service::instance().GetSession(session_id));
+  auto session = Service::instance().LockSession(session_id);
   if (!session)
     return False;
   session->ApplySchema(new Schema(schema_id));
@@ -768,7 +899,7 @@ RIME_DEPRECATED void RimeConfigEnd(RimeConfigIterator* iterator) {
 RIME_DEPRECATED Bool RimeSimulateKeySequence(RimeSessionId session_id,
                                              const char* key_sequence) {
   LOG(INFO) << "simulate key sequence: " << key_sequence;
-  an<Session> session(Service::instance().GetSession(session_id));
+  auto session = Service::instance().LockSession(session_id);
   if (!session)
     return False;
   KeySequence keys;
@@ -974,7 +1105,7 @@ RIME_DEPRECATED size_t RimeConfigListSize(RimeConfig* config, const char* key) {
 static bool do_with_candidate(RimeSessionId session_id,
                               size_t index,
                               bool (Context::*verb)(size_t index)) {
-  an<Session> session(Service::instance().GetSession(session_id));
+  auto session = Service::instance().LockSession(session_id);
   if (!session)
     return false;
   Context* ctx = session->context();
@@ -987,7 +1118,7 @@ static bool do_with_candidate_on_current_page(
     RimeSessionId session_id,
     size_t index,
     bool (Context::*verb)(size_t index)) {
-  an<Session> session(Service::instance().GetSession(session_id));
+  auto session = Service::instance().LockSession(session_id);
   if (!session)
     return false;
   Context* ctx = session->context();
@@ -1005,7 +1136,7 @@ static bool do_with_candidate_on_current_page(
 }
 
 static Bool RimeChangePage(RimeSessionId session_id, Bool backward) {
-  an<Session> session(Service::instance().GetSession(session_id));
+  auto session = Service::instance().LockSession(session_id);
   if (!session)
     return False;
   Context* ctx = session->context();
@@ -1060,17 +1191,21 @@ RIME_DEPRECATED Bool RimeDeleteCandidateOnCurrentPage(RimeSessionId session_id,
 }
 
 static const char* RimeGetInput(RimeSessionId session_id) {
-  an<Session> session(Service::instance().GetSession(session_id));
+  // a copy taken under the session lock, which is released on return; other
+  // threads driving the session cannot invalidate it.
+  thread_local string input;
+  auto session = Service::instance().LockSession(session_id);
   if (!session)
     return NULL;
   Context* ctx = session->context();
   if (!ctx)
     return NULL;
-  return ctx->input().c_str();
+  input = ctx->input();
+  return input.c_str();
 }
 
 RIME_DEPRECATED Bool RimeSetInput(RimeSessionId session_id, const char* input) {
-  an<Session> session(Service::instance().GetSession(session_id));
+  auto session = Service::instance().LockSession(session_id);
   if (!session)
     return False;
   Context* ctx = session->context();
@@ -1081,7 +1216,7 @@ RIME_DEPRECATED Bool RimeSetInput(RimeSessionId session_id, const char* input) {
 }
 
 static size_t RimeGetCaretPos(RimeSessionId session_id) {
-  an<Session> session(Service::instance().GetSession(session_id));
+  auto session = Service::instance().LockSession(session_id);
   if (!session)
     return 0;
   Context* ctx = session->context();
@@ -1091,7 +1226,7 @@ static size_t RimeGetCaretPos(RimeSessionId session_id) {
 }
 
 static void RimeSetCaretPos(RimeSessionId session_id, size_t caret_pos) {
-  an<Session> session(Service::instance().GetSession(session_id));
+  auto session = Service::instance().LockSession(session_id);
   if (!session)
     return;
   Context* ctx = session->context();
@@ -1104,7 +1239,7 @@ static RimeStringSlice RimeGetStateLabelAbbreviated(RimeSessionId session_id,
                                                     const char* option_name,
                                                     Bool state,
                                                     Bool abbreviated) {
-  an<Session> session(Service::instance().GetSession(session_id));
+  auto session = Service::instance().LockSession(session_id);
   if (!session)
     return {nullptr, 0};
   Config* config = session->schema()->config();
@@ -1232,6 +1367,10 @@ RIME_API RIME_FLAVORED(RimeApi) * RIME_FLAVORED(rime_get_api)() {
     s_api.highlight_candidate_on_current_page =
         &RimeHighlightCandidateOnCurrentPage;
     s_api.change_page = &RimeChangePage;
+    s_api.get_context_in_buffer = &RimeGetContextInBuffer;
+    s_api.set_tracing = &RimeSetTracing;
+    s_api.get_trace_counters = &RimeGetTraceCounters;
+    s_api.free_trace_counters = &RimeFreeTraceCounters;
   }
   return &s_api;
 }
@@ -8,6 +8,8 @@
 #include <gtest/gtest.h>
 #include <rime/common.h>
 #include <rime/algo/algebra.h>
+#include <rime/algo/calculus.h>
+#include "fixtures.h"
 
 static const char* kTransliteration =
     "xlit/ABCDEFGHIJKLMNOPQRSTUVWXYZ/abcdefghijklmnopqrstuvwxyz/";
@@ -76,3 +78,96 @@ TEST(RimeAlgebraTest, Projection) {
   EXPECT_EQ(rime::kAbbreviation, s["sh"][0].properties.type);
   EXPECT_DOUBLE_EQ(log(0.5), s["sh"][0].properties.credibility);
 }
+
+TEST(RimeAlgebraTest, LiteralRules) {
+  auto c = rime::New<rime::ConfigList>();
+  c->Append(rime::New<rime::ConfigValue>("xform/a1/ā/"));
+  c->Append(rime::New<rime::ConfigValue>("erase/xyz/"));
+  rime::Projection p;
+  ASSERT_TRUE(p.Load(c));
+
+  rime::string str("ha1ma1");
+  EXPECT_TRUE(p.Apply(&str));
+  EXPECT_EQ("hāmā", str);
+  str = "xyz";
+  EXPECT_TRUE(p.Apply(&str));
+  EXPECT_EQ("", str);
+  str = "xyzw";
+  EXPECT_FALSE(p.Apply(&str));
+  EXPECT_EQ("xyzw", str);
+}
+
+TEST(RimeAlgebraTest, MemoizedResults) {
+  auto c = rime::New<rime::ConfigList>();
+  c->Append(rime::New<rime::ConfigValue>(kTransliteration));
+  c->Append(rime::New<rime::ConfigValue>(kTransformation));
+  rime::Projection p;
+  ASSERT_TRUE(p.Load(c));
+
+  for (int i = 0; i < 2; ++i) {
+    rime::string str("Shang");
+    EXPECT_TRUE(p.Apply(&str));
+    EXPECT_EQ("sang", str);
+    str = "ba";
+    EXPECT_FALSE(p.Apply(&str));
+    EXPECT_EQ("ba", str);
+  }
+  EXPECT_EQ(4, p.stats().applications);
+  EXPECT_EQ(2, p.stats().cache_hits);
+}
+
+TEST(RimeAlgebraTest, FormattingWithCache) {
+  auto c = rime::fixtures::MakeRules(rime::fixtures::kToneMarks);
+  const char* syllables[] = {"zhong1", "guo2", "ren2", "min2", "lv4",
+                             "nve4",   "hao3", "xiang3", "shi4", "de5"};
+  rime::Projection uncached;
+  ASSERT_TRUE(uncached.Load(c));
+  uncached.set_cache_capacity(0);
+  rime::Projection cached;
+  ASSERT_TRUE(cached.Load(c));
+  rime::string str("lv4");
+  cached.Apply(&str);
+  EXPECT_EQ("lǜ", str);
+  // the second round is served from the cache.
+  for (int round = 0; round < 2; ++round) {
+    for (const char* syllable : syllables) {
+      rime::string expected(syllable);
+      uncached.Apply(&expected);
+      rime::string actual(syllable);
+      cached.Apply(&actual);
+      EXPECT_EQ(expected, actual);
+    }
+  }
+}
+
+static bool SameScript(const rime::Script& a, const rime::Script& b) {
+  if (a.size() != b.size())
+    return false;
+  for (auto i = a.begin(), j = b.begin(); i != a.end(); ++i, ++j) {
+    if (i->first != j->first || i->second.size() != j->second.size())
+      return false;
+    for (size_t k = 0; k < i->second.size(); ++k) {
+      const auto& x = i->second[k];
+      const auto& y = j->second[k];
+      if (x.str != y.str || x.properties.type != y.properties.type ||
+          x.properties.credibility != y.properties.credibility ||
+          x.properties.is_correction != y.properties.is_correction ||
+          x.properties.tips != y.properties.tips)
+        return false;
+    }
+  }
+  return true;
+}
+
+TEST(RimeAlgebraTest, ParallelProjection) {
+  rime::Script expected = rime::fixtures::MakeSyllabary();
+  rime::fixtures::ApplySerially(&expected);
+  rime::Projection p;
+  ASSERT_TRUE(p.Load(rime::fixtures::MakeRules(rime::fixtures::kHeavyAlgebra)));
+  for (int num_threads : {1, 4}) {
+    p.set_num_threads(num_threads);
+    rime::Script script = rime::fixtures::MakeSyllabary();
+    ASSERT_TRUE(p.Apply(&script));
+    EXPECT_TRUE(SameScript(expected, script));
+  }
+}
@@ -0,0 +1,91 @@
+//
+// Copyright RIME Developers
+// Distributed under the BSD License
+//
+#include <gtest/gtest.h>
+#include <rime/atom.h>
+#include <rime/context.h>
+#include <rime/segmentation.h>
+
+using namespace rime;
+
+TEST(RimeAtomTest, InternNames) {
+  AtomTable table;
+  EXPECT_EQ(AtomTable::kNone, table.Find("abc"));
+  Atom abc = table.Intern("abc");
+  Atom punct = table.Intern("punct");
+  EXPECT_EQ(0, abc);
+  EXPECT_EQ(1, punct);
+  EXPECT_EQ(abc, table.Intern("abc"));
+  EXPECT_EQ(punct, table.Find("punct"));
+  EXPECT_EQ("punct", table.NameOf(punct));
+  EXPECT_EQ(2, table.size());
+}
+
+TEST(RimeAtomTest, AtomSetBeyondOneWord) {
+  AtomSet a;
+  EXPECT_TRUE(a.empty());
+  EXPECT_TRUE(a.Insert(3));
+  EXPECT_FALSE(a.Insert(3));
+  EXPECT_TRUE(a.Insert(130));
+  EXPECT_TRUE(a.Contains(130));
+  EXPECT_FALSE(a.Contains(66));
+  EXPECT_EQ(2, a.size());
+  vector<Atom> atoms;
+  a.ForEach([&](Atom atom) { atoms.push_back(atom); });
+  EXPECT_EQ((vector<Atom>{3, 130}), atoms);
+  AtomSet b;
+  b.Insert(70);
+  EXPECT_FALSE(a.Intersects(b));
+  b.Insert(130);
+  EXPECT_TRUE(a.Intersects(b));
+  EXPECT_TRUE(a.Erase(130));
+  EXPECT_FALSE(a.Erase(130));
+  a.Merge(b);
+  EXPECT_EQ(3, a.size());
+  AtomSet c;
+  c.Insert(3);
+  c.Insert(70);
+  c.Insert(130);
+  EXPECT_EQ(a, c);
+}
+
+TEST(RimeAtomTest, SegmentTags) {
+  Segment segment;
+  segment.tags.insert("abc");
+  segment.tags.insert("punct");
+  EXPECT_TRUE(segment.HasTag("abc"));
+  EXPECT_TRUE(segment.HasTag(AtomTable::tags().Intern("punct")));
+  EXPECT_FALSE(segment.HasTag("never_seen_as_a_tag"));
+  EXPECT_EQ(0, segment.tags.erase("never_seen_as_a_tag"));
+  EXPECT_TRUE(segment.HasAnyTagIn(vector<string>{"raw", "abc"}));
+  EXPECT_TRUE(segment.HasAnyTagIn(TagSet{"raw", "abc"}));
+  EXPECT_FALSE(segment.HasAnyTagIn(TagSet{"raw"}));
+  set<string> names(segment.tags.begin(), segment.tags.end());
+  EXPECT_EQ((set<string>{"abc", "punct"}), names);
+  EXPECT_EQ(1, segment.tags.erase("punct"));
+  EXPECT_EQ(1, segment.tags.size());
+  segment.Clear();
+  EXPECT_TRUE(segment.tags.empty());
+}
+
+TEST(RimeAtomTest, ContextOptions) {
+  Context context;
+  vector<string> updates;
+  context.option_update_notifier().connect(
+      [&](Context*, const string& option) { updates.push_back(option); });
+  EXPECT_FALSE(context.get_option("ascii_mode"));
+  context.set_option("ascii_mode", true);
+  context.set_option("_linear", true);
+  context.set_option("full_shape", false);
+  EXPECT_TRUE(context.get_option("ascii_mode"));
+  EXPECT_TRUE(context.get_option(AtomTable::options().Intern("_linear")));
+  EXPECT_FALSE(context.get_option("full_shape"));
+  map<string, bool> expected{
+      {"ascii_mode", true}, {"_linear", true}, {"full_shape", false}};
+  EXPECT_EQ(expected, context.options());
+  EXPECT_EQ((vector<string>{"ascii_mode", "_linear", "full_shape"}), updates);
+  context.ClearTransientOptions();
+  EXPECT_FALSE(context.get_option("_linear"));
+  EXPECT_EQ(2, context.options().size());
+}
@@ -0,0 +1,93 @@
+//
+// Copyright RIME Developers
+// Distributed under the BSD License
+//
+#include <gtest/gtest.h>
+#include <rime_api.h>
+#include <rime/candidate.h>
+#include <rime/context.h>
+#include <rime/menu.h>
+#include <rime/service.h>
+#include <rime/translation.h>
+
+using namespace rime;
+
+class RimeContextApiTest : public ::testing::Test {
+ public:
+  void SetUp() override {
+    rime_ = rime_get_api();
+    session_id_ = rime_->create_session();
+    ASSERT_NE(0, session_id_);
+    Context* ctx = Service::instance().GetSession(session_id_)->context();
+    ctx->set_input("nihao");
+    ctx->composition().clear();
+    auto translation = New<FifoTranslation>();
+    for (int i = 0; i < 8; ++i) {
+      translation->Append(New<SimpleCandidate>(
+          "test", 0, 5, "候選" + std::to_string(i),
+          i % 2 ? "注釋" + std::to_string(i) : ""));
+    }
+    Segment segment(0, 5);
+    segment.menu = New<Menu>();
+    segment.menu->AddTranslation(translation);
+    ctx->composition().AddSegment(segment);
+  }
+  void TearDown() override { rime_->destroy_session(session_id_); }
+
+ protected:
+  RimeApi* rime_ = nullptr;
+  RimeSessionId session_id_ = 0;
+};
+
+TEST_F(RimeContextApiTest, SameAsGetContext) {
+  RIME_STRUCT(RimeContext, expected);
+  ASSERT_TRUE(rime_->get_context(session_id_, &expected));
+  ASSERT_EQ(5, expected.menu.num_candidates);
+
+  ASSERT_TRUE(RIME_API_AVAILABLE(rime_, get_context_in_buffer));
+  RIME_STRUCT(RimeContext, ctx);
+  size_t buffer_size = 0;
+  EXPECT_FALSE(
+      rime_->get_context_in_buffer(session_id_, &ctx, nullptr, &buffer_size));
+  EXPECT_LT(0, buffer_size);
+  vector<char> buffer(buffer_size);
+  ASSERT_TRUE(rime_->get_context_in_buffer(session_id_, &ctx, buffer.data(),
+                                           &buffer_size));
+  EXPECT_LE(buffer_size, buffer.size());
+
+  EXPECT_STREQ(expected.composition.preedit, ctx.composition.preedit);
+  EXPECT_EQ(expected.composition.length, ctx.composition.length);
+  EXPECT_EQ(expected.menu.page_size, ctx.menu.page_size);
+  EXPECT_EQ(expected.menu.is_last_page, ctx.menu.is_last_page);
+  ASSERT_EQ(expected.menu.num_candidates, ctx.menu.num_candidates);
+  for (int i = 0; i < ctx.menu.num_candidates; ++i) {
+    const auto& a = expected.menu.candidates[i];
+    const auto& b = ctx.menu.candidates[i];
+    EXPECT_STREQ(a.text, b.text);
+    if (a.comment) {
+      EXPECT_STREQ(a.comment, b.comment);
+    } else {
+      EXPECT_EQ(nullptr, b.comment);
+    }
+  }
+  rime_->free_context(&expected);
+}
+
+TEST_F(RimeContextApiTest, ReuseBuffer) {
+  RIME_STRUCT(RimeContext, ctx);
+  char small[16];
+  size_t buffer_size = sizeof(small);
+  EXPECT_FALSE(
+      rime_->get_context_in_buffer(session_id_, &ctx, small, &buffer_size));
+  EXPECT_EQ(0, ctx.menu.num_candidates);
+  vector<char> buffer(buffer_size);
+  for (int i = 0; i < 3; ++i) {
+    buffer_size = buffer.size();
+    ASSERT_TRUE(rime_->get_context_in_buffer(session_id_, &ctx, buffer.data(),
+                                             &buffer_size));
+    ASSERT_EQ(5, ctx.menu.num_candidates);
+    EXPECT_STREQ("候選4", ctx.menu.candidates[4].text);
+    EXPECT_TRUE(ctx.menu.candidates[0].text >= buffer.data() &&
+                ctx.menu.candidates[0].text < buffer.data() + buffer.size());
+  }
+}
@@ -10,6 +10,8 @@
 #include <rime/algo/syllabifier.h>
 #include <rime/dict/corrector.h>
 #include <rime/dict/prism.h>
+#include <rime/schema.h>
+#include <rime/ticket.h>
 #include <utility>
 
 class RimeCorrectorSearchTest : public ::testing::Test {
@@ -156,3 +158,143 @@ TEST_F(RimeCorrectorTest, CaseMultipleEdges1) {
   ASSERT_FALSE(sp2.end() == sp2.find(syllable_id_["jue"]));
   ASSERT_TRUE(sp2[syllable_id_["jue"]].type == rime::kNormalSpelling);
 }
+
+class RimeTypoIndexTest : public ::testing::Test {
+ public:
+  void SetUp() override {
+    rime::set<rime::string> keyset{
+        "a",    "ba",   "bai", "ban",   "bang", "chang", "da",   "de",
+        "ji",   "jie",  "ju",  "jue",   "ma",   "man",   "na",   "nan",
+        "shen", "shi",  "ta",  "tuan",  "wo",   "xian",  "zhe",  "zhong",
+        "zhuang", "zi", "zuo", "chuang", "shuang", "yan", "yang", "ni"};
+    rime::SyllableId id = 0;
+    for (const auto& syllable : keyset) {
+      syllable_id_[syllable] = id++;
+    }
+    prism_.reset(new rime::Prism(rime::path("typo_index_test.prism.bin")));
+    prism_->Build(keyset);
+    rime::TypoIndexCorrector typo_index(
+        rime::path("typo_index_test.correction.bin"));
+    typo_index.Remove();
+    ASSERT_TRUE(typo_index.Build(keyset) && typo_index.Save());
+    typo_index_.reset(new rime::TypoIndexCorrector(
+        rime::path("typo_index_test.correction.bin")));
+    ASSERT_TRUE(typo_index_->Load());
+  }
+
+ protected:
+  rime::map<rime::string, rime::SyllableId> syllable_id_;
+  rime::the<rime::Prism> prism_;
+  rime::the<rime::TypoIndexCorrector> typo_index_;
+};
+
+TEST_F(RimeTypoIndexTest, SameAsNearSearch) {
+  rime::NearSearchCorrector near_search;
+  for (rime::string key : {"chsng", "nan", "xisn", "zhomg", "xhusng", "bsmg",
+                           "wi", "shuamgyan", "mi"}) {
+    rime::corrector::Corrections expected;
+    near_search.ToleranceSearch(*prism_, key, &expected,
+                                rime::corrector::kMaxIndexedTypos);
+    rime::corrector::Corrections actual;
+    typo_index_->ToleranceSearch(*prism_, key, &actual,
+                                 rime::corrector::kDefaultTolerance);
+    for (const auto& c : actual) {
+      auto found = expected.find(c.first);
+      ASSERT_TRUE(found != expected.end()) << key << " " << c.first;
+      EXPECT_EQ(found->second.distance, c.second.distance) << key;
+      EXPECT_EQ(found->second.length, c.second.length) << key;
+    }
+    // the index only holds typos; exact matches are found in the prism.
+    // typos made through another spelling are pruned, and are always two.
+    for (const auto& c : expected) {
+      if (actual.find(c.first) == actual.end()) {
+        EXPECT_TRUE(c.second.distance == 0 || c.second.distance == 2)
+            << key << " " << c.first;
+      }
+    }
+  }
+  rime::corrector::Corrections close_only;
+  typo_index_->ToleranceSearch(*prism_, "xhusng", &close_only, 1);
+  EXPECT_TRUE(close_only.empty());
+}
+
+TEST_F(RimeTypoIndexTest, CorrectionSyllabify) {
+  rime::Syllabifier s;
+  s.EnableCorrection(typo_index_.get());
+  rime::SyllableGraph g;
+  const rime::string input("chabgtyan");
+  s.BuildSyllableGraph(input, *prism_, &g);
+  EXPECT_EQ(input.length(), g.interpreted_length);
+  rime::SpellingMap& sp1(g.edges[0][5]);
+  ASSERT_FALSE(sp1.end() == sp1.find(syllable_id_["chang"]));
+  EXPECT_TRUE(sp1[syllable_id_["chang"]].is_correction);
+  rime::SpellingMap& sp2(g.edges[5][9]);
+  ASSERT_FALSE(sp2.end() == sp2.find(syllable_id_["tuan"]));
+  EXPECT_TRUE(sp2[syllable_id_["tuan"]].is_correction);
+}
+
+TEST_F(RimeTypoIndexTest, PruneTyposThroughOtherSpellings) {
+  // "ns" is one typo off "na", but two off "ma" through "na".
+  rime::NearSearchCorrector near_search;
+  rime::corrector::Corrections expected;
+  near_search.ToleranceSearch(*prism_, "ns", &expected, 2);
+  ASSERT_FALSE(expected.end() == expected.find(syllable_id_["ma"]));
+  rime::corrector::Corrections actual;
+  typo_index_->ToleranceSearch(*prism_, "ns", &actual, 2);
+  ASSERT_FALSE(actual.end() == actual.find(syllable_id_["na"]));
+  EXPECT_EQ(1, actual[syllable_id_["na"]].distance);
+  EXPECT_TRUE(actual.end() == actual.find(syllable_id_["ma"]));
+}
+
+TEST(RimeCorrectorComponentTest, StaleTypoIndexFallsBackToNearSearch) {
+  // files are deployed to the staging directory, the working directory of
+  // tests.
+  rime::Syllabary syllabary{"chang", "tuan", "zhong"};
+  auto build = [&](uint32_t prism_checksum, uint32_t index_checksum) {
+    rime::Prism prism(rime::path("corrector_component_test.prism.bin"));
+    prism.Remove();
+    ASSERT_TRUE(prism.Build(syllabary, nullptr, 1, prism_checksum) &&
+                prism.Save());
+    rime::TypoIndexCorrector typo_index(
+        rime::path("corrector_component_test.correction.bin"));
+    typo_index.Remove();
+    ASSERT_TRUE(typo_index.Build(syllabary, nullptr, 1, index_checksum) &&
+                typo_index.Save());
+  };
+  rime::Schema schema("corrector_component_test");
+  schema.config()->SetString("translator/dictionary",
+                             "corrector_component_test");
+  rime::CorrectorComponent component;
+  rime::Ticket ticket(&schema, "translator");
+
+  build(2, 2);
+  rime::the<rime::Corrector> corrector(component.Create(ticket));
+  EXPECT_TRUE(dynamic_cast<rime::TypoIndexCorrector*>(corrector.get()));
+
+  build(2, 3);
+  corrector.reset(component.Create(ticket));
+  EXPECT_TRUE(dynamic_cast<rime::NearSearchCorrector*>(corrector.get()));
+  corrector.reset();
+
+  rime::Prism(rime::path("corrector_component_test.prism.bin")).Remove();
+  rime::TypoIndexCorrector(
+      rime::path("corrector_component_test.correction.bin"))
+      .Remove();
+}
+
+TEST(RimeKeyboardTypoCollectorTest, LimitTypos) {
+  rime::Syllabary spellings{"zhong"};
+  rime::KeyboardTypoCollector collector(spellings, spellings);
+  auto typos = collector.Collect(5);
+  ASSERT_FALSE(typos.empty());
+  for (const auto& typo : typos) {
+    ASSERT_EQ(5, typo.first.length());
+    size_t distance = 0;
+    for (size_t i = 0; i < typo.first.length(); ++i) {
+      distance += typo.first[i] != "zhong"[i];
+    }
+    EXPECT_GE(rime::corrector::kMaxIndexedTypos, distance) << typo.first;
+    ASSERT_EQ(1, typo.second.size());
+    EXPECT_EQ("zhong", typo.second[0].properties.tips);
+  }
+}
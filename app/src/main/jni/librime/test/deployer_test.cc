@@ -0,0 +1,105 @@
+//
+// Copyright RIME Developers
+// Distributed under the BSD License
+//
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <gtest/gtest.h>
+#include <rime/deployer.h>
+
+using namespace rime;
+
+namespace {
+
+class RecordingTask : public DeploymentTask {
+ public:
+  RecordingTask(int id, vector<int>* log, std::mutex* log_mutex,
+                bool result = true)
+      : id_(id), log_(log), log_mutex_(log_mutex), result_(result) {}
+
+  bool Run(Deployer* deployer) override {
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    std::lock_guard<std::mutex> lock(*log_mutex_);
+    log_->push_back(id_);
+    return result_;
+  }
+
+ private:
+  int id_;
+  vector<int>* log_;
+  std::mutex* log_mutex_;
+  bool result_;
+};
+
+class OutputTask : public DeploymentTask {
+ public:
+  OutputTask(std::atomic<int>* building, std::atomic<int>* overlaps)
+      : building_(building), overlaps_(overlaps) {}
+
+  bool Run(Deployer* deployer) override {
+    auto lock = deployer->LockOutput("dictionary/shared");
+    if (++*building_ > 1)
+      ++*overlaps_;
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    --*building_;
+    return true;
+  }
+
+ private:
+  std::atomic<int>* building_;
+  std::atomic<int>* overlaps_;
+};
+
+}  // namespace
+
+TEST(RimeDeployerTest, RunJobsAfterDependencies) {
+  Deployer deployer;
+  deployer.set_max_workers(4);
+  vector<int> log;
+  std::mutex log_mutex;
+  vector<DeploymentJob> jobs;
+  for (int i = 0; i < 8; ++i) {
+    jobs.push_back({New<RecordingTask>(i, &log, &log_mutex), {}});
+  }
+  jobs[5].dependencies = {1, 2};
+  jobs[7].dependencies = {5};
+  // jobs may only depend on earlier ones; this is ignored.
+  jobs[3].dependencies = {6};
+  EXPECT_TRUE(deployer.RunJobs(jobs));
+  ASSERT_EQ(8, log.size());
+  auto position = [&](int id) {
+    return std::find(log.begin(), log.end(), id) - log.begin();
+  };
+  EXPECT_LT(position(1), position(5));
+  EXPECT_LT(position(2), position(5));
+  EXPECT_LT(position(5), position(7));
+}
+
+TEST(RimeDeployerTest, RunJobsReportsFailure) {
+  Deployer deployer;
+  deployer.set_max_workers(2);
+  vector<int> log;
+  std::mutex log_mutex;
+  vector<DeploymentJob> jobs;
+  jobs.push_back({New<RecordingTask>(0, &log, &log_mutex, false), {}});
+  jobs.push_back({New<RecordingTask>(1, &log, &log_mutex), {0}});
+  EXPECT_FALSE(deployer.RunJobs(jobs));
+  // dependents still run after a failed job.
+  EXPECT_EQ(2, log.size());
+}
+
+TEST(RimeDeployerTest, SharedOutputIsBuiltOneAtATime) {
+  Deployer deployer;
+  deployer.set_max_workers(4);
+  std::atomic<int> building{0};
+  std::atomic<int> overlaps{0};
+  vector<DeploymentJob> jobs;
+  for (int i = 0; i < 6; ++i) {
+    jobs.push_back({New<OutputTask>(&building, &overlaps), {}});
+  }
+  EXPECT_TRUE(deployer.RunJobs(jobs));
+  EXPECT_EQ(0, overlaps);
+}
@@ -101,3 +101,36 @@ TEST_F(RimeDictionaryTest, ScriptLookup) {
   EXPECT_EQ(9, e3->text.length());
   EXPECT_FALSE(d7.Next());
 }
+
+TEST_F(RimeDictionaryTest, LatticeLookup) {
+  ASSERT_TRUE(dict_->loaded());
+  rime::SyllableGraph g;
+  rime::Syllabifier s;
+  rime::string input("shurufa");
+  ASSERT_TRUE(s.BuildSyllableGraph(input, *dict_->prism(), &g) > 0);
+  auto lattice = dict_->LookupLattice(g);
+  ASSERT_TRUE(bool(lattice));
+  for (const auto& edges : g.edges) {
+    size_t start = edges.first;
+    auto c = dict_->Lookup(g, start);
+    if (!c) {
+      EXPECT_TRUE(lattice->find(start) == lattice->end());
+      continue;
+    }
+    ASSERT_TRUE(lattice->find(start) != lattice->end());
+    auto& row = (*lattice)[start];
+    ASSERT_EQ(c->size(), row.size());
+    for (auto& x : *c) {
+      ASSERT_TRUE(row.find(x.first) != row.end());
+      rime::DictEntryIterator& expected(x.second);
+      rime::DictEntryIterator& actual(row[x.first]);
+      while (!expected.exhausted()) {
+        ASSERT_FALSE(actual.exhausted());
+        EXPECT_EQ(expected.Peek()->text, actual.Peek()->text);
+        expected.Next();
+        actual.Next();
+      }
+      EXPECT_TRUE(actual.exhausted());
+    }
+  }
+}
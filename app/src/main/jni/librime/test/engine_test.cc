@@ -0,0 +1,103 @@
+//
+// Copyright RIME Developers
+// Distributed under the BSD License
+//
+#include <gtest/gtest.h>
+#include <rime/candidate.h>
+#include <rime/common.h>
+#include <rime/component.h>
+#include <rime/composition.h>
+#include <rime/config.h>
+#include <rime/context.h>
+#include <rime/engine.h>
+#include <rime/menu.h>
+#include <rime/registry.h>
+#include <rime/schema.h>
+#include <rime/segmentation.h>
+#include <rime/translation.h>
+#include <rime/translator.h>
+#include <rime/dict/text_db.h>
+#include <rime/dict/user_db.h>
+
+using namespace rime;
+
+static int query_count = 0;
+
+class CountingTranslator : public Translator {
+ public:
+  explicit CountingTranslator(const Ticket& ticket) : Translator(ticket) {}
+
+  an<Translation> Query(const string& input, const Segment& segment) {
+    ++query_count;
+    auto translation = New<FifoTranslation>();
+    translation->Append(New<SimpleCandidate>("test", segment.start,
+                                             segment.end, "[" + input + "]"));
+    return translation;
+  }
+};
+
+class RimeEngineTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    Registry::instance().Register("counting_translator",
+                                  new Component<CountingTranslator>);
+    engine_.reset(Engine::Create());
+    auto* schema = new Schema("engine_test");
+    Config* config = schema->config();
+    ASSERT_TRUE(config != nullptr);
+    config->SetString("engine/segmentors/@next", "abc_segmentor");
+    config->SetString("engine/translators/@next", "counting_translator");
+    engine_->ApplySchema(schema);
+    query_count = 0;
+  }
+
+  void TearDown() override {
+    engine_.reset();
+    Registry::instance().Unregister("counting_translator");
+  }
+
+  the<Engine> engine_;
+};
+
+TEST_F(RimeEngineTest, ReuseTranslationOnCaretMove) {
+  Context* ctx = engine_->context();
+  ctx->PushInput("abc");
+  ASSERT_EQ(1, ctx->composition().size());
+  EXPECT_EQ("[abc]", ctx->composition().back().GetSelectedCandidate()->text());
+  int queries = query_count;
+  ctx->set_caret_pos(1);
+  EXPECT_GT(query_count, queries);
+  queries = query_count;
+  // back to where the segment was translated.
+  ctx->set_caret_pos(3);
+  EXPECT_EQ(queries, query_count);
+  ASSERT_EQ(1, ctx->composition().size());
+  EXPECT_EQ("[abc]", ctx->composition().back().GetSelectedCandidate()->text());
+}
+
+TEST_F(RimeEngineTest, InvalidateTranslationOnOptionUpdate) {
+  Context* ctx = engine_->context();
+  ctx->PushInput("abc");
+  ctx->set_caret_pos(1);
+  int queries = query_count;
+  ctx->set_option("engine_test", true);
+  ctx->set_caret_pos(3);
+  EXPECT_GT(query_count, queries);
+}
+
+TEST_F(RimeEngineTest, InvalidateTranslationOnUserDbUpdate) {
+  Context* ctx = engine_->context();
+  ctx->PushInput("abc");
+  ctx->set_caret_pos(1);
+  int queries = query_count;
+  // as another session sharing the user dictionary learns a word.
+  UserDbWrapper<TextDb> db(path{"engine_test.txt"}, "engine_test");
+  if (db.Exists())
+    db.Remove();
+  ASSERT_TRUE(db.Open());
+  EXPECT_TRUE(db.Update("abc ", "ABC"));
+  ctx->set_caret_pos(3);
+  EXPECT_GT(query_count, queries);
+  db.Close();
+  db.Remove();
+}
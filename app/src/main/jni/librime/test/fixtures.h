@@ -0,0 +1,366 @@
+//
+// Copyright RIME Developers
+// Distributed under the BSD License
+//
+// data and helpers shared by the tests and rime_bench, which times the code
+// paths that the tests check.
+//
+#ifndef RIME_TEST_FIXTURES_H_
+#define RIME_TEST_FIXTURES_H_
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <rime/candidate.h>
+#include <rime/common.h>
+#include <rime/config.h>
+#include <rime/deployer.h>
+#include <rime/translation.h>
+#include <rime/algo/algebra.h>
+#include <rime/algo/calculus.h>
+#include <rime/dict/level_db.h>
+#include <rime/dict/reverse_lookup_dictionary.h>
+#include <rime/dict/table.h>
+#include <rime/dict/user_db.h>
+#include <rime/gear/recognizer.h>
+#include <rime/lever/user_dict_manager.h>
+#ifdef __linux__
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace rime::fixtures {
+
+// simplifier
+
+inline const char* const kTraditional[] = {
+    "\xe9\xab\x94",  // 體
+    "\xe6\x9b\xb8",  // 書
+    "\xe9\x9b\xbb",  // 電
+    "\xe8\x85\xa6",  // 腦
+    "\xe8\xaa\x9e",  // 語
+    "\xe8\xa8\x80",  // 言
+};
+inline const char* const kSimplified[] = {
+    "\xe4\xbd\x93",  // 体
+    "\xe4\xb9\xa6",  // 书
+    "\xe7\x94\xb5",  // 电
+    "\xe8\x84\x91",  // 脑
+    "\xe8\xaf\xad",  // 语
+    "\xe8\xa8\x80",  // 言
+};
+inline constexpr size_t kNumChars = std::size(kTraditional);
+
+// writes opencc/<name>.json, which converts all characters but the last.
+inline void WriteOpenccConfig(const string& name) {
+  std::filesystem::create_directories("opencc");
+  {
+    std::ofstream dict("opencc/" + name + ".txt");
+    for (size_t i = 0; i + 1 < kNumChars; ++i) {
+      dict << kTraditional[i] << '\t' << kSimplified[i] << '\n';
+    }
+  }
+  std::ofstream config("opencc/" + name + ".json");
+  config << R"({
+  "name": ")" << name << R"(",
+  "segmentation": {
+    "type": "mmseg",
+    "dict": { "type": "text", "file": ")" << name << R"(.txt" }
+  },
+  "conversion_chain": [{
+    "dict": { "type": "text", "file": ")" << name << R"(.txt" }
+  }]
+})";
+}
+
+// a page of 100 candidates, each of two traditional characters.
+inline an<Translation> MakeTraditionalTranslation() {
+  auto translation = New<FifoTranslation>();
+  for (size_t i = 0; i < 100; ++i) {
+    string text = kTraditional[i % kNumChars];
+    text += kTraditional[(i / kNumChars) % kNumChars];
+    translation->Append(New<SimpleCandidate>("test", 0, 2, text));
+  }
+  return translation;
+}
+
+// spelling algebra
+
+// the comment format of a pinyin schema showing tone marks.
+inline const char* const kToneMarks[] = {
+    "xform/([aeiou])(ng?|r)([1234])/$1$3$2/",
+    "xform/([aeo])([iuo])([1234])/$1$3$2/",
+    "xform/a1/ā/", "xform/a2/á/", "xform/a3/ǎ/", "xform/a4/à/",
+    "xform/e1/ē/", "xform/e2/é/", "xform/e3/ě/", "xform/e4/è/",
+    "xform/o1/ō/", "xform/o2/ó/", "xform/o3/ǒ/", "xform/o4/ò/",
+    "xform/i1/ī/", "xform/i2/í/", "xform/i3/ǐ/", "xform/i4/ì/",
+    "xform/u1/ū/", "xform/u2/ú/", "xform/u3/ǔ/", "xform/u4/ù/",
+    "xform/v1/ǖ/", "xform/v2/ǘ/", "xform/v3/ǚ/", "xform/v4/ǜ/",
+    "xform/([nl])v/$1ü/", "xform/([nl])ue/$1üe/", "xform/v/u/",
+    "xform/([aeiou])5/$1/",
+};
+
+// fuzzy pinyin, abbreviations and common typos; 40 rules in all.
+inline const char* const kHeavyAlgebra[] = {
+    "erase/^xx$/",
+    "xform/^([a-z]+)\\d$/$1/",
+    "derive/^([zcs])h/$1/",
+    "derive/^([zcs])([^h])/$1h$2/",
+    "derive/^n/l/",
+    "derive/^l/n/",
+    "derive/^r/l/",
+    "derive/^f/h/",
+    "derive/^h/f/",
+    "derive/([ei])n$/$1ng/",
+    "derive/([ei])ng$/$1n/",
+    "derive/ang$/an/",
+    "derive/an$/ang/",
+    "derive/uang$/uan/",
+    "derive/uan$/uang/",
+    "derive/ian$/iang/",
+    "derive/iang$/ian/",
+    "derive/ong$/eng/",
+    "derive/^([jqxy])u$/$1v/",
+    "derive/^([nl])ve$/$1ue/",
+    "derive/^([aoe])([ioun])$/$1$1$2/",
+    "derive/^([zcs])h(.+)$/$1$2/fuzz",
+    "derive/iu$/iou/",
+    "derive/ui$/uei/",
+    "derive/un$/uen/",
+    "derive/([aeiou])ng$/$1gn/correction",
+    "derive/([dtngkhrzcs])o(u|ng)$/$1o/",
+    "derive/ong$/on/",
+    "derive/ao$/oa/correction",
+    "derive/ui$/iu/correction",
+    "derive/ie$/ei/correction",
+    "derive/^w/v/",
+    "derive/^y/i/",
+    "abbrev/^([a-z]).+$/$1/",
+    "abbrev/^([zcs]h).+$/$1/",
+    "derive/^([a-z]{2,}?)i$/$1y/",
+    "derive/^g/k/",
+    "derive/^k/g/",
+    "xlit/v/u/",
+    "erase/^.{8,}$/",
+};
+
+template <size_t N>
+an<ConfigList> MakeRules(const char* const (&rules)[N]) {
+  auto c = New<ConfigList>();
+  for (const char* rule : rules) {
+    c->Append(New<ConfigValue>(rule));
+  }
+  return c;
+}
+
+// pinyin syllables with tones 1 to 5.
+inline Script MakeSyllabary() {
+  const char* initials[] = {"",  "b",  "p",  "m",  "f", "d", "t", "n",
+                            "l", "g",  "k",  "h",  "j", "q", "x", "zh",
+                            "ch", "sh", "r", "z",  "c", "s", "y", "w"};
+  const char* finals[] = {"a",   "o",    "e",    "i",   "u",    "v",
+                          "ai",  "ei",   "ao",   "ou",  "an",   "en",
+                          "ang", "eng",  "ong",  "ia",  "ie",   "iao",
+                          "iu",  "ian",  "in",   "iang", "ing", "iong",
+                          "ua",  "uo",   "uai",  "ui",  "uan",  "un",
+                          "uang", "ve",  "er"};
+  Script script;
+  for (const char* initial : initials) {
+    for (const char* final : finals) {
+      for (int tone = 1; tone <= 5; ++tone) {
+        script.AddSyllable(string(initial) + final + std::to_string(tone));
+      }
+    }
+  }
+  return script;
+}
+
+// applies kHeavyAlgebra one spelling after another, with Script::Merge().
+inline void ApplySerially(Script* script) {
+  Calculus calculus;
+  for (const char* rule : kHeavyAlgebra) {
+    the<Calculation> x(calculus.Parse(rule));
+    Script temp;
+    for (const auto& v : *script) {
+      Spelling s(v.first);
+      if (x->Apply(&s)) {
+        if (!x->deletion())
+          temp.Merge(v.first, SpellingProperties(), v.second);
+        if (x->addition() && !s.str.empty())
+          temp.Merge(s.str, s.properties, v.second);
+      } else {
+        temp.Merge(v.first, SpellingProperties(), v.second);
+      }
+    }
+    script->swap(temp);
+  }
+}
+
+// recognizer
+
+// the patterns of a schema with a few reverse lookups and symbol inputs.
+inline const char* const kRecognizerPatterns[][2] = {
+    {"email", "^[A-Za-z][-_.0-9A-Za-z]*@.*$"},
+    {"uppercase", "[A-Z][-_+.'0-9A-Za-z]*$"},
+    {"url", "^(www[.]|https?:|ftp[.:]|mailto:|file:).*$|^[a-z]+[.].+$"},
+    {"punct", "^/([0-9]0?|[A-Za-z]+)$"},
+    {"reverse_lookup", "`[a-z]*'?$"},
+    {"number", "^[-+]?[0-9][.:0-9]*[%]?$"},
+    {"stroke", "^x[hspnz]*$"},
+    {"cangjie", "^v[a-z]*$"},
+    {"repeat", "^(z)\\1+$"},
+};
+
+// adds the patterns without compiling them.
+inline void LoadRecognizerPatterns(RecognizerPatterns* patterns) {
+  for (const auto& pattern : kRecognizerPatterns) {
+    (*patterns)[pattern[0]] = boost::regex(pattern[1]);
+  }
+}
+
+// reverse lookup
+
+// builds, saves and loads a reverse db of five characters.
+inline bool BuildReverseDb(ReverseDb* db) {
+  Syllabary syllabary{"hao", "ni", "zhong"};
+  Vocabulary vocabulary;
+  auto add_entry = [&](int syllable_id, const string& text) {
+    auto entry = New<ShortDictEntry>();
+    entry->text = text;
+    entry->code.push_back(syllable_id);
+    vocabulary[syllable_id].entries.push_back(entry);
+  };
+  // syllable ids follow the order of the syllabary.
+  add_entry(0, "好");
+  add_entry(1, "你");
+  add_entry(1, "尼");
+  add_entry(2, "中");
+  add_entry(2, "种");
+  ReverseLookupTable stems;
+  return db->Build(nullptr, syllabary, vocabulary, stems, 0) && db->Save() &&
+         db->Load();
+}
+
+// table
+
+// builds and saves a table of random words, many to a syllable.
+inline bool BuildRandomTable(Table* table,
+                             int num_syllables,
+                             int entries_per_syllable) {
+  Syllabary syllabary;
+  Vocabulary vocabulary;
+  std::mt19937 random(42);
+  for (int i = 0; i < num_syllables; ++i) {
+    syllabary.insert("s" + std::to_string(1000 + i));
+    for (int j = 0; j < entries_per_syllable; ++j) {
+      auto e = New<ShortDictEntry>();
+      e->code.push_back(i);
+      // few distinct texts: the string table, read in whole on loading,
+      // is a small part of the file.
+      e->text = "w" + std::to_string(random() % 1000);
+      e->weight = 1.0 / (j + 1);
+      vocabulary[i].entries.push_back(e);
+    }
+  }
+  return table->Build(syllabary, vocabulary,
+                      num_syllables * entries_per_syllable) &&
+         table->Save();
+}
+
+#ifdef __linux__
+// drops pages of the file from the page cache, as after a reboot.
+inline bool EvictFromPageCache(const path& file_path) {
+  int fd = open(file_path.c_str(), O_RDONLY);
+  if (fd == -1)
+    return false;
+  fdatasync(fd);
+  posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+  close(fd);
+  return true;
+}
+#endif  // __linux__
+
+// user dict sync
+
+// keeps the user dbs of a device in a directory of its own.
+class DeviceUserDbComponent : public UserDb::Component {
+ public:
+  explicit DeviceUserDbComponent(const path& dir) : dir_(dir) {}
+  Db* Create(const string& name) override {
+    return new UserDbWrapper<LevelDb>(dir_ / (name + extension()), name);
+  }
+  string extension() const override { return ".userdb"; }
+
+ private:
+  path dir_;
+};
+
+class DeviceUserDictManager : public UserDictManager {
+ public:
+  DeviceUserDictManager(Deployer* deployer, UserDb::Component* component)
+      : UserDictManager(deployer) {
+    user_db_component_ = component;
+  }
+};
+
+// a device that shares the sync directory under |dir| with the others.
+class Device {
+ public:
+  Device(const path& dir, const string& dict_name, const string& user_id)
+      : dict_name_(dict_name),
+        component_(dir / user_id),
+        manager_(&deployer_, &component_) {
+    deployer_.user_data_dir = dir / user_id;
+    deployer_.sync_dir = dir / "sync";
+    deployer_.user_id = user_id;
+    std::filesystem::create_directories(deployer_.user_data_dir);
+  }
+
+  // learns words as a user dictionary does.
+  bool Learn(const vector<string>& keys) {
+    the<Db> db(component_.Create(dict_name_));
+    if (!db->Open())
+      return false;
+    auto* change_log = dynamic_cast<ChangeLog*>(db.get());
+    if (!change_log)
+      return false;
+    for (const auto& key : keys) {
+      UserDbValue v;
+      v.commits = 1;
+      v.dee = 1.0;
+      v.tick = ++tick_;
+      if (!db->Update(key, v.Pack()))
+        return false;
+      change_log->LogChange(key);
+    }
+    db->MetaUpdate("/tick", std::to_string(tick_));
+    return db->Close();
+  }
+
+  bool Knows(const string& key) {
+    the<Db> db(component_.Create(dict_name_));
+    string value;
+    return db->OpenReadOnly() && db->Fetch(key, &value);
+  }
+
+  bool Sync() { return manager_.Synchronize(dict_name_); }
+
+  map<string, string> Header(const string& extension) {
+    map<string, string> metadata;
+    UserDbHelper::ReadSnapshotMetadata(
+        deployer_.user_data_sync_dir() / (dict_name_ + extension), &metadata);
+    return metadata;
+  }
+
+ private:
+  string dict_name_;
+  Deployer deployer_;
+  DeviceUserDbComponent component_;
+  DeviceUserDictManager manager_;
+  TickCount tick_ = 0;
+};
+
+}  // namespace rime::fixtures
+
+#endif  // RIME_TEST_FIXTURES_H_
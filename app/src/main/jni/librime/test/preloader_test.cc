@@ -0,0 +1,143 @@
+//
+// Copyright RIME Developers
+// Distributed under the BSD License
+//
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <thread>
+#include <gtest/gtest.h>
+#include <rime/candidate.h>
+#include <rime/config.h>
+#include <rime/context.h>
+#include <rime/engine.h>
+#include <rime/preloader.h>
+#include <rime/schema.h>
+#include <rime/service.h>
+#include <rime/ticket.h>
+#include <rime/dict/dictionary.h>
+#include <rime/dict/prism.h>
+#include <rime/dict/table.h>
+
+using namespace rime;
+
+#ifndef RIME_NO_THREADING
+
+namespace {
+
+struct CountingResource {
+  std::atomic<int> loads{0};
+  bool Load() {
+    ++loads;
+    return true;
+  }
+};
+
+}  // namespace
+
+TEST(RimePreloaderTest, RunTasksInOrder) {
+  Preloader preloader;
+  vector<int> order;
+  for (int i = 0; i < 3; ++i) {
+    preloader.Post([&order, i] { order.push_back(i); });
+  }
+  preloader.Flush();
+  EXPECT_EQ((vector<int>{0, 1, 2}), order);
+}
+
+TEST(RimePreloaderTest, LoadWhileHeld) {
+  Preloader preloader;
+  std::promise<void> go;
+  auto blocked = go.get_future().share();
+  preloader.Post([blocked] { blocked.wait(); });
+  auto held = New<CountingResource>();
+  auto released = New<CountingResource>();
+  auto handle = preloader.Load(held);
+  weak<CountingResource> weak_released = released;
+  preloader.Load(std::move(released));
+  go.set_value();
+  preloader.Flush();
+  EXPECT_EQ(1, held->loads);
+  // nobody wanted it any more by the time the loader got to it.
+  EXPECT_TRUE(weak_released.expired());
+}
+
+TEST(RimePreloaderTest, CancelPendingTasks) {
+  Preloader preloader;
+  std::promise<void> go;
+  auto blocked = go.get_future().share();
+  std::atomic<int> done{0};
+  preloader.Post([blocked, &done] {
+    blocked.wait();
+    ++done;
+  });
+  preloader.Post([&done] { ++done; });
+  std::thread release([&go] {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    go.set_value();
+  });
+  preloader.Cancel();
+  release.join();
+  preloader.Flush();
+  EXPECT_GE(1, done);
+}
+
+TEST(RimePreloaderTest, EngineLoadsDictionaryAtFirstQuery) {
+  const string dict_name("preloader_test");
+  {
+    Syllabary syllabary{"a"};
+    Vocabulary vocabulary;
+    auto e = New<ShortDictEntry>();
+    e->code.push_back(0);
+    e->text = "a1";
+    e->weight = 1.0;
+    vocabulary[0].entries.push_back(e);
+    Table table(path(dict_name + ".table.bin"));
+    table.Remove();
+    ASSERT_TRUE(table.Build(syllabary, vocabulary, 1));
+    ASSERT_TRUE(table.Save());
+    Prism prism(path(dict_name + ".prism.bin"));
+    prism.Remove();
+    ASSERT_TRUE(prism.Build(syllabary));
+    ASSERT_TRUE(prism.Save());
+  }
+  // keeps the loader busy until the first key is handled.
+  Preloader& preloader(Service::instance().preloader());
+  std::promise<void> go;
+  auto blocked = go.get_future().share();
+  preloader.Post([blocked] { blocked.wait(); });
+
+  the<Engine> engine(Engine::Create());
+  auto* schema = new Schema("preloader_test");
+  Config* config = schema->config();
+  config->SetString("engine/segmentors/@next", "abc_segmentor");
+  config->SetString("engine/translators/@next", "table_translator");
+  config->SetString("translator/dictionary", dict_name);
+  config->SetBool("translator/enable_user_dict", false);
+  engine->ApplySchema(schema);
+
+  auto* dictionary = Dictionary::Require("dictionary");
+  ASSERT_TRUE(dictionary);
+  // shares its files with the translator's dictionary.
+  the<Dictionary> dict(dictionary->Create(Ticket(engine.get(), "translator")));
+  ASSERT_TRUE(dict);
+  // the engine thread left loading to the preloader.
+  EXPECT_FALSE(dict->loaded());
+
+  Context* ctx = engine->context();
+  ctx->PushInput("a");
+  // the first query did not wait for the preloader.
+  EXPECT_TRUE(dict->loaded());
+  auto cand = ctx->GetSelectedCandidate();
+  ASSERT_TRUE(cand);
+  EXPECT_EQ("a1", cand->text());
+
+  go.set_value();
+  preloader.Flush();
+  dict.reset();
+  engine.reset();
+  Table(path(dict_name + ".table.bin")).Remove();
+  Prism(path(dict_name + ".prism.bin")).Remove();
+}
+
+#endif  // RIME_NO_THREADING
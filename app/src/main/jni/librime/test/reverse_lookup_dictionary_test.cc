@@ -0,0 +1,62 @@
+//
+// Copyright RIME Developers
+// Distributed under the BSD License
+//
+#include <gtest/gtest.h>
+#include <rime/config.h>
+#include <rime/algo/algebra.h>
+#include <rime/dict/reverse_lookup_dictionary.h>
+#include "fixtures.h"
+
+using namespace rime;
+
+class RimeReverseLookupDictionaryTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    db_ = New<ReverseDb>(path{"reverse_lookup_dictionary_test.reverse.bin"});
+    ASSERT_TRUE(fixtures::BuildReverseDb(db_.get()));
+  }
+
+  void TearDown() override {
+    db_->Close();
+    db_->Remove();
+  }
+
+  an<ReverseDb> db_;
+};
+
+TEST_F(RimeReverseLookupDictionaryTest, BatchedLookup) {
+  vector<string> texts{"中", "你", "?", "好", ""};
+  vector<string> results;
+  EXPECT_EQ(3, db_->Lookup(texts, &results));
+  ASSERT_EQ(texts.size(), results.size());
+  for (size_t i = 0; i < texts.size(); ++i) {
+    string expected;
+    db_->Lookup(texts[i], &expected);
+    EXPECT_EQ(expected, results[i]) << texts[i];
+  }
+  EXPECT_EQ("zhong", results[0]);
+  EXPECT_EQ("", results[2]);
+}
+
+TEST_F(RimeReverseLookupDictionaryTest, CachedFormattedLookup) {
+  an<ConfigList> rules = New<ConfigList>();
+  rules->Append(New<ConfigValue>("xform/^(.)/$1:/"));
+  Projection formatter;
+  ASSERT_TRUE(formatter.Load(rules));
+  ReverseLookupDictionary dict(db_);
+  ASSERT_TRUE(dict.Load());
+  string result;
+  EXPECT_TRUE(dict.ReverseLookup("中", &formatter, &result));
+  EXPECT_EQ("z:hong", result);
+  EXPECT_TRUE(dict.ReverseLookup("中", &formatter, &result));
+  EXPECT_EQ("z:hong", result);
+  EXPECT_FALSE(dict.ReverseLookup("?", &formatter, &result));
+  EXPECT_EQ("", result);
+  EXPECT_EQ(1, dict.cache().hits());
+  EXPECT_EQ(2, dict.cache().size());
+  // results formatted by another projection are not reused.
+  EXPECT_TRUE(dict.ReverseLookup("中", nullptr, &result));
+  EXPECT_EQ("zhong", result);
+  EXPECT_EQ(1, dict.cache().size());
+}
@@ -0,0 +1,43 @@
+//
+// Copyright RIME Developers
+// Distributed under the BSD License
+//
+#include <gtest/gtest.h>
+#include <rime/algo/ring_buffer.h>
+
+using namespace rime;
+
+TEST(RimeRingBufferTest, PushAndPopInOrder) {
+  RingBuffer<string> queue(3);
+  EXPECT_EQ(4, queue.capacity());
+  EXPECT_TRUE(queue.empty());
+  string value;
+  EXPECT_FALSE(queue.TryPop(&value));
+  for (int lap = 0; lap < 3; ++lap) {
+    for (int i = 0; i < 4; ++i) {
+      EXPECT_TRUE(queue.TryPush(std::to_string(i)));
+    }
+    for (int i = 0; i < 4; ++i) {
+      ASSERT_TRUE(queue.TryPop(&value));
+      EXPECT_EQ(std::to_string(i), value);
+    }
+    EXPECT_TRUE(queue.empty());
+  }
+}
+
+TEST(RimeRingBufferTest, FailedPushKeepsValue) {
+  RingBuffer<string> queue(2);
+  EXPECT_TRUE(queue.TryPush(string("a")));
+  EXPECT_TRUE(queue.TryPush(string("b")));
+  string value("c");
+  EXPECT_FALSE(queue.TryPush(std::move(value)));
+  EXPECT_EQ("c", value);
+  string popped;
+  ASSERT_TRUE(queue.TryPop(&popped));
+  EXPECT_EQ("a", popped);
+  EXPECT_TRUE(queue.TryPush(std::move(value)));
+  ASSERT_TRUE(queue.TryPop(&popped));
+  EXPECT_EQ("b", popped);
+  ASSERT_TRUE(queue.TryPop(&popped));
+  EXPECT_EQ("c", popped);
+}
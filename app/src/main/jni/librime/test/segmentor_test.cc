@@ -10,6 +10,8 @@
 #include <rime/engine.h>
 #include <rime/segmentation.h>
 #include <rime/segmentor.h>
+#include <rime/gear/recognizer.h>
+#include "fixtures.h"
 
 using namespace rime;
 
@@ -60,3 +62,53 @@ TEST(AbcSegmentorTest, PrefixMatch) {
   EXPECT_EQ(7, segmentation[0].end);
   EXPECT_GE(1U, segmentation[0].tags.size());
 }
+
+static const char* kRecognizerInputs[] = {
+    "nihao", "zhongguoren", "Hello", "ni`hao", "`abc'", "/12", "/abc",
+    "www.rime.im", "a@b.c", "3.14%", "xhspn", "vabc", "zzz", "xhsa", "",
+};
+
+// searches with every pattern in turn, as RecognizerPatterns did before.
+static RecognizerMatch MatchOneByOne(const RecognizerPatterns& patterns,
+                                     const string& input,
+                                     const Segmentation& segmentation) {
+  size_t j = segmentation.GetCurrentEndPosition();
+  size_t k = segmentation.GetConfirmedPosition();
+  string active_input = input.substr(k);
+  for (const auto& v : patterns) {
+    boost::smatch m;
+    if (boost::regex_search(active_input, m, v.second)) {
+      size_t start = k + m.position();
+      size_t end = start + m.length();
+      if (end != input.length())
+        continue;
+      if (start == j)
+        return {v.first, start, end};
+      for (const Segment& seg : segmentation) {
+        if (start < seg.start)
+          break;
+        if (start == seg.start)
+          return {v.first, start, end};
+      }
+    }
+  }
+  return RecognizerMatch();
+}
+
+TEST(RecognizerPatternsTest, CombinedMatch) {
+  RecognizerPatterns patterns;
+  fixtures::LoadRecognizerPatterns(&patterns);
+  patterns.Compile();
+  for (const char* input : kRecognizerInputs) {
+    Segmentation segmentation;
+    segmentation.Reset(input);
+    auto expected = MatchOneByOne(patterns, input, segmentation);
+    auto match = patterns.GetMatch(input, segmentation);
+    EXPECT_EQ(expected.tag, match.tag) << input;
+    EXPECT_EQ(expected.start, match.start) << input;
+    EXPECT_EQ(expected.end, match.end) << input;
+  }
+  Segmentation segmentation;
+  segmentation.Reset("zzz");
+  EXPECT_EQ("repeat", patterns.GetMatch("zzz", segmentation).tag);
+}
@@ -0,0 +1,194 @@
+//
+// Copyright RIME Developers
+// Distributed under the BSD License
+//
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <thread>
+#include <gtest/gtest.h>
+#include <rime_api.h>
+#include <rime/context.h>
+#include <rime/service.h>
+
+using namespace rime;
+
+TEST(RimeServiceTest, ConcurrentSessions) {
+  Service& service = Service::instance();
+  service.StartService();
+  const int kThreads = 8;
+  const int kSessionsPerThread = 4;
+  std::atomic<int> found{0};
+  std::atomic<int> destroyed{0};
+  vector<std::thread> threads;
+  for (int i = 0; i < kThreads; ++i) {
+    threads.emplace_back([&] {
+      vector<SessionId> ids;
+      for (int j = 0; j < kSessionsPerThread; ++j) {
+        ids.push_back(service.CreateSession());
+      }
+      for (SessionId id : ids) {
+        if (auto session = service.LockSession(id)) {
+          session->ResetCommitText();
+          ++found;
+        }
+        service.CleanupStaleSessions();
+      }
+      for (SessionId id : ids) {
+        destroyed += service.DestroySession(id);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(kThreads * kSessionsPerThread, found);
+  EXPECT_EQ(kThreads * kSessionsPerThread, destroyed);
+  service.StopService();
+}
+
+TEST(RimeServiceTest, SessionsTakeTurnsOnSharedComponents) {
+  Service& service = Service::instance();
+  service.StartService();
+  SessionId a = service.CreateSession();
+  SessionId b = service.CreateSession();
+  std::atomic<bool> entered{false};
+  std::thread other;
+  {
+    auto session = service.LockSession(a);
+    ASSERT_TRUE(bool(session));
+    other = std::thread([&] {
+      if (auto session = service.LockSession(b))
+        entered = true;
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_FALSE(entered);
+  }
+  other.join();
+  EXPECT_TRUE(entered);
+  service.DestroySession(a);
+  service.DestroySession(b);
+  service.StopService();
+}
+
+TEST(RimeServiceTest, InputOutlivesEditsOnOtherThreads) {
+  RimeApi* rime = rime_get_api();
+  Service::instance().StartService();
+  RimeSessionId session_id = rime->create_session();
+  ASSERT_NE(0, session_id);
+  ASSERT_TRUE(rime->set_input(session_id, "abc"));
+  const char* input = rime->get_input(session_id);
+  ASSERT_TRUE(input);
+  std::thread editor([&] { rime->set_input(session_id, "xyz"); });
+  editor.join();
+  EXPECT_STREQ("abc", input);
+  EXPECT_STREQ("xyz", rime->get_input(session_id));
+  rime->destroy_session(session_id);
+}
+
+TEST(RimeServiceTest, AsyncNotificationsCoalesceOptionUpdates) {
+  Service& service = Service::instance();
+  std::mutex mutex;
+  std::condition_variable cv;
+  bool entered = false;
+  bool released = false;
+  vector<string> received;
+  service.SetNotificationHandler(
+      [&](SessionId, const char* type, const char* value) {
+        std::unique_lock<std::mutex> lock(mutex);
+        received.push_back(string(type) + ":" + value);
+        entered = true;
+        cv.notify_all();
+        cv.wait(lock, [&] { return released; });
+      });
+  service.set_async_notifications(true);
+  service.Notify(1, "schema", "luna_pinyin/朙月拼音");
+  {
+    // the handler is busy with the first message while the others queue up.
+    std::unique_lock<std::mutex> lock(mutex);
+    cv.wait(lock, [&] { return entered; });
+  }
+  service.Notify(1, "option", "ascii_mode");
+  service.Notify(1, "option", "!ascii_mode");
+  service.Notify(2, "option", "ascii_mode");
+  service.Notify(1, "property", "client_type=x");
+  service.Notify(1, "option", "ascii_mode");
+  service.Notify(1, "property", "client_type=y");
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    released = true;
+  }
+  cv.notify_all();
+  // delivers all pending notifications.
+  service.set_async_notifications(false);
+  service.ClearNotificationHandler();
+  vector<string> expected{"schema:luna_pinyin/朙月拼音", "option:ascii_mode",
+                          "option:ascii_mode", "property:client_type=y"};
+  EXPECT_EQ(expected, received);
+}
+
+TEST(RimeServiceTest, FullNotificationQueueDropsMessages) {
+  Service& service = Service::instance();
+  std::mutex mutex;
+  std::condition_variable cv;
+  bool entered = false;
+  bool released = false;
+  vector<pair<string, string>> received;
+  service.SetNotificationHandler(
+      [&](SessionId, const char* type, const char* value) {
+        std::unique_lock<std::mutex> lock(mutex);
+        received.emplace_back(type, value);
+        if (!entered) {
+          entered = true;
+          cv.notify_all();
+          cv.wait(lock, [&] { return released; });
+        }
+      });
+  service.set_async_notifications(true);
+  service.Notify(1, "schema", "luna_pinyin/朙月拼音");
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    cv.wait(lock, [&] { return entered; });
+  }
+  const size_t dropped = service.dropped_notifications();
+  const int kUpdates = Service::kNotificationQueueSize;
+  // the handler is busy; the queue fills up with the first half, and the
+  // rest is dropped without waiting.
+  for (int i = 0; i < kUpdates; ++i) {
+    service.Notify(1, "option", i % 2 == 0 ? "ascii_mode" : "!ascii_mode");
+    service.Notify(1, "property", "client_type=" + std::to_string(i));
+  }
+  EXPECT_EQ(dropped + Service::kNotificationQueueSize,
+            service.dropped_notifications());
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    released = true;
+  }
+  cv.notify_all();
+  service.set_async_notifications(false);
+  service.ClearNotificationHandler();
+
+  const int last_queued = kUpdates / 2 - 1;
+  vector<pair<string, string>> expected{
+      {"schema", "luna_pinyin/朙月拼音"},
+      {"option", "!ascii_mode"},
+      {"property", "client_type=" + std::to_string(last_queued)}};
+  EXPECT_EQ(expected, received);
+}
+
+TEST(RimeServiceTest, StopServiceStopsNotificationDispatcher) {
+  Service& service = Service::instance();
+  service.StartService();
+  int delivered = 0;
+  service.SetNotificationHandler(
+      [&](SessionId, const char*, const char*) { ++delivered; });
+  service.set_async_notifications(true);
+  service.Notify(1, "option", "ascii_mode");
+  service.StopService();
+  // what was queued is delivered, and the dispatcher is not restarted.
+  EXPECT_EQ(1, delivered);
+  EXPECT_FALSE(service.async_notifications());
+  service.Notify(1, "option", "!ascii_mode");
+  EXPECT_EQ(2, delivered);
+  service.ClearNotificationHandler();
+}
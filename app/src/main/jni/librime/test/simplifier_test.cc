@@ -0,0 +1,75 @@
+//
+// Copyright RIME Developers
+// Distributed under the BSD License
+//
+#include <gtest/gtest.h>
+#include <rime/candidate.h>
+#include <rime/common.h>
+#include <rime/config.h>
+#include <rime/context.h>
+#include <rime/engine.h>
+#include <rime/filter.h>
+#include <rime/schema.h>
+#include <rime/ticket.h>
+#include <rime/translation.h>
+#include "fixtures.h"
+
+using namespace rime;
+
+using fixtures::kNumChars;
+using fixtures::kSimplified;
+using fixtures::kTraditional;
+
+class RimeSimplifierTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    fixtures::WriteOpenccConfig("simplifier_test");
+    engine_.reset(Engine::Create());
+    engine_->schema()->config()->SetString("simplifier/opencc_config",
+                                           "simplifier_test.json");
+    engine_->context()->set_option("simplification", true);
+    auto* component = Filter::Require("simplifier");
+    ASSERT_TRUE(component != nullptr);
+    filter_.reset(component->Create(Ticket(engine_.get(), "simplifier")));
+    ASSERT_TRUE(bool(filter_));
+  }
+
+  size_t PageThrough(const an<Translation>& translation,
+                     vector<string>* texts) {
+    size_t count = 0;
+    while (auto cand = translation->Peek()) {
+      if (texts)
+        texts->push_back(cand->text());
+      translation->Next();
+      ++count;
+    }
+    return count;
+  }
+
+  the<Engine> engine_;
+  the<Filter> filter_;
+};
+
+TEST_F(RimeSimplifierTest, ConvertCandidates) {
+  vector<string> texts;
+  EXPECT_EQ(100, PageThrough(filter_->Apply(
+                                 fixtures::MakeTraditionalTranslation(),
+                                 nullptr),
+                             &texts));
+  string expected = kSimplified[0];
+  expected += kSimplified[0];
+  EXPECT_EQ(expected, texts[0]);
+  // the last character has no entry in the dictionary.
+  string partial = kTraditional[kNumChars - 1];
+  partial += kSimplified[0];
+  EXPECT_EQ(partial, texts[kNumChars - 1]);
+  string unconverted = kTraditional[kNumChars - 1];
+  unconverted += kTraditional[kNumChars - 1];
+  EXPECT_EQ(unconverted, texts[kNumChars * kNumChars - 1]);
+  // memoized results are identical to the first pass.
+  vector<string> texts_again;
+  PageThrough(
+      filter_->Apply(fixtures::MakeTraditionalTranslation(), nullptr),
+      &texts_again);
+  EXPECT_EQ(texts, texts_again);
+}
@@ -4,9 +4,21 @@
 //
 // 2011-07-03 GONG Chen <chen.sst@gmail.com>
 //
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <thread>
 #include <gtest/gtest.h>
 #include <rime/algo/syllabifier.h>
 #include <rime/dict/table.h>
+#include "fixtures.h"
+#ifdef __linux__
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 class RimeTableTest : public ::testing::Test {
  public:
@@ -203,3 +215,146 @@ TEST_F(RimeTableTest, QueryWithSyllableGraph) {
   EXPECT_STREQ("lia", Text(result[4].front()).c_str());
   EXPECT_FALSE(result[4].front().Next());
 }
+
+TEST(RimeTableLoadTest, LoadEmptyTable) {
+  const rime::path file_path("table_empty_test.bin");
+  {
+    rime::Table table(file_path);
+    table.Remove();
+    ASSERT_TRUE(table.Build(rime::Syllabary(), rime::Vocabulary(), 0));
+    ASSERT_TRUE(table.Save());
+  }
+  rime::Table table(file_path);
+  ASSERT_TRUE(table.Load());
+  EXPECT_TRUE(table.QueryWords(0).exhausted());
+  table.Remove();
+}
+
+#ifdef __linux__
+
+// which pages of the file are in the page cache.
+static rime::vector<bool> ResidentPages(const rime::path& file_path) {
+  rime::vector<bool> pages;
+  int fd = open(file_path.c_str(), O_RDONLY);
+  if (fd == -1)
+    return pages;
+  struct stat st;
+  fstat(fd, &st);
+  const size_t page_size = sysconf(_SC_PAGESIZE);
+  const size_t num_pages = (st.st_size + page_size - 1) / page_size;
+  void* address = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (address == MAP_FAILED)
+    return pages;
+  rime::vector<unsigned char> resident(num_pages);
+  if (mincore(address, st.st_size, resident.data()) == 0) {
+    for (unsigned char r : resident) {
+      pages.push_back(r & 1);
+    }
+  }
+  munmap(address, st.st_size);
+  return pages;
+}
+
+static size_t CountPages(const rime::vector<bool>& pages) {
+  return std::count(pages.begin(), pages.end(), true);
+}
+
+class RimeTableWarmupTest : public ::testing::Test {
+ protected:
+  static constexpr int kNumSyllables = 400;
+  static constexpr int kEntriesPerSyllable = 500;
+
+  void SetUp() override {
+    rime::Table table(file_path_);
+    table.set_hot_pages_file_path(hot_pages_path_);
+    table.Remove();
+    ASSERT_TRUE(rime::fixtures::BuildRandomTable(&table, kNumSyllables,
+                                                 kEntriesPerSyllable));
+  }
+
+  void TearDown() override {
+    rime::Table table(file_path_);
+    table.set_hot_pages_file_path(hot_pages_path_);
+    table.Remove();
+  }
+
+  // random access keeps read-ahead from bringing in pages not looked up.
+  static constexpr int kLoadPolicy =
+      rime::MappedFile::kAdviseAccess | rime::MappedFile::kReplayHotPages;
+
+  // loads the table and looks up a few words.
+  void LoadAndLookup() {
+    rime::Table table(file_path_);
+    table.set_load_policy(kLoadPolicy);
+    table.set_hot_pages_file_path(hot_pages_path_);
+    ASSERT_TRUE(table.Load());
+    for (int i = 0; i < kNumSyllables; i += 37) {
+      rime::TableAccessor a = table.QueryWords(i);
+      ASSERT_FALSE(a.exhausted());
+      EXPECT_FALSE(table.GetEntryText(*a.entry()).empty());
+    }
+  }
+
+  // drops pages of the file from the page cache, as after a reboot.
+  bool Evict() {
+    return rime::fixtures::EvictFromPageCache(file_path_) &&
+           CountPages(ResidentPages(file_path_)) == 0;
+  }
+
+  const rime::path file_path_{"table_warmup_test.bin"};
+  const rime::path hot_pages_path_{"table_warmup_test.hotpages"};
+};
+
+TEST_F(RimeTableWarmupTest, NoRecordOfFileAllResident) {
+  // the table just built is all in the page cache.
+  ASSERT_EQ(ResidentPages(file_path_).size(),
+            CountPages(ResidentPages(file_path_)));
+  LoadAndLookup();
+  EXPECT_FALSE(std::filesystem::exists(hot_pages_path_));
+}
+
+TEST_F(RimeTableWarmupTest, ReplayRecordedPages) {
+  if (!Evict())
+    GTEST_SKIP() << "pages cannot be evicted here.";
+  // a record of every other page.
+  const size_t num_pages = ResidentPages(file_path_).size();
+  rime::vector<bool> recorded(num_pages);
+  {
+    rime::vector<char> bitmap((num_pages + 7) / 8);
+    for (size_t i = 0; i < num_pages; i += 2) {
+      bitmap[i / 8] |= 1 << (i % 8);
+      recorded[i] = true;
+    }
+    uint64_t file_size = std::filesystem::file_size(file_path_);
+    std::ofstream out(hot_pages_path_.c_str(), std::ios::binary);
+    out.write(reinterpret_cast<const char*>(&file_size), sizeof(file_size));
+    out.write(bitmap.data(), bitmap.size());
+  }
+  {
+    rime::Table table(file_path_);
+    table.set_load_policy(kLoadPolicy);
+    table.set_hot_pages_file_path(hot_pages_path_);
+    ASSERT_TRUE(table.Load());
+    // pages are read in the background.
+    rime::vector<bool> replayed;
+    for (int i = 0; i < 100; ++i) {
+      replayed = ResidentPages(file_path_);
+      if (CountPages(replayed) >= CountPages(recorded))
+        break;
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    for (size_t i = 0; i < num_pages; ++i) {
+      EXPECT_TRUE(!recorded[i] || replayed[i]) << "page " << i;
+    }
+    // with a record, access is random: nothing is read ahead.
+    EXPECT_LT(CountPages(replayed), num_pages);
+  }
+  EXPECT_TRUE(std::filesystem::exists(hot_pages_path_));
+
+  // removed along with the table.
+  TearDown();
+  EXPECT_FALSE(std::filesystem::exists(hot_pages_path_));
+}
+
+#endif  // __linux__
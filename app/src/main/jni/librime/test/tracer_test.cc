@@ -0,0 +1,128 @@
+//
+// Copyright RIME Developers
+// Distributed under the BSD License
+//
+#include <chrono>
+#include <fstream>
+#include <iterator>
+#include <thread>
+#include <gtest/gtest.h>
+#include <rime_api.h>
+#include <rime/candidate.h>
+#include <rime/service.h>
+#include <rime/tracer.h>
+#include <rime/translation.h>
+
+using namespace rime;
+
+class RimeTracerTest : public ::testing::Test {
+ protected:
+  void SetUp() override { ASSERT_TRUE(Tracer::instance().Start()); }
+  void TearDown() override { Tracer::instance().Stop(); }
+};
+
+TEST_F(RimeTracerTest, SelfTimeExcludesNestedStages) {
+  const string outer("outer"), inner("inner");
+  {
+    TraceScope outer_scope("stage", &outer);
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    TraceScope inner_scope("stage", &inner);
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  }
+  auto counters = Tracer::instance().counters();
+  ASSERT_EQ(1, counters.count("stage/outer"));
+  ASSERT_EQ(1, counters.count("stage/inner"));
+  const auto& o = counters["stage/outer"];
+  const auto& i = counters["stage/inner"];
+  EXPECT_EQ(1, o.count);
+  EXPECT_LE(5000, i.self_us);
+  EXPECT_LE(i.total_us, o.total_us);
+  EXPECT_NEAR(o.total_us - i.total_us, o.self_us, 1.0);
+  EXPECT_EQ(o.total_us, o.max_us);
+}
+
+TEST_F(RimeTracerTest, NothingRecordedWithoutName) {
+  { TraceScope scope("stage", nullptr); }
+  Tracer::instance().Stop();
+  const string name("name");
+  { TraceScope scope("stage", &name); }
+  TraceCacheLookup("menu", true);
+  EXPECT_TRUE(Tracer::instance().counters().empty());
+}
+
+TEST_F(RimeTracerTest, CountCacheLookups) {
+  TraceCacheLookup("menu", true);
+  TraceCacheLookup("menu", false);
+  TraceCacheLookup("menu", true);
+  auto counters = Tracer::instance().counters(true);
+  EXPECT_EQ(3, counters["cache/menu"].count);
+  EXPECT_EQ(2, counters["cache/menu"].hits);
+  EXPECT_TRUE(Tracer::instance().counters().empty());
+}
+
+TEST_F(RimeTracerTest, TraceTranslation) {
+  auto fifo = New<FifoTranslation>();
+  for (int i = 0; i < 3; ++i) {
+    fifo->Append(New<SimpleCandidate>("test", 0, 1, std::to_string(i)));
+  }
+  auto translation = TraceTranslation(fifo, "translator", "fifo");
+  int num_candidates = 0;
+  for (; !translation->exhausted(); translation->Next()) {
+    EXPECT_TRUE(translation->Peek());
+    ++num_candidates;
+  }
+  EXPECT_EQ(3, num_candidates);
+  // a Peek and a Next for each candidate.
+  EXPECT_EQ(6, Tracer::instance().counters()["translator/fifo"].count);
+}
+
+TEST_F(RimeTracerTest, WriteTraceEvents) {
+  const path file_path("tracer_test.trace.json");
+  ASSERT_TRUE(Tracer::instance().Start(file_path));
+  const string name("a \"quoted\" name");
+  for (int i = 0; i < 2; ++i) {
+    TraceScope scope("stage", &name);
+  }
+  Tracer::instance().Stop();
+  std::ifstream fin(file_path.string());
+  string json((std::istreambuf_iterator<char>(fin)),
+              std::istreambuf_iterator<char>());
+  ASSERT_FALSE(json.empty());
+  EXPECT_EQ('[', json.front());
+  EXPECT_EQ("\n]\n", json.substr(json.length() - 3));
+  EXPECT_NE(string::npos, json.find("\"name\": \"a \\\"quoted\\\" name\""));
+  EXPECT_NE(string::npos, json.find("\"ph\": \"X\""));
+  EXPECT_NE(string::npos, json.find("},\n{"));
+}
+
+TEST(RimeTracerApiTest, CountersOfSession) {
+  RimeApi* rime = rime_get_api();
+  ASSERT_TRUE(RIME_API_AVAILABLE(rime, set_tracing));
+  Service::instance().StartService();
+  RimeSessionId session_id = rime->create_session();
+  ASSERT_NE(0, session_id);
+  ASSERT_TRUE(rime->set_tracing(True, nullptr));
+  rime->process_key(session_id, 'a', 0);
+  rime->process_key(session_id, 'b', 0);
+  RimeTraceCounters counters{};
+  ASSERT_TRUE(rime->get_trace_counters(&counters, True));
+  rime->set_tracing(False, nullptr);
+  rime->destroy_session(session_id);
+  bool found_key = false;
+  bool found_switcher = false;
+  for (size_t i = 0; i < counters.size; ++i) {
+    const auto& counter = counters.list[i];
+    if (string(counter.name) == "engine/key") {
+      found_key = true;
+      EXPECT_EQ(2, counter.count);
+      EXPECT_LE(counter.self_us, counter.total_us);
+    } else if (string(counter.name) == "processor/switcher") {
+      found_switcher = true;
+    }
+  }
+  EXPECT_TRUE(found_key);
+  EXPECT_TRUE(found_switcher);
+  rime->free_trace_counters(&counters);
+  EXPECT_EQ(0, counters.size);
+  EXPECT_FALSE(rime->get_trace_counters(&counters, False));
+}
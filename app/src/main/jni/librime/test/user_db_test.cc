@@ -6,12 +6,15 @@
 //
 #include <gtest/gtest.h>
 #include <rime/algo/syllabifier.h>
+#include <rime/dict/level_db.h>
 #include <rime/dict/text_db.h>
 #include <rime/dict/user_db.h>
+#include <rime/dict/user_dictionary.h>
 
 using namespace rime;
 
 using TestDb = UserDbWrapper<TextDb>;
+using TestLevelDb = UserDbWrapper<LevelDb>;
 
 TEST(RimeUserDbTest, AccessRecordByKey) {
   TestDb db(path{"user_db_test.txt"}, "user_db_test");
@@ -89,3 +92,150 @@ TEST(RimeUserDbTest, Query) {
   }
   db.Close();
 }
+
+TEST(RimeUserDbTest, WriteBehindReadsPendingWrites) {
+  TestLevelDb db(path{"user_db_test.userdb"}, "user_db_test");
+  if (db.Exists())
+    db.Remove();
+  // not flushed by the background thread during the test.
+  db.set_flush_interval(60000);
+  ASSERT_TRUE(db.Open());
+  EXPECT_TRUE(db.Update("abc", "stored"));
+  EXPECT_TRUE(db.Update("abd", "stored"));
+  EXPECT_TRUE(db.Update("abf", "stored"));
+  EXPECT_TRUE(db.Flush());
+  EXPECT_TRUE(db.Update("abc", "pending"));
+  EXPECT_TRUE(db.Update("abe", "pending"));
+  EXPECT_TRUE(db.Erase("abf"));
+  string value;
+  EXPECT_TRUE(db.Fetch("abc", &value));
+  EXPECT_EQ("pending", value);
+  EXPECT_TRUE(db.Fetch("abd", &value));
+  EXPECT_EQ("stored", value);
+  EXPECT_FALSE(db.Fetch("abf", &value));
+  {
+    an<DbAccessor> accessor = db.Query("ab");
+    ASSERT_TRUE(bool(accessor));
+    vector<string> records;
+    string key;
+    while (accessor->GetNextRecord(&key, &value)) {
+      records.push_back(key + "=" + value);
+    }
+    vector<string> expected{"abc=pending", "abd=stored", "abe=pending"};
+    EXPECT_EQ(expected, records);
+  }
+  // a committed transaction joins the journal.
+  EXPECT_TRUE(db.BeginTransaction());
+  EXPECT_TRUE(db.Update("abg", "pending"));
+  EXPECT_TRUE(db.CommitTransaction());
+  EXPECT_TRUE(db.Fetch("abg", &value));
+  // pending writes are stored on closing.
+  EXPECT_TRUE(db.Close());
+  db.set_flush_interval(0);
+  ASSERT_TRUE(db.Open());
+  EXPECT_TRUE(db.Fetch("abc", &value));
+  EXPECT_EQ("pending", value);
+  EXPECT_TRUE(db.Fetch("abe", &value));
+  EXPECT_TRUE(db.Fetch("abg", &value));
+  EXPECT_FALSE(db.Fetch("abf", &value));
+  db.Close();
+  db.Remove();
+}
+
+TEST(RimeUserDbTest, SharedDbKeepsTransactionsApart) {
+  auto db = New<TestLevelDb>(path{"user_db_test.userdb"}, "user_db_test");
+  if (db->Exists())
+    db->Remove();
+  ASSERT_TRUE(db->Open());
+  // user dictionaries of two sessions.
+  UserDictionary a("user_db_test", db);
+  UserDictionary b("user_db_test", db);
+  ASSERT_TRUE(a.Load());
+  ASSERT_TRUE(b.Load());
+  DictEntry entry;
+  entry.custom_code = "code ";
+  entry.text = "a";
+  ASSERT_TRUE(a.NewTransaction());
+  EXPECT_TRUE(a.UpdateEntry(entry, 1));
+  ASSERT_TRUE(b.NewTransaction());
+  // b's transaction is not for a to revert.
+  EXPECT_FALSE(a.RevertRecentTransaction());
+  entry.text = "b";
+  EXPECT_TRUE(b.UpdateEntry(entry, 1));
+  // writes of a stay out of b's transaction, which is committed first.
+  entry.text = "c";
+  EXPECT_TRUE(a.UpdateEntry(entry, 1));
+  EXPECT_FALSE(b.RevertRecentTransaction());
+  ASSERT_TRUE(b.NewTransaction());
+  entry.text = "d";
+  EXPECT_TRUE(b.UpdateEntry(entry, 1));
+  EXPECT_FALSE(a.CommitPendingTransaction());
+  EXPECT_TRUE(b.RevertRecentTransaction());
+  string value;
+  EXPECT_TRUE(db->Fetch("code \ta", &value));
+  EXPECT_TRUE(db->Fetch("code \tb", &value));
+  EXPECT_TRUE(db->Fetch("code \tc", &value));
+  EXPECT_FALSE(db->Fetch("code \td", &value));
+  db->Close();
+  db->Remove();
+}
+
+TEST(RimeUserDbTest, ChangeLogKeptUntilTrimmed) {
+  TestLevelDb db(path{"user_db_test.userdb"}, "user_db_test");
+  if (db.Exists())
+    db.Remove();
+  ASSERT_TRUE(db.Open());
+  // nothing is numbered before the log is started.
+  EXPECT_FALSE(db.LogChange("k \tW"));
+  EXPECT_EQ(0, db.last_change());
+  ASSERT_TRUE(db.StartLog());
+  const uint64_t kNumChanges = ChangeLog::kMaxLoggedChanges + 100;
+  for (uint64_t i = 0; i < kNumChanges; ++i) {
+    ASSERT_TRUE(db.LogChange("k" + std::to_string(i) + " \tW"));
+  }
+  EXPECT_EQ(kNumChanges, db.last_change());
+  // logging changes drops none of them.
+  EXPECT_EQ(0, db.log_start());
+  ASSERT_TRUE(db.TrimChanges(100));
+  EXPECT_EQ(100, db.log_start());
+  set<string> keys;
+  ASSERT_TRUE(db.GetChanges(0, &keys));
+  EXPECT_EQ(ChangeLog::kMaxLoggedChanges, keys.size());
+  db.Close();
+  db.Remove();
+}
+
+TEST(RimeUserDbTest, WriteBehindStoresAllLearning) {
+  const int kCommits = 500;
+  for (int write_behind = 0; write_behind < 2; ++write_behind) {
+    auto db = New<TestLevelDb>(path{"user_db_test.userdb"}, "user_db_test");
+    if (db->Exists())
+      db->Remove();
+    db->set_flush_interval(write_behind ? 1000 : 0);
+    UserDictionary dict("user_db_test", db);
+    ASSERT_TRUE(db->Open());
+    ASSERT_TRUE(dict.Load());
+    for (int i = 0; i < kCommits; ++i) {
+      // what Memory does on each commit.
+      dict.NewTransaction();
+      DictEntry entry;
+      entry.text = "text" + std::to_string(i % 50);
+      entry.custom_code = "code" + std::to_string(i % 50) + " ";
+      EXPECT_TRUE(dict.UpdateEntry(entry, 1));
+    }
+    dict.CommitPendingTransaction();
+    EXPECT_EQ(kCommits, dict.tick());
+    db->Close();
+    // all learning has been stored.
+    db->set_flush_interval(0);
+    ASSERT_TRUE(db->Open());
+    string value;
+    EXPECT_TRUE(db->MetaFetch("/tick", &value));
+    EXPECT_EQ(std::to_string(kCommits), value);
+    EXPECT_TRUE(db->Fetch("code7 \ttext7", &value));
+    UserDbValue v(value);
+    EXPECT_EQ(kCommits / 50, v.commits);
+    db->Close();
+    db->Remove();
+  }
+}
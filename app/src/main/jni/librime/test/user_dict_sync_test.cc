@@ -0,0 +1,112 @@
+//
+// Copyright RIME Developers
+// Distributed under the BSD License
+//
+#include <filesystem>
+#include <gtest/gtest.h>
+#include "fixtures.h"
+
+using namespace rime;
+
+namespace fs = std::filesystem;
+
+namespace {
+
+const path kTestDir("user_dict_sync_test");
+const string kDictName("sync_test");
+
+// a device that shares the sync directory with the others.
+class Device : public fixtures::Device {
+ public:
+  explicit Device(const string& user_id)
+      : fixtures::Device(kTestDir, kDictName, user_id) {}
+};
+
+class RimeUserDictSyncTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    std::error_code ec;
+    fs::remove_all(kTestDir, ec);
+  }
+};
+
+}  // namespace
+
+TEST_F(RimeUserDictSyncTest, ExchangeChanges) {
+  Device a("device_a"), b("device_b");
+  ASSERT_TRUE(a.Learn({"a \tA", "b \tB"}));
+  ASSERT_TRUE(b.Learn({"c \tC"}));
+  ASSERT_TRUE(a.Sync());
+  ASSERT_TRUE(b.Sync());
+  ASSERT_TRUE(a.Sync());
+  EXPECT_TRUE(a.Knows("c \tC"));
+  EXPECT_TRUE(b.Knows("a \tA"));
+  EXPECT_TRUE(b.Knows("b \tB"));
+
+  // both have merged everything of the other; only new words go out.
+  ASSERT_TRUE(a.Learn({"d \tD"}));
+  ASSERT_TRUE(a.Sync());
+  auto delta = a.Header(".userdb.delta.txt");
+  EXPECT_EQ("0", delta["/delta_from"]);
+  EXPECT_EQ("1", delta["/last_change"]);
+  // the snapshot is left as it was.
+  EXPECT_EQ("0", a.Header(".userdb.txt")["/last_change"]);
+  ASSERT_TRUE(b.Sync());
+  EXPECT_TRUE(b.Knows("d \tD"));
+  EXPECT_EQ(delta["/change_log_id"] + ":1",
+            b.Header(".userdb.delta.txt")["/synced/device_a"]);
+}
+
+TEST_F(RimeUserDictSyncTest, NoChangesLoggedBeforeFirstSync) {
+  Device a("device_a");
+  ASSERT_TRUE(a.Learn({"a \tA", "b \tB"}));
+  ASSERT_TRUE(a.Sync());
+  // the first snapshot holds them all.
+  EXPECT_EQ("0", a.Header(".userdb.txt")["/last_change"]);
+  EXPECT_EQ("0", a.Header(".userdb.delta.txt")["/last_change"]);
+  ASSERT_TRUE(a.Learn({"c \tC"}));
+  ASSERT_TRUE(a.Sync());
+  EXPECT_EQ("1", a.Header(".userdb.delta.txt")["/last_change"]);
+}
+
+TEST_F(RimeUserDictSyncTest, NewPeerStartsFromSnapshot) {
+  Device a("device_a"), b("device_b");
+  // learned before the first sync.
+  ASSERT_TRUE(a.Learn({"a \tA"}));
+  ASSERT_TRUE(a.Sync());
+  ASSERT_TRUE(a.Learn({"b \tB"}));
+  ASSERT_TRUE(b.Sync());
+  ASSERT_TRUE(a.Sync());
+  ASSERT_TRUE(a.Learn({"c \tC"}));
+  ASSERT_TRUE(a.Sync());
+
+  Device c("device_c");
+  ASSERT_TRUE(c.Sync());
+  EXPECT_TRUE(c.Knows("a \tA"));
+  EXPECT_TRUE(c.Knows("b \tB"));
+  EXPECT_TRUE(c.Knows("c \tC"));
+}
+
+TEST_F(RimeUserDictSyncTest, PeerBehindTrimmedLogTakesSnapshot) {
+  Device a("device_a"), b("device_b");
+  ASSERT_TRUE(a.Sync());
+  ASSERT_TRUE(b.Sync());
+  ASSERT_TRUE(a.Sync());
+  // more changes than the log keeps between two syncs.
+  const int kNumChanges = 12000;
+  vector<string> keys;
+  for (int i = 0; i < kNumChanges; ++i) {
+    keys.push_back("k" + std::to_string(i) + " \tW" + std::to_string(i));
+  }
+  ASSERT_TRUE(a.Learn(keys));
+  ASSERT_TRUE(a.Sync());
+  auto delta = a.Header(".userdb.delta.txt");
+  EXPECT_NE("0", delta["/delta_from"]);
+  EXPECT_EQ(std::to_string(kNumChanges),
+            a.Header(".userdb.txt")["/last_change"]);
+  ASSERT_TRUE(b.Sync());
+  EXPECT_TRUE(b.Knows(keys.front()));
+  EXPECT_TRUE(b.Knows(keys.back()));
+  EXPECT_EQ(delta["/change_log_id"] + ":" + std::to_string(kNumChanges),
+            b.Header(".userdb.delta.txt")["/synced/device_a"]);
+}
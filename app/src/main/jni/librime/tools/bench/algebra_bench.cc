@@ -0,0 +1,80 @@
+//
+// Copyright RIME Developers
+// Distributed under the BSD License
+//
+// prints the time spelling algebra takes to format syllables for display,
+// with and without the projection cache, and to derive the spellings of a
+// syllabary, serially and on several threads.
+//
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <rime/common.h>
+#include <rime/config.h>
+#include <rime/setup.h>
+#include <rime/algo/algebra.h>
+#include "bench.h"
+#include "fixtures.h"
+
+using std::chrono::duration;
+using std::chrono::steady_clock;
+using namespace rime;
+
+static void bench_formatting(int rounds) {
+  auto c = fixtures::MakeRules(fixtures::kToneMarks);
+  const char* syllables[] = {"zhong1", "guo2", "ren2", "min2", "lv4",
+                             "nve4",   "hao3", "xiang3", "shi4", "de5"};
+  for (size_t capacity : {size_t(0), Projection::kDefaultCacheCapacity}) {
+    Projection p;
+    if (!p.Load(c))
+      return;
+    p.set_cache_capacity(capacity);
+    string str;
+    auto start = steady_clock::now();
+    for (int i = 0; i < rounds; ++i) {
+      for (const char* syllable : syllables) {
+        str = syllable;
+        p.Apply(&str);
+      }
+    }
+    auto elapsed = duration<double, std::micro>(steady_clock::now() - start);
+    std::cout << "formatting a syllable with "
+              << (capacity ? "cache" : "no cache") << ": "
+              << elapsed.count() / (rounds * 10) << " us" << std::endl;
+  }
+}
+
+static void bench_script() {
+  const size_t num_rules = std::size(fixtures::kHeavyAlgebra);
+  {
+    Script script = fixtures::MakeSyllabary();
+    auto start = steady_clock::now();
+    fixtures::ApplySerially(&script);
+    auto elapsed = duration<double, std::milli>(steady_clock::now() - start);
+    std::cout << num_rules << "-rule algebra with Script::Merge(): "
+              << elapsed.count() << " ms" << std::endl;
+  }
+  auto c = fixtures::MakeRules(fixtures::kHeavyAlgebra);
+  Projection p;
+  if (!p.Load(c))
+    return;
+  for (int num_threads : {1, 4}) {
+    p.set_num_threads(num_threads);
+    Script script = fixtures::MakeSyllabary();
+    auto start = steady_clock::now();
+    p.Apply(&script);
+    auto elapsed = duration<double, std::milli>(steady_clock::now() - start);
+    std::cout << num_rules << "-rule algebra on " << num_threads
+              << " thread(s): " << elapsed.count() << " ms, " << script.size()
+              << " spellings" << std::endl;
+  }
+}
+
+int AlgebraBench(int argc, char* argv[]) {
+  const int rounds = argc > 1 ? std::stoi(argv[1]) : 2000;
+  // keeps the progress log of Projection::Apply(Script*) off the timings.
+  SetupLogging("rime.algebra_bench", 2, nullptr);
+  bench_formatting(rounds);
+  bench_script();
+  return 0;
+}
@@ -0,0 +1,62 @@
+//
+// Copyright RIME Developers
+// Distributed under the BSD License
+//
+// prints the time taken by the option and tag checks a keystroke makes, by
+// name in string maps and sets as before, and by atom.
+//
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <rime/atom.h>
+#include <rime/context.h>
+#include <rime/segmentation.h>
+#include "bench.h"
+
+using std::chrono::duration;
+using std::chrono::steady_clock;
+using namespace rime;
+
+int AtomBench(int argc, char* argv[]) {
+  const int rounds = argc > 1 ? std::stoi(argv[1]) : 100000;
+  map<string, bool> option_map{{"ascii_mode", false}, {"ascii_punct", false},
+                               {"extended_charset", false},
+                               {"full_shape", false}, {"simplification", true},
+                               {"_auto_commit", false}};
+  set<string> tag_set{"abc", "punct"};
+  const vector<string> translator_tags{"abc", "luna"};
+  Context context;
+  for (const auto& option : option_map) {
+    context.set_option(option.first, option.second);
+  }
+  Segment segment;
+  segment.tags = TagSet(tag_set.begin(), tag_set.end());
+  const TagSet translator_tag_set(translator_tags.begin(),
+                                  translator_tags.end());
+  const Atom ascii_mode = AtomTable::options().Intern("ascii_mode");
+  int hits = 0;
+  auto start = steady_clock::now();
+  for (int i = 0; i < rounds; ++i) {
+    hits += option_map.find("ascii_mode")->second;
+    hits += std::any_of(
+        translator_tags.begin(), translator_tags.end(),
+        [&](const string& tag) { return tag_set.count(tag) != 0; });
+  }
+  auto strings = steady_clock::now() - start;
+  start = steady_clock::now();
+  for (int i = 0; i < rounds; ++i) {
+    hits += context.get_option(ascii_mode);
+    hits += segment.HasAnyTagIn(translator_tag_set);
+  }
+  auto atoms = steady_clock::now() - start;
+  if (hits != 2 * rounds) {
+    std::cerr << "unexpected results of the checks." << std::endl;
+    return 1;
+  }
+  auto ns = [&](steady_clock::duration d) {
+    return duration<double, std::nano>(d).count() / rounds;
+  };
+  std::cout << "option and tag check: strings " << ns(strings)
+            << " ns, atoms " << ns(atoms) << " ns" << std::endl;
+  return 0;
+}
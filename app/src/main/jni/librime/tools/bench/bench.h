@@ -0,0 +1,23 @@
+//
+// Copyright RIME Developers
+// Distributed under the BSD License
+//
+// benches run by rime_bench. each takes the arguments that follow its name
+// on the command line, prints its timings and returns the exit status.
+//
+#ifndef RIME_BENCH_H_
+#define RIME_BENCH_H_
+
+int AlgebraBench(int argc, char* argv[]);
+int AtomBench(int argc, char* argv[]);
+int CorrectorBench(int argc, char* argv[]);
+int NotificationBench(int argc, char* argv[]);
+int PreloadBench(int argc, char* argv[]);
+int RecognizerBench(int argc, char* argv[]);
+int ReverseLookupBench(int argc, char* argv[]);
+int SimplifierBench(int argc, char* argv[]);
+int TableWarmupBench(int argc, char* argv[]);
+int TracerBench(int argc, char* argv[]);
+int UserDictSyncBench(int argc, char* argv[]);
+
+#endif  // RIME_BENCH_H_
@@ -0,0 +1,168 @@
+//
+// Copyright RIME Developers
+// Distributed under the BSD License
+//
+// builds the keyboard typo index for the derived prism of a schema, then
+// prints its size and build time, and the time to search for corrections at
+// each position of some input with the index and with a near search.
+//
+// the syllables are read from luna_pinyin.dict.yaml. without a schema file,
+// they are derived with the abbreviation, spelling and key correction rules
+// that luna_pinyin takes from pinyin.yaml.
+//
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <rime/config.h>
+#include <rime/algo/algebra.h>
+#include <rime/dict/corrector.h>
+#include <rime/dict/prism.h>
+#include "bench.h"
+
+using std::chrono::duration;
+using std::chrono::steady_clock;
+using namespace rime;
+
+static an<ConfigList> luna_pinyin_algebra() {
+  auto algebra = New<ConfigList>();
+  for (const char* rule : {
+           // pinyin:/abbreviation
+           "abbrev/^([a-z]).+$/$1/",
+           "abbrev/^([zcs]h).+$/$1/",
+           // pinyin:/spelling_correction
+           "derive/^([nl])ve$/$1ue/",
+           "derive/^([jqxy])u/$1v/",
+           "derive/un$/uen/",
+           "derive/ui$/uei/",
+           "derive/iu$/iou/",
+           // pinyin:/key_correction
+           "derive/([aeiou])ng$/$1gn/",
+           "derive/([dtngkhrzcs])o(u|ng)$/$1o/",
+           "derive/ong$/on/",
+           "derive/ao$/oa/",
+           "derive/([iu])a(o|ng?)$/a$1$2/",
+       }) {
+    algebra->Append(New<ConfigValue>(rule));
+  }
+  return algebra;
+}
+
+// the syllables in the codes of a dictionary source, which follow the
+// yaml header.
+static Syllabary read_syllabary(const char* dict_file) {
+  Syllabary syllabary;
+  std::ifstream fin(dict_file);
+  string line;
+  bool in_entries = false;
+  while (std::getline(fin, line)) {
+    if (!in_entries) {
+      in_entries = line == "...";
+      continue;
+    }
+    if (line.empty() || line[0] == '#')
+      continue;
+    std::istringstream entry(line);
+    string text, code, syllable;
+    if (!std::getline(entry, text, '\t') || !std::getline(entry, code, '\t'))
+      continue;
+    std::istringstream syllables(code);
+    while (syllables >> syllable) {
+      syllabary.insert(syllable);
+    }
+  }
+  return syllabary;
+}
+
+int CorrectorBench(int argc, char* argv[]) {
+  const string input =
+      argc > 1 ? argv[1] : "zhongxuangshiyanbangnitamanzhewohenxiangni";
+  const char* schema_file = argc > 2 ? argv[2] : nullptr;
+  const int kRounds = 20;
+
+  Syllabary syllabary = read_syllabary("luna_pinyin.dict.yaml");
+  if (syllabary.empty()) {
+    std::cerr << "failed to read luna_pinyin.dict.yaml" << std::endl;
+    return 1;
+  }
+  an<ConfigList> algebra;
+  Config config;
+  if (schema_file) {
+    if (!config.LoadFromFile(path(schema_file))) {
+      std::cerr << "failed to load " << schema_file << std::endl;
+      return 1;
+    }
+    algebra = config.GetList("speller/algebra");
+  } else {
+    algebra = luna_pinyin_algebra();
+  }
+  Script script;
+  for (const auto& x : syllabary) {
+    script.AddSyllable(x);
+  }
+  Projection p;
+  if (!algebra || !p.Load(algebra) || !p.Apply(&script)) {
+    std::cerr << "failed to apply the spelling algebra." << std::endl;
+    return 1;
+  }
+  Prism prism(path{"corrector_bench.prism.bin"});
+  prism.Remove();
+  if (!prism.Build(syllabary, &script) || !prism.Save() || !prism.Load()) {
+    std::cerr << "failed to build the prism." << std::endl;
+    return 1;
+  }
+  std::cout << syllabary.size() << " syllables, " << script.size()
+            << " spellings" << std::endl;
+
+  path index_path{"corrector_bench.correction.bin"};
+  TypoIndexCorrector typo_index(index_path);
+  typo_index.Remove();
+  auto start = steady_clock::now();
+  if (!typo_index.Build(syllabary, &script) || !typo_index.Save()) {
+    std::cerr << "failed to build the typo index." << std::endl;
+    return 1;
+  }
+  std::cout << "typo index: "
+            << duration<double, std::milli>(steady_clock::now() - start)
+                   .count()
+            << " ms to build, " << std::filesystem::file_size(index_path)
+            << " bytes" << std::endl;
+  TypoIndexCorrector loaded_index(index_path);
+  if (!loaded_index.Load()) {
+    std::cerr << "failed to load the typo index." << std::endl;
+    return 1;
+  }
+
+  auto search = [&](Corrector* corrector) {
+    size_t found = 0;
+    auto start = steady_clock::now();
+    for (int i = 0; i < kRounds; ++i) {
+      found = 0;
+      // as the syllabifier searches at each vertex.
+      for (size_t pos = 0; pos < input.length(); ++pos) {
+        corrector::Corrections results;
+        corrector->ToleranceSearch(prism, input.substr(pos), &results,
+                                   corrector::kDefaultTolerance);
+        found += results.size();
+      }
+    }
+    std::cout << duration<double, std::micro>(steady_clock::now() - start)
+                         .count() /
+                     kRounds
+              << " us, " << found << " corrections" << std::endl;
+  };
+  NearSearchCorrector near_search;
+  std::cout << "search over " << input.length() << " positions" << std::endl;
+  std::cout << "  near search: ";
+  search(&near_search);
+  std::cout << "  typo index: ";
+  search(&loaded_index);
+
+  loaded_index.Close();
+  prism.Close();
+  std::filesystem::remove(index_path);
+  std::filesystem::remove(prism.file_path());
+  return 0;
+}
@@ -0,0 +1,62 @@
+//
+// Copyright RIME Developers
+// Distributed under the BSD License
+//
+// toggles an option, which notifies a deliberately slow handler, and prints
+// the time the engine thread spends per toggle with notifications delivered
+// on the engine thread and on the dispatcher thread.
+//
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <rime_api.h>
+#include <rime/context.h>
+#include <rime/service.h>
+#include "bench.h"
+
+using std::chrono::duration;
+using std::chrono::steady_clock;
+
+int NotificationBench(int argc, char* argv[]) {
+  const int keystrokes = argc > 1 ? std::stoi(argv[1]) : 50;
+  const int handler_ms = argc > 2 ? std::stoi(argv[2]) : 2;
+
+  RimeApi* rime = rime_get_api();
+  RIME_STRUCT(RimeTraits, traits);
+  traits.app_name = "rime.notification_bench";
+  rime->setup(&traits);
+  rime->initialize(NULL);
+
+  rime::Service& service = rime::Service::instance();
+  std::atomic<int> delivered{0};
+  service.SetNotificationHandler([&](rime::SessionId, const char*,
+                                     const char*) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(handler_ms));
+    ++delivered;
+  });
+  for (int async = 0; async < 2; ++async) {
+    service.set_async_notifications(async);
+    delivered = 0;
+    rime::SessionId id = service.CreateSession();
+    rime::Context* context = service.GetSession(id)->context();
+    auto start = steady_clock::now();
+    for (int i = 0; i < keystrokes; ++i) {
+      context->set_option("ascii_mode", i % 2 == 0);
+    }
+    double micros =
+        duration<double, std::micro>(steady_clock::now() - start).count() /
+        keystrokes;
+    service.DestroySession(id);
+    // waits for the rest to be delivered.
+    service.set_async_notifications(false);
+    std::cout << (async ? "async" : "sync") << ": " << micros
+              << " us per toggle, " << delivered << " notifications delivered"
+              << std::endl;
+  }
+  service.ClearNotificationHandler();
+
+  rime->finalize();
+  return 0;
+}
@@ -0,0 +1,175 @@
+//
+// Copyright RIME Developers
+// Distributed under the BSD License
+//
+// builds two dictionaries of random entries, then prints the time the engine
+// thread spends on creating an engine with the first schema, switching to the
+// second, and on the first key after each, with the files evicted from the
+// page cache. compares a preloader that gets on with the dictionaries with
+// one kept busy, where the first key loads them itself.
+//
+#include <chrono>
+#include <future>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <rime_api.h>
+#include <rime/config.h>
+#include <rime/context.h>
+#include <rime/engine.h>
+#include <rime/preloader.h>
+#include <rime/schema.h>
+#include <rime/service.h>
+#include <rime/dict/prism.h>
+#include <rime/dict/table.h>
+#include "bench.h"
+#include "fixtures.h"
+
+using std::chrono::duration;
+using std::chrono::steady_clock;
+using namespace rime;
+
+#ifdef __linux__
+
+// two-letter syllables, as the abc segmentor takes letters only.
+static string syllable(int i) {
+  return string{char('a' + i / 26 % 26), char('a' + i % 26)};
+}
+
+static bool build_dictionary(const string& dict_name,
+                             int num_syllables,
+                             int entries_per_syllable) {
+  Syllabary syllabary;
+  Vocabulary vocabulary;
+  std::mt19937 random(42);
+  for (int i = 0; i < num_syllables; ++i) {
+    syllabary.insert(syllable(i));
+  }
+  int syllable_id = 0;
+  for (const auto& s : syllabary) {
+    for (int j = 0; j < entries_per_syllable; ++j) {
+      auto e = New<ShortDictEntry>();
+      e->code.push_back(syllable_id);
+      e->text = s + std::to_string(random());
+      e->weight = 1.0 / (j + 1);
+      vocabulary[syllable_id].entries.push_back(e);
+    }
+    ++syllable_id;
+  }
+  Table table(path(dict_name + ".table.bin"));
+  table.Remove();
+  Prism prism(path(dict_name + ".prism.bin"));
+  prism.Remove();
+  return table.Build(syllabary, vocabulary,
+                     num_syllables * entries_per_syllable) &&
+         table.Save() && prism.Build(syllabary) && prism.Save();
+}
+
+static Schema* make_schema(const string& dict_name) {
+  auto* schema = new Schema(dict_name);
+  Config* config = schema->config();
+  config->SetString("engine/segmentors/@next", "abc_segmentor");
+  config->SetString("engine/translators/@next", "table_translator");
+  config->SetString("translator/dictionary", dict_name);
+  config->SetBool("translator/enable_user_dict", false);
+  // replaying pages recorded by the previous round would skew the next.
+  config->SetString("translator/load_hints/@next", "advise_access");
+  config->SetString("translator/load_hints/@next", "prefault_index");
+  return schema;
+}
+
+struct Timings {
+  double create = 0;
+  double first_key = 0;
+  double switch_schema = 0;
+  double first_key_after_switch = 0;
+};
+
+static Timings run(const vector<string>& dict_names, bool preload) {
+  for (const auto& dict_name : dict_names) {
+    fixtures::EvictFromPageCache(path(dict_name + ".table.bin"));
+    fixtures::EvictFromPageCache(path(dict_name + ".prism.bin"));
+  }
+  Preloader& preloader(Service::instance().preloader());
+  std::promise<void> go;
+  if (!preload) {
+    preloader.Post([blocked = go.get_future().share()] { blocked.wait(); });
+  }
+  auto elapsed = [](steady_clock::time_point start) {
+    return duration<double, std::micro>(steady_clock::now() - start).count();
+  };
+  auto first_key = [&](Engine* engine) {
+    // the user has yet to type the first key.
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    auto start = steady_clock::now();
+    engine->context()->PushInput(syllable(7));
+    double result = elapsed(start);
+    engine->context()->Clear();
+    return result;
+  };
+  Timings timings;
+  auto start = steady_clock::now();
+  the<Engine> engine(Engine::Create());
+  engine->ApplySchema(make_schema(dict_names[0]));
+  timings.create = elapsed(start);
+  timings.first_key = first_key(engine.get());
+  start = steady_clock::now();
+  engine->ApplySchema(make_schema(dict_names[1]));
+  timings.switch_schema = elapsed(start);
+  timings.first_key_after_switch = first_key(engine.get());
+  if (!preload) {
+    go.set_value();
+  }
+  preloader.Flush();
+  return timings;
+}
+
+int PreloadBench(int argc, char* argv[]) {
+  const int num_syllables = argc > 1 ? std::stoi(argv[1]) : 400;
+  const int entries_per_syllable = argc > 2 ? std::stoi(argv[2]) : 500;
+  RIME_STRUCT(RimeTraits, traits);
+  traits.shared_data_dir = traits.user_data_dir = traits.prebuilt_data_dir =
+      traits.staging_dir = ".";
+  traits.app_name = "rime.preload_bench";
+  // keeps logging off the timed paths.
+  traits.min_log_level = 2;
+  RimeApi* rime = rime_get_api();
+  rime->setup(&traits);
+  rime->initialize(&traits);
+  const vector<string> dict_names{"preload_bench_a", "preload_bench_b"};
+  for (const auto& dict_name : dict_names) {
+    if (!build_dictionary(dict_name, num_syllables, entries_per_syllable)) {
+      std::cerr << "failed to build dictionary: " << dict_name << std::endl;
+      rime->finalize();
+      return 1;
+    }
+  }
+  auto print = [](const char* title, const Timings& t) {
+    std::cout << title << ":" << std::endl
+              << "  create engine: " << t.create << " us, first key: "
+              << t.first_key << " us" << std::endl
+              << "  switch schema: " << t.switch_schema
+              << " us, first key: " << t.first_key_after_switch << " us"
+              << std::endl;
+  };
+  // once for what the process sets up with the first engine.
+  run(dict_names, true);
+  print("loaded at the first key", run(dict_names, false));
+  print("preloaded", run(dict_names, true));
+  for (const auto& dict_name : dict_names) {
+    Table(path(dict_name + ".table.bin")).Remove();
+    Prism(path(dict_name + ".prism.bin")).Remove();
+  }
+  rime->finalize();
+  return 0;
+}
+
+#else
+
+int PreloadBench(int argc, char* argv[]) {
+  std::cerr << "page cache eviction is only supported on linux." << std::endl;
+  return 1;
+}
+
+#endif  // __linux__
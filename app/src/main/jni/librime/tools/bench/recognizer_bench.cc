@@ -0,0 +1,64 @@
+//
+// Copyright RIME Developers
+// Distributed under the BSD License
+//
+// prints the time the recognizer takes to match its patterns against the
+// input of a keystroke, searching pattern after pattern and with the combined
+// regex.
+//
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <rime/common.h>
+#include <rime/segmentation.h>
+#include <rime/setup.h>
+#include <rime/gear/recognizer.h>
+#include "bench.h"
+#include "fixtures.h"
+
+using std::chrono::duration;
+using std::chrono::steady_clock;
+using namespace rime;
+
+int RecognizerBench(int argc, char* argv[]) {
+  const int rounds = argc > 1 ? std::stoi(argv[1]) : 1000;
+  // keeps the log of each match off the timings.
+  SetupLogging("rime.recognizer_bench", 2, nullptr);
+  RecognizerPatterns patterns;
+  // a copy without the combined regex matches pattern after pattern.
+  RecognizerPatterns one_by_one;
+  fixtures::LoadRecognizerPatterns(&patterns);
+  fixtures::LoadRecognizerPatterns(&one_by_one);
+  patterns.Compile();
+  // the input as it grows, keystroke after keystroke.
+  const char* inputs[] = {"n",      "ni",      "nih",      "niha",
+                          "nihao",  "nihaoz",  "nihaozh",  "nihaozho",
+                          "nihaozhon", "nihaozhong"};
+  const int num_inputs = sizeof(inputs) / sizeof(inputs[0]);
+  vector<Segmentation> segmentations(num_inputs);
+  for (int i = 0; i < num_inputs; ++i) {
+    segmentations[i].Reset(inputs[i]);
+  }
+  size_t found[2] = {0, 0};
+  double micros[2] = {0, 0};
+  for (int pass = 0; pass < 2; ++pass) {
+    const auto& p = pass == 0 ? one_by_one : patterns;
+    auto start = steady_clock::now();
+    for (int i = 0; i < rounds; ++i) {
+      for (int j = 0; j < num_inputs; ++j) {
+        found[pass] += p.GetMatch(inputs[j], segmentations[j]).found();
+      }
+    }
+    micros[pass] = duration<double, std::micro>(steady_clock::now() - start)
+                       .count() /
+                   (rounds * num_inputs);
+  }
+  if (found[0] != found[1]) {
+    std::cerr << "unexpected results of the combined regex." << std::endl;
+    return 1;
+  }
+  std::cout << "matching " << patterns.size()
+            << " recognizer patterns: one by one " << micros[0]
+            << " us, combined " << micros[1] << " us" << std::endl;
+  return 0;
+}
@@ -0,0 +1,79 @@
+//
+// Copyright RIME Developers
+// Distributed under the BSD License
+//
+// prints the time taken to look up the codes of a page of candidates, as a
+// reverse lookup filter does on every keystroke: formatted one by one, from
+// the dictionary's cache of formatted results, and raw in a batch.
+//
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <rime/common.h>
+#include <rime/config.h>
+#include <rime/setup.h>
+#include <rime/algo/algebra.h>
+#include <rime/dict/reverse_lookup_dictionary.h>
+#include "bench.h"
+#include "fixtures.h"
+
+using std::chrono::duration;
+using std::chrono::steady_clock;
+using namespace rime;
+
+static const path kReverseDbFile("reverse_lookup_bench.reverse.bin");
+
+int ReverseLookupBench(int argc, char* argv[]) {
+  const int keystrokes = argc > 1 ? std::stoi(argv[1]) : 2000;
+  SetupLogging("rime.reverse_lookup_bench", 2, nullptr);
+  auto db = New<ReverseDb>(kReverseDbFile);
+  if (!fixtures::BuildReverseDb(db.get())) {
+    std::cerr << "failed to build the reverse db." << std::endl;
+    return 1;
+  }
+  an<ConfigList> rules = New<ConfigList>();
+  rules->Append(New<ConfigValue>("xform/^(.)/$1:/"));
+  rules->Append(New<ConfigValue>("xlit/abcdefghijklmnopqrstuvwxyz/"
+                                 "ABCDEFGHIJKLMNOPQRSTUVWXYZ/"));
+  Projection formatter;
+  ReverseLookupDictionary dict(db);
+  if (!formatter.Load(rules) || !dict.Load()) {
+    std::cerr << "failed to load the reverse lookup dictionary." << std::endl;
+    db->Remove();
+    return 1;
+  }
+  // a page of candidates, looked up again on every keystroke.
+  const vector<string> page{"中", "种", "你", "尼", "好"};
+  auto start = steady_clock::now();
+  for (int i = 0; i < keystrokes; ++i) {
+    for (const string& text : page) {
+      string codes;
+      if (db->Lookup(text, &codes))
+        formatter.Apply(&codes);
+    }
+  }
+  auto uncached = steady_clock::now() - start;
+  start = steady_clock::now();
+  for (int i = 0; i < keystrokes; ++i) {
+    for (const string& text : page) {
+      string codes;
+      dict.ReverseLookup(text, &formatter, &codes);
+    }
+  }
+  auto cached = steady_clock::now() - start;
+  start = steady_clock::now();
+  vector<string> results;
+  for (int i = 0; i < keystrokes; ++i) {
+    db->Lookup(page, &results);
+  }
+  auto batched = steady_clock::now() - start;
+  db->Close();
+  db->Remove();
+  auto us = [&](steady_clock::duration d) {
+    return duration<double, std::micro>(d).count() / (keystrokes * page.size());
+  };
+  std::cout << "reverse lookup per candidate: formatted " << us(uncached)
+            << " us, cached " << us(cached) << " us; raw batched "
+            << us(batched) << " us" << std::endl;
+  return 0;
+}
@@ -0,0 +1,74 @@
+//
+// Copyright RIME Developers
+// Distributed under the BSD License
+//
+// prints the time the simplifier takes to convert pages of 100 candidates,
+// as the menu would fetch them, with a small OpenCC dictionary.
+//
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <rime_api.h>
+#include <rime/candidate.h>
+#include <rime/config.h>
+#include <rime/context.h>
+#include <rime/engine.h>
+#include <rime/filter.h>
+#include <rime/schema.h>
+#include <rime/ticket.h>
+#include <rime/translation.h>
+#include "bench.h"
+#include "fixtures.h"
+
+using std::chrono::duration;
+using std::chrono::steady_clock;
+using namespace rime;
+
+static size_t page_through(const an<Translation>& translation) {
+  size_t count = 0;
+  while (translation->Peek()) {
+    translation->Next();
+    ++count;
+  }
+  return count;
+}
+
+int SimplifierBench(int argc, char* argv[]) {
+  const int rounds = argc > 1 ? std::stoi(argv[1]) : 200;
+  RIME_STRUCT(RimeTraits, traits);
+  traits.shared_data_dir = traits.user_data_dir = traits.prebuilt_data_dir =
+      traits.staging_dir = ".";
+  traits.app_name = "rime.simplifier_bench";
+  RimeApi* rime = rime_get_api();
+  rime->setup(&traits);
+  rime->initialize(&traits);
+  fixtures::WriteOpenccConfig("simplifier_bench");
+  int result = 1;
+  {
+    the<Engine> engine(Engine::Create());
+    engine->schema()->config()->SetString("simplifier/opencc_config",
+                                          "simplifier_bench.json");
+    engine->context()->set_option("simplification", true);
+    the<Filter> filter;
+    if (auto* component = Filter::Require("simplifier")) {
+      filter.reset(component->Create(Ticket(engine.get(), "simplifier")));
+    }
+    if (filter) {
+      auto start = steady_clock::now();
+      size_t count = 0;
+      for (int i = 0; i < rounds; ++i) {
+        count += page_through(
+            filter->Apply(fixtures::MakeTraditionalTranslation(), nullptr));
+      }
+      auto elapsed = steady_clock::now() - start;
+      std::cout << "paging through 100 candidates: "
+                << duration<double, std::micro>(elapsed).count() / rounds
+                << " us per round, " << count << " candidates" << std::endl;
+      result = 0;
+    } else {
+      std::cerr << "failed to create the simplifier." << std::endl;
+    }
+  }
+  rime->finalize();
+  return result;
+}
@@ -0,0 +1,88 @@
+//
+// Copyright RIME Developers
+// Distributed under the BSD License
+//
+// builds a table of random entries, then prints the time taken by the first
+// lookups after loading it, with the file in the page cache and evicted from
+// it, under each load policy.
+//
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <rime/dict/table.h>
+#include "bench.h"
+#include "fixtures.h"
+
+using std::chrono::duration;
+using std::chrono::steady_clock;
+using namespace rime;
+
+#ifdef __linux__
+
+int TableWarmupBench(int argc, char* argv[]) {
+  const int num_syllables = argc > 1 ? std::stoi(argv[1]) : 400;
+  const int entries_per_syllable = argc > 2 ? std::stoi(argv[2]) : 500;
+  const path file_path{"table_warmup_bench.bin"};
+  const path hot_pages_path{"table_warmup_bench.hotpages"};
+  {
+    Table table(file_path);
+    table.set_hot_pages_file_path(hot_pages_path);
+    table.Remove();
+    if (!fixtures::BuildRandomTable(&table, num_syllables,
+                                    entries_per_syllable)) {
+      std::cerr << "failed to build the table." << std::endl;
+      return 1;
+    }
+  }
+  // microseconds spent on the first lookups after loading the table.
+  auto first_lookups = [&](int policy, bool cold) {
+    if (cold)
+      fixtures::EvictFromPageCache(file_path);
+    Table table(file_path);
+    table.set_load_policy(policy);
+    table.set_hot_pages_file_path(hot_pages_path);
+    if (!table.Load())
+      return 0.0;
+    // the user has yet to type the first key.
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    auto start = steady_clock::now();
+    size_t total_length = 0;
+    for (int i = 0; i < num_syllables; i += 7) {
+      TableAccessor a = table.QueryWords(i);
+      for (int j = 0; j < 5 && !a.exhausted(); ++j, a.Next()) {
+        total_length += table.GetEntryText(*a.entry()).length();
+      }
+    }
+    return duration<double, std::micro>(steady_clock::now() - start).count();
+  };
+  std::cout << "warm: " << first_lookups(0, false) << " us" << std::endl;
+  std::cout << "cold: " << first_lookups(0, true) << " us" << std::endl;
+  std::cout << "cold, random access: "
+            << first_lookups(MappedFile::kAdviseAccess, true) << " us"
+            << std::endl;
+  std::cout << "cold, index prefaulted: "
+            << first_lookups(
+                   MappedFile::kAdviseAccess | MappedFile::kPrefaultIndex, true)
+            << " us" << std::endl;
+  // records the pages in use.
+  std::cout << "cold, default policy without a record: "
+            << first_lookups(MappedFile::kDefaultLoadPolicy, true) << " us"
+            << std::endl;
+  std::cout << "cold, hot pages replayed: "
+            << first_lookups(MappedFile::kDefaultLoadPolicy, true) << " us"
+            << std::endl;
+  Table table(file_path);
+  table.set_hot_pages_file_path(hot_pages_path);
+  table.Remove();
+  return 0;
+}
+
+#else
+
+int TableWarmupBench(int argc, char* argv[]) {
+  std::cerr << "page cache eviction is only supported on linux." << std::endl;
+  return 1;
+}
+
+#endif  // __linux__
@@ -0,0 +1,39 @@
+//
+// Copyright RIME Developers
+// Distributed under the BSD License
+//
+// prints the overhead of a trace scope around an engine stage, with the
+// tracer stopped and started.
+//
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <rime/tracer.h>
+#include "bench.h"
+
+using std::chrono::duration;
+using std::chrono::steady_clock;
+using namespace rime;
+
+int TracerBench(int argc, char* argv[]) {
+  const int iterations = argc > 1 ? std::stoi(argv[1]) : 1000000;
+  const string name("name");
+  auto time_scopes = [&] {
+    auto start = steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+      TraceScope scope("stage", Tracer::enabled() ? &name : nullptr);
+    }
+    return duration<double, std::nano>(steady_clock::now() - start).count() /
+           iterations;
+  };
+  double disabled = time_scopes();
+  if (!Tracer::instance().Start()) {
+    std::cerr << "failed to start the tracer." << std::endl;
+    return 1;
+  }
+  double enabled = time_scopes();
+  Tracer::instance().Stop();
+  std::cout << "trace scope: disabled " << disabled << " ns, enabled "
+            << enabled << " ns" << std::endl;
+  return 0;
+}
@@ -0,0 +1,59 @@
+//
+// Copyright RIME Developers
+// Distributed under the BSD License
+//
+// syncs a large user dictionary between two devices sharing a sync directory,
+// and prints the time taken by the first full sync and by a later sync of a
+// single change.
+//
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include "bench.h"
+#include "fixtures.h"
+
+using std::chrono::duration;
+using std::chrono::steady_clock;
+using namespace rime;
+
+namespace fs = std::filesystem;
+
+static const path kBenchDir("user_dict_sync_bench");
+static const string kDictName("sync_bench");
+
+int UserDictSyncBench(int argc, char* argv[]) {
+  const int num_entries = argc > 1 ? std::stoi(argv[1]) : 50000;
+  std::error_code ec;
+  fs::remove_all(kBenchDir, ec);
+  vector<string> keys;
+  for (int i = 0; i < num_entries; ++i) {
+    keys.push_back("k" + std::to_string(i) + " \tW" + std::to_string(i));
+  }
+  fixtures::Device a(kBenchDir, kDictName, "device_a");
+  fixtures::Device b(kBenchDir, kDictName, "device_b");
+  if (!a.Learn(keys)) {
+    std::cerr << "failed to create the user db." << std::endl;
+    return 1;
+  }
+  auto start = steady_clock::now();
+  bool success = a.Sync() && b.Sync();
+  auto full = steady_clock::now() - start;
+  success = success && a.Sync();
+
+  a.Learn({"new \tNEW"});
+  start = steady_clock::now();
+  success = success && a.Sync() && b.Sync();
+  auto routine = steady_clock::now() - start;
+  fs::remove_all(kBenchDir, ec);
+  if (!success) {
+    std::cerr << "failed to sync." << std::endl;
+    return 1;
+  }
+  std::cout << "syncing a user dict of " << num_entries
+            << " entries between 2 devices: full "
+            << duration<double, std::milli>(full).count() << " ms, 1 change "
+            << duration<double, std::milli>(routine).count() << " ms"
+            << std::endl;
+  return 0;
+}
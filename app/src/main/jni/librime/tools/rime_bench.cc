@@ -0,0 +1,48 @@
+//
+// Copyright RIME Developers
+// Distributed under the BSD License
+//
+// times code paths of librime, one bench at a time:
+//
+//   rime_bench <bench> [args...]
+//
+#include <cstring>
+#include <iostream>
+#include "bench/bench.h"
+
+struct Bench {
+  const char* name;
+  int (*run)(int argc, char* argv[]);
+  const char* args;
+};
+
+static const Bench kBenches[] = {
+    {"algebra", AlgebraBench, "[rounds]"},
+    {"atom", AtomBench, "[rounds]"},
+    {"corrector", CorrectorBench, "[input] [schema_file]"},
+    {"notification", NotificationBench, "[keystrokes] [handler_ms]"},
+    {"preload", PreloadBench, "[num_syllables] [entries_per_syllable]"},
+    {"recognizer", RecognizerBench, "[rounds]"},
+    {"reverse_lookup", ReverseLookupBench, "[keystrokes]"},
+    {"simplifier", SimplifierBench, "[rounds]"},
+    {"table_warmup", TableWarmupBench,
+     "[num_syllables] [entries_per_syllable]"},
+    {"tracer", TracerBench, "[iterations]"},
+    {"user_dict_sync", UserDictSyncBench, "[num_entries]"},
+};
+
+int main(int argc, char* argv[]) {
+  if (argc > 1) {
+    for (const Bench& bench : kBenches) {
+      if (!std::strcmp(argv[1], bench.name))
+        // the bench sees its own name as argv[0].
+        return bench.run(argc - 1, argv + 1);
+    }
+    std::cerr << "unknown bench: " << argv[1] << std::endl;
+  }
+  std::cerr << "usage: " << argv[0] << " <bench> [args...]" << std::endl;
+  for (const Bench& bench : kBenches) {
+    std::cerr << "  " << bench.name << " " << bench.args << std::endl;
+  }
+  return 1;
+}
@@ -4,6 +4,7 @@
 //
 // 2012-07-07 GONG Chen <chen.sst@gmail.com>
 //
+#include <cstdlib>
 #include <iostream>
 #include <rime/config.h>
 #include <rime/deployer.h>
@@ -106,12 +107,25 @@ int main(int argc, char* argv[]) {
         << "\t\tCompile a specific schema's dictionary files." << std::endl
         << std::endl
         << "\t--set-active-schema <schema_id>" << std::endl
-        << "\t\tSet the active schema in user.yaml" << std::endl;
+        << "\t\tSet the active schema in user.yaml" << std::endl
+        << std::endl
+        << "\t--jobs <n> --build|--compile ..." << std::endl
+        << "\t\tBuild at most n schemas at a time; defaults to the number "
+           "of hardware threads."
+        << std::endl;
 
     SetConsoleOutputCodePage(codepage);
     return 0;
   }
 
+  int max_workers = 0;
+  if (argc >= 3 && string(argv[1]) == "--jobs") {
+    max_workers = std::atoi(argv[2]);
+    // shift
+    argc -= 2, argv += 2;
+  }
+  Service::instance().deployer().set_max_workers(max_workers);
+
   string option;
   if (argc >= 2)
     option = argv[1];
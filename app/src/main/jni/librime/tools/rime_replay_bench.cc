@@ -0,0 +1,314 @@
+//
+// Copyright RIME Developers
+// Distributed under the BSD License
+//
+// replays recorded key traces through the api, the way a front end drives a
+// session, and reports the latency and allocations of each key and the
+// resident memory, one json object per trace per line.
+//
+// a trace is a text file with a key sequence per line, such as
+// "ni{space}hao{BackSpace}o1"; composition is cleared at the end of each line.
+// lines beginning with '#' are comments, and "@schema <schema_id>" selects
+// the schema for the lines that follow.
+//
+// with --baseline, it exits with status 1 if the p95 latency of any trace
+// exceeds that in the baseline output by more than the tolerance.
+//
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <new>
+#include <regex>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <rime_api.h>
+#include <rime/key_event.h>
+#ifdef __linux__
+#include <unistd.h>
+#endif
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+using std::chrono::duration;
+using std::chrono::steady_clock;
+
+// allocations made on the thread replaying the keys; background threads of
+// the engine are not counted.
+static thread_local size_t allocations = 0;
+
+void* operator new(size_t size) {
+  ++allocations;
+  if (void* p = std::malloc(size ? size : 1))
+    return p;
+  throw std::bad_alloc();
+}
+
+void* operator new[](size_t size) {
+  ++allocations;
+  if (void* p = std::malloc(size ? size : 1))
+    return p;
+  throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+  std::free(p);
+}
+
+void operator delete[](void* p) noexcept {
+  std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+  std::free(p);
+}
+
+void operator delete[](void* p, size_t) noexcept {
+  std::free(p);
+}
+
+// in kilobytes; 0 where not available.
+static long resident_set_size() {
+#ifdef __linux__
+  std::ifstream statm("/proc/self/statm");
+  long total = 0, resident = 0;
+  if (statm >> total >> resident)
+    return resident * (sysconf(_SC_PAGESIZE) / 1024);
+#endif
+  return 0;
+}
+
+static long peak_resident_set_size() {
+#ifndef _WIN32
+  rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) == 0) {
+#ifdef __APPLE__
+    return usage.ru_maxrss / 1024;
+#else
+    return usage.ru_maxrss;
+#endif
+  }
+#endif
+  return 0;
+}
+
+struct Trace {
+  std::string name;
+  // pairs of schema id, or empty for the default, and key sequence.
+  std::vector<std::pair<std::string, std::string>> lines;
+};
+
+static bool load_trace(const std::string& file_name, Trace* trace) {
+  std::ifstream fin(file_name);
+  if (!fin)
+    return false;
+  size_t slash = file_name.find_last_of("/\\");
+  trace->name = file_name.substr(slash == std::string::npos ? 0 : slash + 1);
+  trace->name = trace->name.substr(0, trace->name.find('.'));
+  std::string schema_id;
+  std::string line;
+  while (std::getline(fin, line)) {
+    if (!line.empty() && line.back() == '\r')
+      line.pop_back();
+    if (line.empty() || line[0] == '#')
+      continue;
+    if (line.compare(0, 8, "@schema ") == 0) {
+      schema_id = line.substr(8);
+      continue;
+    }
+    trace->lines.emplace_back(schema_id, line);
+  }
+  return true;
+}
+
+struct Samples {
+  std::vector<double> latencies;
+  std::vector<double> allocations;
+  size_t commits = 0;
+  size_t unparsed = 0;
+};
+
+static void replay(RimeApi* rime, const Trace& trace, Samples* samples) {
+  RimeSessionId session_id = rime->create_session();
+  if (!session_id)
+    return;
+  std::string current_schema;
+  RIME_STRUCT(RimeContext, context);
+  RIME_STRUCT(RimeCommit, commit);
+  for (const auto& line : trace.lines) {
+    if (!line.first.empty() && line.first != current_schema) {
+      rime->select_schema(session_id, line.first.c_str());
+      current_schema = line.first;
+    }
+    rime::KeySequence keys;
+    if (!keys.Parse(line.second)) {
+      ++samples->unparsed;
+      continue;
+    }
+    for (const auto& key : keys) {
+      size_t allocations_before = allocations;
+      auto start = steady_clock::now();
+      rime->process_key(session_id, key.keycode(), key.modifier());
+      if (rime->get_commit(session_id, &commit)) {
+        ++samples->commits;
+        rime->free_commit(&commit);
+      }
+      if (rime->get_context(session_id, &context))
+        rime->free_context(&context);
+      samples->latencies.push_back(
+          duration<double, std::micro>(steady_clock::now() - start).count());
+      samples->allocations.push_back(double(allocations - allocations_before));
+    }
+    rime->clear_composition(session_id);
+  }
+  rime->destroy_session(session_id);
+}
+
+static double percentile(const std::vector<double>& sorted, double p) {
+  return sorted.empty() ? 0 : sorted[size_t(p * (sorted.size() - 1))];
+}
+
+static double mean(const std::vector<double>& values) {
+  double sum = 0;
+  for (double value : values)
+    sum += value;
+  return values.empty() ? 0 : sum / values.size();
+}
+
+static std::string to_json(const Trace& trace,
+                           Samples samples,
+                           long rss_before,
+                           long rss_after) {
+  std::sort(samples.latencies.begin(), samples.latencies.end());
+  std::sort(samples.allocations.begin(), samples.allocations.end());
+  std::ostringstream out;
+  out << "{\"trace\": \"" << trace.name << "\""
+      << ", \"keys\": " << samples.latencies.size()
+      << ", \"commits\": " << samples.commits
+      << ", \"unparsed_lines\": " << samples.unparsed
+      << ", \"latency_us\": {\"p50\": " << percentile(samples.latencies, 0.5)
+      << ", \"p95\": " << percentile(samples.latencies, 0.95)
+      << ", \"p99\": " << percentile(samples.latencies, 0.99)
+      << ", \"max\": " << percentile(samples.latencies, 1)
+      << ", \"mean\": " << mean(samples.latencies) << "}"
+      << ", \"allocations_per_key\": {\"p50\": "
+      << percentile(samples.allocations, 0.5)
+      << ", \"p99\": " << percentile(samples.allocations, 0.99)
+      << ", \"mean\": " << mean(samples.allocations) << "}"
+      << ", \"rss_kb\": {\"before\": " << rss_before
+      << ", \"after\": " << rss_after
+      << ", \"peak\": " << peak_resident_set_size() << "}}";
+  return out.str();
+}
+
+// p95 latencies by trace name, from the output of an earlier run.
+static std::map<std::string, double> load_baseline(const std::string& file) {
+  std::map<std::string, double> p95_by_trace;
+  std::ifstream fin(file);
+  std::string line;
+  const std::regex pattern(
+      "\"trace\": \"([^\"]*)\".*\"latency_us\": \\{[^}]*\"p95\": ([0-9.e+-]+)");
+  std::smatch match;
+  while (std::getline(fin, line)) {
+    if (std::regex_search(line, match, pattern))
+      p95_by_trace[match[1]] = std::stod(match[2]);
+  }
+  return p95_by_trace;
+}
+
+static void usage(const char* program) {
+  std::cerr
+      << "usage: " << program
+      << " [--user-data-dir <dir>] [--shared-data-dir <dir>] [--rounds <n>]"
+         " [--baseline <file>] [--tolerance <ratio>] <trace_file>..."
+      << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+  std::string user_data_dir;
+  std::string shared_data_dir;
+  std::string baseline_file;
+  int rounds = 3;
+  double tolerance = 1.25;
+  std::vector<std::string> trace_files;
+  for (int i = 1; i < argc; ++i) {
+    std::string arg(argv[i]);
+    bool has_value = i + 1 < argc;
+    if (arg == "--user-data-dir" && has_value) {
+      user_data_dir = argv[++i];
+    } else if (arg == "--shared-data-dir" && has_value) {
+      shared_data_dir = argv[++i];
+    } else if (arg == "--rounds" && has_value) {
+      rounds = std::max(1, std::atoi(argv[++i]));
+    } else if (arg == "--baseline" && has_value) {
+      baseline_file = argv[++i];
+    } else if (arg == "--tolerance" && has_value) {
+      tolerance = std::atof(argv[++i]);
+    } else if (arg.compare(0, 2, "--") == 0) {
+      usage(argv[0]);
+      return 1;
+    } else {
+      trace_files.push_back(arg);
+    }
+  }
+  if (trace_files.empty()) {
+    usage(argv[0]);
+    return 1;
+  }
+  std::vector<Trace> traces(trace_files.size());
+  for (size_t i = 0; i < trace_files.size(); ++i) {
+    if (!load_trace(trace_files[i], &traces[i])) {
+      std::cerr << "error loading trace: " << trace_files[i] << std::endl;
+      return 1;
+    }
+  }
+
+  RimeApi* rime = rime_get_api();
+  RIME_STRUCT(RimeTraits, traits);
+  traits.app_name = "rime.replay_bench";
+  if (!user_data_dir.empty())
+    traits.user_data_dir = user_data_dir.c_str();
+  if (!shared_data_dir.empty())
+    traits.shared_data_dir = shared_data_dir.c_str();
+  rime->setup(&traits);
+  rime->initialize(NULL);
+  if (rime->start_maintenance(False))
+    rime->join_maintenance_thread();
+
+  std::map<std::string, double> baseline;
+  if (!baseline_file.empty())
+    baseline = load_baseline(baseline_file);
+  bool regressed = false;
+  for (const auto& trace : traces) {
+    long rss_before = resident_set_size();
+    // the first round loads the schema and is left out.
+    Samples warmup;
+    replay(rime, trace, &warmup);
+    Samples samples;
+    for (int i = 0; i < rounds; ++i) {
+      replay(rime, trace, &samples);
+    }
+    samples.commits /= rounds;
+    samples.unparsed /= rounds;
+    std::string json = to_json(trace, samples, rss_before,
+                               resident_set_size());
+    std::cout << json << std::endl;
+    auto found = baseline.find(trace.name);
+    if (found != baseline.end()) {
+      std::sort(samples.latencies.begin(), samples.latencies.end());
+      double p95 = percentile(samples.latencies, 0.95);
+      if (p95 > found->second * tolerance) {
+        std::cerr << "regression in " << trace.name << ": p95 " << p95
+                  << " us against " << found->second << " us" << std::endl;
+        regressed = true;
+      }
+    }
+  }
+
+  rime->finalize();
+  return regressed ? 1 : 0;
+}
@@ -0,0 +1,113 @@
+//
+// Copyright RIME Developers
+// Distributed under the BSD License
+//
+// drives independent sessions from as many threads, each replaying recorded
+// key sequences, and prints the throughput for each number of threads.
+//
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <rime_api.h>
+
+using std::chrono::duration;
+using std::chrono::steady_clock;
+
+struct Result {
+  size_t keys = 0;
+  size_t commits = 0;
+  size_t failures = 0;
+};
+
+static void drive_session(RimeApi* rime,
+                          const char* schema_id,
+                          const std::vector<std::string>& sequences,
+                          int rounds,
+                          Result* result) {
+  RimeSessionId session_id = rime->create_session();
+  if (!session_id) {
+    ++result->failures;
+    return;
+  }
+  rime->select_schema(session_id, schema_id);
+  RIME_STRUCT(RimeCommit, commit);
+  for (int i = 0; i < rounds; ++i) {
+    for (const auto& sequence : sequences) {
+      if (!rime->simulate_key_sequence(session_id, sequence.c_str()))
+        ++result->failures;
+      result->keys += sequence.length();
+      if (rime->get_commit(session_id, &commit)) {
+        ++result->commits;
+        rime->free_commit(&commit);
+      }
+      rime->clear_composition(session_id);
+    }
+  }
+  rime->destroy_session(session_id);
+}
+
+static void run(RimeApi* rime,
+                const char* schema_id,
+                const std::vector<std::string>& sequences,
+                int num_threads,
+                int rounds) {
+  std::vector<Result> results(num_threads);
+  std::vector<std::thread> threads;
+  auto start = steady_clock::now();
+  for (int i = 0; i < num_threads; ++i) {
+    threads.emplace_back(drive_session, rime, schema_id, std::cref(sequences),
+                         rounds, &results[i]);
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  double seconds = duration<double>(steady_clock::now() - start).count();
+  Result total;
+  for (const auto& result : results) {
+    total.keys += result.keys;
+    total.commits += result.commits;
+    total.failures += result.failures;
+  }
+  std::cout << num_threads << " sessions: " << total.keys << " keys, "
+            << total.commits << " commits, " << total.failures
+            << " failures in " << seconds << " s; " << total.keys / seconds
+            << " keys/s" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+  if (argc < 3) {
+    std::cerr << "usage: " << argv[0]
+              << " <schema_id> <key_sequences_file> [max_threads] [rounds]"
+              << std::endl;
+    return 1;
+  }
+  const char* schema_id = argv[1];
+  std::vector<std::string> sequences;
+  std::ifstream fin(argv[2]);
+  std::string line;
+  while (std::getline(fin, line)) {
+    if (!line.empty() && line[0] != '#')
+      sequences.push_back(line);
+  }
+  const int max_threads = argc > 3 ? std::stoi(argv[3]) : 8;
+  const int rounds = argc > 4 ? std::stoi(argv[4]) : 10;
+
+  RimeApi* rime = rime_get_api();
+  RIME_STRUCT(RimeTraits, traits);
+  traits.app_name = "rime.session_stress";
+  rime->setup(&traits);
+  rime->initialize(NULL);
+  if (rime->start_maintenance(True))
+    rime->join_maintenance_thread();
+
+  for (int num_threads = 1; num_threads <= max_threads; num_threads *= 2) {
+    run(rime, schema_id, sequences, num_threads, rounds);
+  }
+
+  rime->finalize();
+  return 0;
+}
@@ -8,6 +8,11 @@ extern "C" {
 
 size_t rime_get_highlighted_candidate_index(RimeSessionId session_id);
 
+// delivers notifications on a dispatcher thread, off the keystroke path.
+// off by default: the handler must then be safe to call from another thread,
+// and messages are dropped if it falls a whole queue behind.
+void rime_set_async_notifications(Bool async);
+
 #ifdef __cplusplus
 }
 #endif
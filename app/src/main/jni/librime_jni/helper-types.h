@@ -28,6 +28,33 @@ class SchemaItem {
   }
 };
 
+class TraceCounter {
+ public:
+  std::string name;
+  uint64_t count;
+  uint64_t hits;
+  double totalMicros;
+  double selfMicros;
+  double maxMicros;
+
+  explicit TraceCounter(const RimeTraceCounter& counter)
+      : name(counter.name),
+        count(counter.count),
+        hits(counter.hits),
+        totalMicros(counter.total_us),
+        selfMicros(counter.self_us),
+        maxMicros(counter.max_us) {}
+
+  static std::vector<TraceCounter> fromCList(const RimeTraceCounters& list) {
+    std::vector<TraceCounter> result;
+    result.reserve(list.size);
+    for (size_t i = 0; i < list.size; ++i) {
+      result.emplace_back(list.list[i]);
+    }
+    return result;
+  }
+};
+
 class CandidateItem {
  public:
   std::string text;
@@ -78,6 +78,15 @@ class JEnv {
     if (jvm->GetEnv(reinterpret_cast<void **>(&env), JNI_VERSION_1_6) ==
         JNI_EDETACHED) {
       jvm->AttachCurrentThread(&env, nullptr);
+      // native threads, e.g. the notification dispatcher, must detach
+      // before they exit.
+      static thread_local struct Detacher {
+        JavaVM *jvm = nullptr;
+        ~Detacher() {
+          if (jvm) jvm->DetachCurrentThread();
+        }
+      } detacher;
+      detacher.jvm = jvm;
     }
   }
 
@@ -130,6 +139,9 @@ class GlobalRefSingleton {
   jclass KeyEvent;
   jmethodID KeyEventInit;
 
+  jclass TraceCounter;
+  jmethodID TraceCounterInit;
+
   explicit GlobalRefSingleton(JavaVM *jvm_) : jvm(jvm_) {
     JNIEnv *env;
     jvm->AttachCurrentThread(&env, nullptr);
@@ -205,6 +217,11 @@ class GlobalRefSingleton {
         env->FindClass("com/osfans/trime/core/RimeKeyEvent")));
     KeyEventInit =
         env->GetMethodID(KeyEvent, "<init>", "(IILjava/lang/String;)V");
+
+    TraceCounter = reinterpret_cast<jclass>(env->NewGlobalRef(
+        env->FindClass("com/osfans/trime/core/TraceCounter")));
+    TraceCounterInit = env->GetMethodID(TraceCounter, "<init>",
+                                        "(Ljava/lang/String;JJDDD)V");
   }
 
   [[nodiscard]] JEnv AttachEnv() const { return JEnv(jvm); }
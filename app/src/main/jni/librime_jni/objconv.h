@@ -28,6 +28,23 @@ inline jobjectArray rimeSchemaListToJObjectArray(
   return array;
 }
 
+inline jobjectArray rimeTraceCountersToJObjectArray(
+    JNIEnv* env, const std::vector<TraceCounter>& list) {
+  jobjectArray array = env->NewObjectArray(static_cast<int>(list.size()),
+                                           GlobalRef->TraceCounter, nullptr);
+  int i = 0;
+  for (const auto& item : list) {
+    auto jItem = JRef(
+        env, env->NewObject(
+                 GlobalRef->TraceCounter, GlobalRef->TraceCounterInit,
+                 *JString(env, item.name), static_cast<jlong>(item.count),
+                 static_cast<jlong>(item.hits), item.totalMicros,
+                 item.selfMicros, item.maxMicros));
+    env->SetObjectArrayElement(array, i++, jItem);
+  }
+  return array;
+}
+
 inline std::vector<std::string> stringArrayToStringVector(JNIEnv* env,
                                                           jobjectArray array) {
   auto length = env->GetArrayLength(array);
@@ -5,7 +5,9 @@
 #include <rime_api.h>
 
 #include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "frontend.h"
@@ -89,15 +91,24 @@ class Rime {
     return std::make_unique<CommitProto>();
   }
 
-  std::unique_ptr<ContextProto> context() {
+  std::unique_ptr<ContextProto> context() { return context(session()); }
+
+  std::unique_ptr<ContextProto> context(RimeSessionId s) {
     RIME_STRUCT(RimeContext, data)
-    auto s = session();
-    if (rime->get_context(s, &data)) {
+    // reused for every key, grown to fit the largest context so far
+    thread_local std::vector<char> buffer(MAX_BUFFER_LENGTH);
+    size_t size = buffer.size();
+    bool found;
+    while (!(found = rime->get_context_in_buffer(s, &data, buffer.data(),
+                                                 &size)) &&
+           size > buffer.size()) {
+      buffer.resize(size);
+      size = buffer.size();
+    }
+    if (found) {
       auto input = rime->get_input(s);
       auto caretPos = rime->get_caret_pos(s);
-      auto p = std::make_unique<ContextProto>(&data, input, caretPos);
-      rime->free_context(&data);
-      return p;
+      return std::make_unique<ContextProto>(&data, input, caretPos);
     }
     return std::make_unique<ContextProto>();
   }
@@ -137,6 +148,20 @@ class Rime {
     return std::move(result);
   }
 
+  bool setTracing(bool enabled, const char *traceEventFile) {
+    return rime->set_tracing(enabled, traceEventFile);
+  }
+
+  std::vector<TraceCounter> traceCounters(bool reset) {
+    std::vector<TraceCounter> result;
+    RimeTraceCounters counters{};
+    if (rime->get_trace_counters(&counters, reset)) {
+      result = TraceCounter::fromCList(counters);
+      rime->free_trace_counters(&counters);
+    }
+    return result;
+  }
+
   bool selectSchema(std::string_view schemaId) {
     return rime->select_schema(session(), schemaId.data());
   }
@@ -198,8 +223,39 @@ class Rime {
     return std::make_tuple(size, highlighted, std::move(list));
   }
 
+  // sessions independent of the main one, e.g. for a floating preview or a
+  // background predictor; they may be driven from threads of their own.
+  RimeSessionId createSession() {
+    std::shared_ptr<SessionHolder> holder;
+    try {
+      holder = std::make_shared<SessionHolder>();
+    } catch (...) {
+      return 0;
+    }
+    std::lock_guard<std::mutex> lock(sessionsMutex_);
+    sessions_[holder->id()] = holder;
+    return holder->id();
+  }
+
+  bool destroySession(RimeSessionId id) {
+    std::lock_guard<std::mutex> lock(sessionsMutex_);
+    return sessions_.erase(id) > 0;
+  }
+
+  bool simulateKeySequence(RimeSessionId id, const std::string &sequence) {
+    return rime->simulate_key_sequence(id, sequence.data());
+  }
+
+  bool selectSchema(RimeSessionId id, std::string_view schemaId) {
+    return rime->select_schema(id, schemaId.data());
+  }
+
   void exit() {
     session_.reset();
+    {
+      std::lock_guard<std::mutex> lock(sessionsMutex_);
+      sessions_.clear();
+    }
     rime->finalize();
   }
 
@@ -211,6 +267,8 @@ class Rime {
  private:
   RimeApi *rime;
   std::shared_ptr<SessionHolder> session_;
+  std::unordered_map<RimeSessionId, std::shared_ptr<SessionHolder>> sessions_;
+  std::mutex sessionsMutex_;
 
   RimeSessionId session(bool requestNewSession = true) {
     if (!session_ && requestNewSession) {
@@ -363,6 +421,26 @@ Java_com_osfans_trime_core_Rime_selectRimeSchema(JNIEnv *env, jclass /* thiz */,
   return Rime::Instance().selectSchema(*CString(env, schema_id));
 }
 
+// profiling
+extern "C" JNIEXPORT jboolean JNICALL
+Java_com_osfans_trime_core_Rime_setRimeTracing(JNIEnv *env, jclass /* thiz */,
+                                               jboolean enabled,
+                                               jstring trace_event_file) {
+  if (!trace_event_file) {
+    return Rime::Instance().setTracing(enabled, nullptr);
+  }
+  return Rime::Instance().setTracing(enabled,
+                                     *CString(env, trace_event_file));
+}
+
+extern "C" JNIEXPORT jobjectArray JNICALL
+Java_com_osfans_trime_core_Rime_getRimeTraceCounters(JNIEnv *env,
+                                                     jclass /* thiz */,
+                                                     jboolean reset) {
+  return rimeTraceCountersToJObjectArray(
+      env, Rime::Instance().traceCounters(reset));
+}
+
 // testing
 extern "C" JNIEXPORT jboolean JNICALL
 Java_com_osfans_trime_core_Rime_simulateRimeKeySequence(JNIEnv *env,
@@ -371,6 +449,43 @@ Java_com_osfans_trime_core_Rime_simulateRimeKeySequence(JNIEnv *env,
   return Rime::Instance().simulateKeySequence(CString(env, key_sequence));
 }
 
+// independent sessions
+extern "C" JNIEXPORT jlong JNICALL
+Java_com_osfans_trime_core_Rime_createRimeSession(JNIEnv *env,
+                                                  jclass /* thiz */) {
+  return static_cast<jlong>(Rime::Instance().createSession());
+}
+
+extern "C" JNIEXPORT jboolean JNICALL
+Java_com_osfans_trime_core_Rime_destroyRimeSession(JNIEnv *env,
+                                                   jclass /* thiz */,
+                                                   jlong session_id) {
+  return Rime::Instance().destroySession(session_id);
+}
+
+extern "C" JNIEXPORT jboolean JNICALL
+Java_com_osfans_trime_core_Rime_selectRimeSessionSchema(JNIEnv *env,
+                                                        jclass /* thiz */,
+                                                        jlong session_id,
+                                                        jstring schema_id) {
+  return Rime::Instance().selectSchema(session_id, *CString(env, schema_id));
+}
+
+extern "C" JNIEXPORT jboolean JNICALL
+Java_com_osfans_trime_core_Rime_simulateRimeSessionKeySequence(
+    JNIEnv *env, jclass /* thiz */, jlong session_id, jstring key_sequence) {
+  return Rime::Instance().simulateKeySequence(session_id,
+                                              CString(env, key_sequence));
+}
+
+extern "C" JNIEXPORT jobject JNICALL
+Java_com_osfans_trime_core_Rime_getRimeSessionContext(JNIEnv *env,
+                                                      jclass /* thiz */,
+                                                      jlong session_id) {
+  auto context = Rime::Instance().context(session_id);
+  return rimeContextToJObject(env, *context);
+}
+
 extern "C" JNIEXPORT jstring JNICALL
 Java_com_osfans_trime_core_Rime_getRimeRawInput(JNIEnv *env,
                                                 jclass /* thiz */) {